@@ -12,9 +12,19 @@ enum hikari_light_mode {
 	HIKARI_LIGHT_MODE_WAVE,
 };
 
+/* Mode operations
+ *
+ * pause and resume are optional. A mode that implements them is kept in the
+ * mode cache when switched away from: pause stops its animation and returns
+ * its light resources but keeps its graph, resume claims the resources again
+ * and restarts the animation from its initial state. The destructor must
+ * also tear down a paused mode.
+ */
 struct hikari_light_mode_api {
 	void (*constructor)(void);
 	void (*destructor)(void);
+	void (*pause)(void);
+	void (*resume)(void);
 	void (*tweak_color)(float hue);
 	void (*tweak_intensity)(float saturation);
 	void (*tweak_gain)(float value);
@@ -31,8 +41,15 @@ struct hikari_light_mode_entry {
 		.mode = _mode, .api = &_api \
 	}
 
+struct hikari_light_mode_cache_stats {
+	uint32_t hits;      /* Mode switches that resumed a cached mode */
+	uint32_t misses;    /* Mode switches that constructed a mode */
+	uint32_t evictions; /* Cached modes destructed to make room */
+};
+
 void hikari_light_mode_set(enum hikari_light_mode mode);
 enum hikari_light_mode hikari_light_mode_get(void);
+void hikari_light_mode_cache_stats_get(struct hikari_light_mode_cache_stats *stats);
 
 void hikari_light_tweak_color(float hue);
 void hikari_light_tweak_intensity(float saturation);
@@ -6,6 +6,8 @@
 
 #include <zephyr/kernel.h>
 
+#include "gamma_lut.h"
+
 typedef enum {
 	LIGHT_RESOURCE_SUCCESS = 0,
 	LIGHT_RESOURCE_NOT_FOUND = 1,
@@ -14,18 +16,66 @@ typedef enum {
 	LIGHT_RESOURCE_NOT_INITIALIZED = 4,
 } light_res_err_t;
 
+/* A resource of a LED holds one struct rgb16_value with 8 fractional bits
+ * per channel, as written by LED slabs of type LED_TYPE_RGB16.
+ */
 struct light_resource {
 	sys_dnode_t root;
 	char *id;
 	uint8_t *data;
 	size_t data_size;
+	uint8_t layer;
 	bool used;
 };
 
 void light_resource_init(void);
 
+/* Use the resource with the given id.
+ *
+ * Every resource exists once per layer. The resource of the shown front
+ * layer is handed out first, the resource of the hidden back layer when
+ * the front one is already used. This lets a new user draw off screen
+ * while the current user keeps running.
+ */
 light_res_err_t light_resource_use(char *id, struct light_resource **res);
 
 light_res_err_t light_resource_return(struct light_resource *res);
 
+/* Crossfade the LEDs from the front layer to the back layer.
+ *
+ * The layers are swapped between two LED updates once duration_ms has
+ * passed, so the back layer becomes the front layer. Blocks until then.
+ */
+void light_resource_crossfade(uint32_t duration_ms);
+
+/* Set gamma, brightness and white balance of all LEDs.
+ *
+ * Applied to every frame written to the LEDs, through a lookup table
+ * rebuilt at the next frame. Modes keep drawing linear values.
+ */
+void light_resource_correction_set(const struct gamma_config *config);
+
+/* Set only the brightness of all LEDs, see light_resource_correction_set(). */
+void light_resource_brightness_set(uint8_t brightness);
+
+/* Limit the estimated LED current to budget_ma.
+ *
+ * The current of each frame is estimated from the sum of all channel
+ * values. Frames above the budget are dimmed uniformly before they are
+ * written to the LEDs.
+ */
+void light_resource_power_budget_set(uint32_t budget_ma);
+
+/* Estimated LED current of the last frame in mA, before limiting. */
+uint32_t light_resource_power_estimate_get(void);
+
+/* Tell that light resource data changed.
+ *
+ * The LEDs are only updated while their values change, and only chains
+ * with changed values are composed again. Writes of LED slabs are tracked
+ * per chain, other code writing resource data must call this, which
+ * composes all chains again.
+ */
+void light_resource_changed(void);
+
 #endif /* LIGHT_RESOURCE_H__ */
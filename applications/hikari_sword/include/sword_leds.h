@@ -0,0 +1,84 @@
+#ifndef SWORD_LEDS_H__
+#define SWORD_LEDS_H__
+
+/* LEDs of the sword, in LED chain order
+ *
+ * Expands _X(id, chain, idx) for every LED, with the light resource id of
+ * the LED, the chain it is on and its index in the chain. Shared by the
+ * light resources of the sword and of the slab_sim application, so both
+ * have the same resources.
+ */
+#define SWORD_LEDS(_X)                                                         \
+	_X("pommel_f", chain_P, 0)                                             \
+	_X("pommel_b", chain_P, 1)                                             \
+                                                                               \
+	_X("core_f1", chain_C, 0)                                              \
+	_X("core_f2", chain_C, 1)                                              \
+	_X("core_f3", chain_C, 2)                                              \
+	_X("core_b1", chain_C, 3)                                              \
+	_X("core_b2", chain_C, 4)                                              \
+	_X("core_b3", chain_C, 5)                                              \
+                                                                               \
+	_X("square_f1", chain_S, 0)                                            \
+	_X("square_f2", chain_S, 1)                                            \
+	_X("square_b2", chain_S, 2)                                            \
+	_X("square_b1", chain_S, 3)                                            \
+                                                                               \
+	_X("midstar_f1", chain_IB, 0)                                          \
+	_X("midstar_f2", chain_IB, 1)                                          \
+	_X("midstar_f3", chain_IB, 2)                                          \
+	_X("midstar_b1", chain_IB, 3)                                          \
+	_X("midstar_b2", chain_IB, 4)                                          \
+	_X("midstar_b3", chain_IB, 5)                                          \
+	_X("tipstar_l", chain_IB, 6)                                           \
+	_X("tipstar_r", chain_IB, 7)                                           \
+                                                                               \
+	_X("Lblade_b1", chain_LB, 0)                                           \
+	_X("Lblade_b2", chain_LB, 1)                                           \
+	_X("Lblade_m1", chain_LB, 2)                                           \
+	_X("Lblade_m2", chain_LB, 3)                                           \
+	_X("Lblade_t1", chain_LB, 4)                                           \
+	_X("Lblade_t2", chain_LB, 5)                                           \
+	_X("Ltriangle_f4", chain_LB, 6)                                        \
+	_X("Ltriangle_f3", chain_LB, 7)                                        \
+	_X("Ltriangle_f2", chain_LB, 8)                                        \
+	_X("Ltriangle_f1", chain_LB, 9)                                        \
+	_X("Ltriangle_b1", chain_LB, 10)                                       \
+	_X("Ltriangle_b2", chain_LB, 11)                                       \
+	_X("Ltriangle_b3", chain_LB, 12)                                       \
+	_X("Ltriangle_b4", chain_LB, 13)                                       \
+                                                                               \
+	_X("Rblade_b1", chain_RB, 0)                                           \
+	_X("Rblade_b2", chain_RB, 1)                                           \
+	_X("Rblade_m1", chain_RB, 2)                                           \
+	_X("Rblade_m2", chain_RB, 3)                                           \
+	_X("Rblade_t1", chain_RB, 4)                                           \
+	_X("Rblade_t2", chain_RB, 5)                                           \
+	_X("Rtriangle_f4", chain_RB, 6)                                        \
+	_X("Rtriangle_f3", chain_RB, 7)                                        \
+	_X("Rtriangle_f2", chain_RB, 8)                                        \
+	_X("Rtriangle_f1", chain_RB, 9)                                        \
+	_X("Rtriangle_b1", chain_RB, 10)                                       \
+	_X("Rtriangle_b2", chain_RB, 11)                                       \
+	_X("Rtriangle_b3", chain_RB, 12)                                       \
+	_X("Rtriangle_b4", chain_RB, 13)                                       \
+                                                                               \
+	_X("Lguard_1", chain_LG, 0)                                            \
+	_X("Lguard_2", chain_LG, 1)                                            \
+	_X("Lguard_3", chain_LG, 2)                                            \
+	_X("Lguard_4", chain_LG, 3)                                            \
+                                                                               \
+	_X("Rguard_1", chain_RG, 0)                                            \
+	_X("Rguard_2", chain_RG, 1)                                            \
+	_X("Rguard_3", chain_RG, 2)                                            \
+	_X("Rguard_4", chain_RG, 3)                                            \
+                                                                               \
+	_X("Lspike_t", chain_LS, 0)                                            \
+	_X("Lspike_b", chain_LS, 1)                                            \
+	_X("Lspike", chain_LS, 2)                                              \
+                                                                               \
+	_X("Rspike_t", chain_RS, 0)                                            \
+	_X("Rspike_b", chain_RS, 1)                                            \
+	_X("Rspike", chain_RS, 2)
+
+#endif /* SWORD_LEDS_H__ */
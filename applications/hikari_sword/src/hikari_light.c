@@ -1,11 +1,27 @@
 #include <zephyr/kernel.h>
 
 #include "hikari_light.h"
+#include "light_resource.h"
 
 #define HIKARI_LIGHT_THREAD_STACK_SIZE 2048
 #define HIKARI_LIGHT_THREAD_PRIORITY 5
 #define HIKARI_LIGHT_THREAD_START_DELAY_MS 500
 
+/* Duration of the crossfade between two modes. Zero switches at the next LED update. */
+#ifndef HIKARI_LIGHT_CROSSFADE_MS
+#define HIKARI_LIGHT_CROSSFADE_MS 300
+#endif
+
+/* Number of paused modes kept besides the running one. Paused modes keep
+ * their statically allocated graphs but hold no heap memory or light
+ * resources, so the budget is the number of modes kept.
+ */
+#ifndef HIKARI_LIGHT_MODE_CACHE_SIZE
+#define HIKARI_LIGHT_MODE_CACHE_SIZE 2
+#endif
+
+BUILD_ASSERT(HIKARI_LIGHT_MODE_CACHE_SIZE > 0, "The mode cache needs at least one entry");
+
 /*==============================[Action FIFO]=================================*/
 static K_FIFO_DEFINE(action_fifo);
 
@@ -46,6 +62,63 @@ static K_SEM_DEFINE(num_threads_posting_actions, 0, K_SEM_MAX_LIMIT);
 static bool accepting_new_actions = true;
 
 
+/*==============================[Mode cache]==================================*/
+struct mode_cache_entry {
+	struct hikari_light_mode_api *api; /* NULL if the entry is free */
+	enum hikari_light_mode mode;
+	uint32_t last_used;
+};
+
+static struct mode_cache_entry mode_cache[HIKARI_LIGHT_MODE_CACHE_SIZE];
+static struct hikari_light_mode_cache_stats mode_cache_stats;
+static uint32_t mode_cache_clock = 0;
+
+/* Take a paused mode out of the cache. Returns NULL if not cached. */
+static struct hikari_light_mode_api *mode_cache_take(enum hikari_light_mode mode)
+{
+	struct hikari_light_mode_api *cached_api;
+
+	for (int i = 0; i < HIKARI_LIGHT_MODE_CACHE_SIZE; i++) {
+		if (mode_cache[i].api != NULL && mode_cache[i].mode == mode) {
+			cached_api = mode_cache[i].api;
+			mode_cache[i].api = NULL;
+			mode_cache_stats.hits += 1;
+			return cached_api;
+		}
+	}
+
+	mode_cache_stats.misses += 1;
+	return NULL;
+}
+
+/* Put a paused mode into the cache, destructing the least recently used
+ * mode if the cache is full.
+ */
+static void mode_cache_put(enum hikari_light_mode mode, struct hikari_light_mode_api *mode_api)
+{
+	struct mode_cache_entry *entry = &mode_cache[0];
+
+	for (int i = 0; i < HIKARI_LIGHT_MODE_CACHE_SIZE; i++) {
+		if (mode_cache[i].api == NULL) {
+			entry = &mode_cache[i];
+			break;
+		}
+
+		if (mode_cache[i].last_used < entry->last_used) {
+			entry = &mode_cache[i];
+		}
+	}
+
+	if (entry->api != NULL) {
+		entry->api->destructor();
+		mode_cache_stats.evictions += 1;
+	}
+
+	entry->api = mode_api;
+	entry->mode = mode;
+	entry->last_used = ++mode_cache_clock;
+}
+
 /*==============================[Helper methods]==============================*/
 static void post_action(enum action_type type, void *action_data)
 {
@@ -131,6 +204,7 @@ K_THREAD_DEFINE(hikari_light_thread, HIKARI_LIGHT_THREAD_STACK_SIZE,
 static void try_switching_mode(enum hikari_light_mode new_mode)
 {
 	struct hikari_light_mode_api *new_api = NULL;
+	bool cached;
 
 	if (new_mode == mode) {
 		printk("Mode %d already set\n", new_mode);
@@ -152,12 +226,29 @@ static void try_switching_mode(enum hikari_light_mode new_mode)
 
 	accepting_new_actions = false;
 
-	/* Switch mode. */
-	if (api != NULL && api->destructor != NULL) {
-		api->destructor();
+	/* Switch mode. The new mode is resumed from the cache or built on the
+	 * hidden light resource layer while the old mode keeps running, then
+	 * the LEDs crossfade over to it. The old mode is only paused or torn
+	 * down once it is no longer shown.
+	 */
+	cached = (mode_cache_take(new_mode) != NULL);
+	if (cached) {
+		new_api->resume();
+	} else {
+		new_api->constructor();
+	}
+
+	if (api != NULL) {
+		light_resource_crossfade(HIKARI_LIGHT_CROSSFADE_MS);
+
+		if (api->pause != NULL && api->resume != NULL) {
+			api->pause();
+			mode_cache_put(mode, api);
+		} else if (api->destructor != NULL) {
+			api->destructor();
+		}
 	}
 
-	new_api->constructor();
 	mode = new_mode;
 	api = new_api;
 
@@ -213,6 +304,9 @@ static inline void hikari_light_process(struct action_item *action)
 		k_oops();
 		break;
 	}
+
+	/* Wake the LED updates, in case the mode changed the LEDs without a slab. */
+	light_resource_changed();
 }
 
 static void hikari_light_loop(void *p1, void *p2, void *p3)
@@ -239,6 +333,11 @@ enum hikari_light_mode hikari_light_mode_get(void)
 	return mode;
 }
 
+void hikari_light_mode_cache_stats_get(struct hikari_light_mode_cache_stats *stats)
+{
+	*stats = mode_cache_stats;
+}
+
 void hikari_light_tweak_color(float hue)
 {
 	post_action(ACTION_TYPE_TWEAK_COLOR, (void *)&hue);
@@ -3,13 +3,78 @@
 #include <zephyr/kernel.h>
 
 #include "adrledrgb.h"
+#include "dither.h"
+#include "gamma_lut.h"
 #include "light_resource.h"
+#include "slabs/slab_led.h"
+#include "sword_leds.h"
 
 static sys_dlist_t resources;
 static bool is_initialized = false;
 
 #define LIGHT_RESOURCE_UPDATE_PERIOD_MS 25
 
+/* Each resource exists once per layer. The LEDs show the front layer,
+ * or a blend of both layers while a crossfade runs.
+ */
+#define LIGHT_RESOURCE_NUM_LAYERS 2
+
+static struct k_spinlock layer_lock;
+static uint8_t front_layer = 0;
+static uint32_t fade_step = 0;
+static uint32_t num_fade_steps = 0; /* Zero when no crossfade runs */
+static K_SEM_DEFINE(crossfade_done_sem, 0, 1);
+
+/* Given when the next frame may differ from the last one. The LEDs are
+ * only updated periodically while frames change, see light_update_loop().
+ */
+static K_SEM_DEFINE(light_update_sem, 0, 1);
+
+/* Gamma and brightness of all LEDs, applied when composing the layers. */
+#ifndef LIGHT_RESOURCE_GAMMA
+#define LIGHT_RESOURCE_GAMMA 1.0f
+#endif
+
+static struct gamma_config correction = {
+	.gamma = LIGHT_RESOURCE_GAMMA, .brightness = 255, .balance = {255, 255, 255}
+};
+static bool correction_changed = true; /* The table is rebuilt at the next frame */
+static struct gamma_lut correction_lut;
+
+/* Current model of the LEDs. A channel draws up to LIGHT_RESOURCE_CHANNEL_MA
+ * in proportion to its value, every LED draws LIGHT_RESOURCE_LED_IDLE_MA.
+ * Frames estimated above the budget are dimmed uniformly to fit.
+ */
+#ifndef LIGHT_RESOURCE_POWER_BUDGET_MA
+#define LIGHT_RESOURCE_POWER_BUDGET_MA 2000
+#endif
+#ifndef LIGHT_RESOURCE_CHANNEL_MA
+#define LIGHT_RESOURCE_CHANNEL_MA 20
+#endif
+#ifndef LIGHT_RESOURCE_LED_IDLE_MA
+#define LIGHT_RESOURCE_LED_IDLE_MA 1
+#endif
+
+static uint32_t power_budget_ma = LIGHT_RESOURCE_POWER_BUDGET_MA;
+static uint32_t estimated_ma;
+
+/* Layers hold the 8 fractional bits per channel LED slabs keep from the
+ * slabs converting colors, and frames are composed with them. With
+ * dithering the fraction is shown over the next frames, otherwise it is
+ * rounded.
+ */
+#ifndef LIGHT_RESOURCE_DITHER
+#define LIGHT_RESOURCE_DITHER 1
+#endif
+
+/* Frames without new LED values after which the dither settles. The
+ * fraction is then rounded away, so a static frame lets the LED update
+ * sleep instead of dithering forever.
+ */
+#ifndef LIGHT_RESOURCE_DITHER_SETTLE_FRAMES
+#define LIGHT_RESOURCE_DITHER_SETTLE_FRAMES 40
+#endif
+
 /*==============================[Private methods]=============================*/
 static bool is_overlapping(uint8_t *p1, size_t l1, uint8_t *p2, size_t l2)
 {
@@ -18,7 +83,7 @@ static bool is_overlapping(uint8_t *p1, size_t l1, uint8_t *p2, size_t l2)
 	return !is_separate;
 }
 
-static bool register_resource(char *id, uint8_t *data, size_t data_size)
+static bool register_resource(char *id, uint8_t layer, uint8_t *data, size_t data_size)
 {
 	sys_dnode_t *elem;
 	struct light_resource *res_elem;
@@ -28,7 +93,7 @@ static bool register_resource(char *id, uint8_t *data, size_t data_size)
 	SYS_DLIST_FOR_EACH_NODE(&resources, elem) {
 		res_elem = CONTAINER_OF(elem, struct light_resource, root);
 
-		id_already_exist = !strcmp(res_elem->id, id);
+		id_already_exist = !strcmp(res_elem->id, id) && res_elem->layer == layer;
 		data_overlapping = is_overlapping(data, data_size, res_elem->data, res_elem->data_size);
 		if (id_already_exist || data_overlapping) {
 			return false;
@@ -41,6 +106,7 @@ static bool register_resource(char *id, uint8_t *data, size_t data_size)
 	}
 
 	new_res->id = id;
+	new_res->layer = layer;
 	new_res->data = data;
 	new_res->data_size = data_size;
 	new_res->used = false;
@@ -49,59 +115,91 @@ static bool register_resource(char *id, uint8_t *data, size_t data_size)
 }
 
 /*==============================[Setup resources]=============================*/
+/* Define a LED chain together with one LED buffer per layer,
+ * the composed frame and the dither error of each LED.
+ */
+#define LAYERED_RGB_CHAIN_DEF(name, numleds, pin, port, pin_inverted)              \
+	RGB_CHAIN_DEF(name, numleds, pin, port, pin_inverted);                      \
+	static struct rgb16_value name##_layers[LIGHT_RESOURCE_NUM_LAYERS][numleds]; \
+	static struct rgb16_value name##_frame[numleds];                             \
+	static struct dither_error name##_error[numleds]
+
 #define CHAIN_POMMEL_NUM 2
 #define CHAIN_POMMEL_PIN 14 /* D6 */
 #define CHAIN_POMMEL_PORT 1
-RGB_CHAIN_DEF(chain_P, CHAIN_POMMEL_NUM, CHAIN_POMMEL_PIN, CHAIN_POMMEL_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_P, CHAIN_POMMEL_NUM, CHAIN_POMMEL_PIN, CHAIN_POMMEL_PORT, true);
 
 #define CHAIN_CORE_NUM 6
 #define CHAIN_CORE_PIN 11 /* D2 */
 #define CHAIN_CORE_PORT 1
-RGB_CHAIN_DEF(chain_C, CHAIN_CORE_NUM, CHAIN_CORE_PIN, CHAIN_CORE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_C, CHAIN_CORE_NUM, CHAIN_CORE_PIN, CHAIN_CORE_PORT, true);
 
 #define CHAIN_SQUARE_NUM 4
 #define CHAIN_SQUARE_PIN 23 /* D7 */
 #define CHAIN_SQUARE_PORT 0
-RGB_CHAIN_DEF(chain_S, CHAIN_SQUARE_NUM, CHAIN_SQUARE_PIN, CHAIN_SQUARE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_S, CHAIN_SQUARE_NUM, CHAIN_SQUARE_PIN, CHAIN_SQUARE_PORT, true);
 
 #define CHAIN_INNER_BLADE_NUM 8
 #define CHAIN_INNER_BLADE_PIN 27 /* D9 */
 #define CHAIN_INNER_BLADE_PORT 0
-RGB_CHAIN_DEF(chain_IB, CHAIN_INNER_BLADE_NUM, CHAIN_INNER_BLADE_PIN, CHAIN_INNER_BLADE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_IB, CHAIN_INNER_BLADE_NUM, CHAIN_INNER_BLADE_PIN, CHAIN_INNER_BLADE_PORT, true);
 
 #define CHAIN_LEFT_BLADE_NUM 14
 #define CHAIN_LEFT_BLADE_PIN 2 /* D10 */
 #define CHAIN_LEFT_BLADE_PORT 1
-RGB_CHAIN_DEF(chain_LB, CHAIN_LEFT_BLADE_NUM, CHAIN_LEFT_BLADE_PIN, CHAIN_LEFT_BLADE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_LB, CHAIN_LEFT_BLADE_NUM, CHAIN_LEFT_BLADE_PIN, CHAIN_LEFT_BLADE_PORT, true);
 
 #define CHAIN_RIGHT_BLADE_NUM 14
 #define CHAIN_RIGHT_BLADE_PIN 13 /* D5 */
 #define CHAIN_RIGHT_BLADE_PORT 1
-RGB_CHAIN_DEF(chain_RB, CHAIN_RIGHT_BLADE_NUM, CHAIN_RIGHT_BLADE_PIN, CHAIN_RIGHT_BLADE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_RB, CHAIN_RIGHT_BLADE_NUM, CHAIN_RIGHT_BLADE_PIN, CHAIN_RIGHT_BLADE_PORT, true);
 
 #define CHAIN_LEFT_GUARD_NUM 4
 #define CHAIN_LEFT_GUARD_PIN 21 /* D8 */
 #define CHAIN_LEFT_GUARD_PORT 0
-RGB_CHAIN_DEF(chain_LG, CHAIN_LEFT_GUARD_NUM, CHAIN_LEFT_GUARD_PIN, CHAIN_LEFT_GUARD_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_LG, CHAIN_LEFT_GUARD_NUM, CHAIN_LEFT_GUARD_PIN, CHAIN_LEFT_GUARD_PORT, true);
 
 #define CHAIN_RIGHT_GUARD_NUM 4
 #define CHAIN_RIGHT_GUARD_PIN 15 /* D4 */
 #define CHAIN_RIGHT_GUARD_PORT 1
-RGB_CHAIN_DEF(chain_RG, CHAIN_RIGHT_GUARD_NUM, CHAIN_RIGHT_GUARD_PIN, CHAIN_RIGHT_GUARD_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_RG, CHAIN_RIGHT_GUARD_NUM, CHAIN_RIGHT_GUARD_PIN, CHAIN_RIGHT_GUARD_PORT, true);
 
 #define CHAIN_LEFT_SPIKE_NUM 3
 #define CHAIN_LEFT_SPIKE_PIN 12 /* D3 */
 #define CHAIN_LEFT_SPIKE_PORT 1
-RGB_CHAIN_DEF(chain_LS, CHAIN_LEFT_SPIKE_NUM, CHAIN_LEFT_SPIKE_PIN, CHAIN_LEFT_SPIKE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_LS, CHAIN_LEFT_SPIKE_NUM, CHAIN_LEFT_SPIKE_PIN, CHAIN_LEFT_SPIKE_PORT, true);
 
 #define CHAIN_RIGHT_SPIKE_NUM 3
 #define CHAIN_RIGHT_SPIKE_PIN 1 /* D11 */
 #define CHAIN_RIGHT_SPIKE_PORT 1
-RGB_CHAIN_DEF(chain_RS, CHAIN_RIGHT_SPIKE_NUM, CHAIN_RIGHT_SPIKE_PIN, CHAIN_RIGHT_SPIKE_PORT, true);
+LAYERED_RGB_CHAIN_DEF(chain_RS, CHAIN_RIGHT_SPIKE_NUM, CHAIN_RIGHT_SPIKE_PIN, CHAIN_RIGHT_SPIKE_PORT, true);
 
 rgb_chain_t *chains[10] = {&chain_P, &chain_C, &chain_S, &chain_IB, &chain_LB, &chain_RB,
 						  &chain_LG, &chain_RG, &chain_LS, &chain_RS};
 
+/* Layer buffers of the chains above, num_leds entries per layer. */
+static struct rgb16_value *chain_layers[10] = {
+	&chain_P_layers[0][0], &chain_C_layers[0][0], &chain_S_layers[0][0],
+	&chain_IB_layers[0][0], &chain_LB_layers[0][0], &chain_RB_layers[0][0],
+	&chain_LG_layers[0][0], &chain_RG_layers[0][0], &chain_LS_layers[0][0],
+	&chain_RS_layers[0][0]
+};
+
+static struct rgb16_value *chain_frames[10] = {
+	chain_P_frame, chain_C_frame, chain_S_frame, chain_IB_frame, chain_LB_frame,
+	chain_RB_frame, chain_LG_frame, chain_RG_frame, chain_LS_frame, chain_RS_frame
+};
+
+static struct dither_error *chain_errors[10] = {
+	chain_P_error, chain_C_error, chain_S_error, chain_IB_error, chain_LB_error,
+	chain_RB_error, chain_LG_error, chain_RG_error, chain_LS_error, chain_RS_error
+};
+
+#define ALL_CHAINS BIT_MASK(sizeof(chains)/sizeof(rgb_chain_t *))
+
+/* Chains whose layers were written since they were last composed. */
+static atomic_t dirty_chains = ATOMIC_INIT(ALL_CHAINS);
+
 #define INIT_COLOR(_chain, _num, _red, _green, _blue) \
     for (uint32_t i = 0; i < _num; i++) {             \
 		_chain.rgb_values[i].red = _red;              \
@@ -109,9 +207,12 @@ rgb_chain_t *chains[10] = {&chain_P, &chain_C, &chain_S, &chain_IB, &chain_LB, &
 		_chain.rgb_values[i].blue = _blue;            \
 	}
 
-#define REGISTER_RGB(_name, _chain, _idx)                                                  \
-	if (!register_resource(_name, (uint8_t *)&(_chain.rgb_values[_idx]), sizeof(rgb_t))) { \
-		k_oops();                                                                          \
+#define REGISTER_RGB(_name, _chain, _idx)                                                     \
+	for (uint8_t layer = 0; layer < LIGHT_RESOURCE_NUM_LAYERS; layer++) {                    \
+		if (!register_resource(_name, layer, (uint8_t *)&(_chain##_layers[layer][_idx]),  \
+				       sizeof(struct rgb16_value))) {                             \
+			k_oops();                                                         \
+		}                                                                         \
 	}
 
 static void setup_light_resources(void)
@@ -137,6 +238,13 @@ static void setup_light_resources(void)
 	INIT_COLOR(chain_RS, CHAIN_RIGHT_SPIKE_NUM, 20, 20, 20);
 
 	for (uint32_t i = 0; i < sizeof(chains)/sizeof(rgb_chain_t *); i++) {
+		/* Keep showing the initial color until the first mode draws. */
+		for (uint32_t j = 0; j < chains[i]->num_leds; j++) {
+			chain_layers[i][j].r = chains[i]->rgb_values[j].red << 8;
+			chain_layers[i][j].g = chains[i]->rgb_values[j].green << 8;
+			chain_layers[i][j].b = chains[i]->rgb_values[j].blue << 8;
+		}
+
 		do {
 			ret = adrledrgb_update_leds(chains[i]);
 			if (ret) {
@@ -145,78 +253,225 @@ static void setup_light_resources(void)
 		} while (ret != 0);
 	}
 
-	REGISTER_RGB("pommel_f", chain_P, 0);
-	REGISTER_RGB("pommel_b", chain_P, 1);
-
-	REGISTER_RGB("core_f1", chain_C, 0);
-	REGISTER_RGB("core_f2", chain_C, 1);
-	REGISTER_RGB("core_f3", chain_C, 2);
-	REGISTER_RGB("core_b1", chain_C, 3);
-	REGISTER_RGB("core_b2", chain_C, 4);
-	REGISTER_RGB("core_b3", chain_C, 5);
-
-	REGISTER_RGB("square_f1", chain_S, 0);
-	REGISTER_RGB("square_f2", chain_S, 1);
-	REGISTER_RGB("square_b2", chain_S, 2);
-	REGISTER_RGB("square_b1", chain_S, 3);
-
-	REGISTER_RGB("midstar_f1", chain_IB, 0);
-	REGISTER_RGB("midstar_f2", chain_IB, 1);
-	REGISTER_RGB("midstar_f3", chain_IB, 2);
-	REGISTER_RGB("midstar_b1", chain_IB, 3);
-	REGISTER_RGB("midstar_b2", chain_IB, 4);
-	REGISTER_RGB("midstar_b3", chain_IB, 5);
-	REGISTER_RGB("tipstar_l", chain_IB, 6);
-	REGISTER_RGB("tipstar_r", chain_IB, 7);
-
-	REGISTER_RGB("Lblade_b1", chain_LB, 0);
-	REGISTER_RGB("Lblade_b2", chain_LB, 1);
-	REGISTER_RGB("Lblade_m1", chain_LB, 2);
-	REGISTER_RGB("Lblade_m2", chain_LB, 3);
-	REGISTER_RGB("Lblade_t1", chain_LB, 4);
-	REGISTER_RGB("Lblade_t2", chain_LB, 5);
-	REGISTER_RGB("Ltriangle_f4", chain_LB, 6);
-	REGISTER_RGB("Ltriangle_f3", chain_LB, 7);
-	REGISTER_RGB("Ltriangle_f2", chain_LB, 8);
-	REGISTER_RGB("Ltriangle_f1", chain_LB, 9);
-	REGISTER_RGB("Ltriangle_b1", chain_LB, 10);
-	REGISTER_RGB("Ltriangle_b2", chain_LB, 11);
-	REGISTER_RGB("Ltriangle_b3", chain_LB, 12);
-	REGISTER_RGB("Ltriangle_b4", chain_LB, 13);
-
-	REGISTER_RGB("Rblade_b1", chain_RB, 0);
-	REGISTER_RGB("Rblade_b2", chain_RB, 1);
-	REGISTER_RGB("Rblade_m1", chain_RB, 2);
-	REGISTER_RGB("Rblade_m2", chain_RB, 3);
-	REGISTER_RGB("Rblade_t1", chain_RB, 4);
-	REGISTER_RGB("Rblade_t2", chain_RB, 5);
-	REGISTER_RGB("Rtriangle_f4", chain_RB, 6);
-	REGISTER_RGB("Rtriangle_f3", chain_RB, 7);
-	REGISTER_RGB("Rtriangle_f2", chain_RB, 8);
-	REGISTER_RGB("Rtriangle_f1", chain_RB, 9);
-	REGISTER_RGB("Rtriangle_b1", chain_RB, 10);
-	REGISTER_RGB("Rtriangle_b2", chain_RB, 11);
-	REGISTER_RGB("Rtriangle_b3", chain_RB, 12);
-	REGISTER_RGB("Rtriangle_b4", chain_RB, 13);
-
-
-	REGISTER_RGB("Lguard_1", chain_LG, 0);
-	REGISTER_RGB("Lguard_2", chain_LG, 1);
-	REGISTER_RGB("Lguard_3", chain_LG, 2);
-	REGISTER_RGB("Lguard_4", chain_LG, 3);
-
-	REGISTER_RGB("Rguard_1", chain_RG, 0);
-	REGISTER_RGB("Rguard_2", chain_RG, 1);
-	REGISTER_RGB("Rguard_3", chain_RG, 2);
-	REGISTER_RGB("Rguard_4", chain_RG, 3);
-
-	REGISTER_RGB("Lspike_t", chain_LS, 0);
-	REGISTER_RGB("Lspike_b", chain_LS, 1);
-	REGISTER_RGB("Lspike", chain_LS, 2);
-
-	REGISTER_RGB("Rspike_t", chain_RS, 0);
-	REGISTER_RGB("Rspike_b", chain_RS, 1);
-	REGISTER_RGB("Rspike", chain_RS, 2);
+	SWORD_LEDS(REGISTER_RGB)
+}
+
+/*==============================[Layer Compositing]==========================*/
+static inline uint16_t blend(uint16_t from, uint16_t to, uint32_t step, uint32_t num_steps)
+{
+	return (from * (num_steps - step) + to * step) / num_steps;
+}
+
+static inline void correct(struct rgb16_value *led, const struct rgb16_value *val)
+{
+	*led = gamma_lut_apply16(&correction_lut, *val);
+}
+
+static inline uint32_t channel_sum(const struct rgb16_value *led)
+{
+	return led->r + led->g + led->b;
+}
+
+/* Scale factor in 1/256 steps that keeps the frame within the power budget,
+ * 256 if it already fits. chain_sums holds the summed channel values of
+ * each chain, with 8 fractional bits.
+ */
+static uint32_t limit_power(const uint32_t *chain_sums)
+{
+	uint32_t num_leds = 0;
+	uint32_t sum = 0;
+	uint32_t idle_ma;
+	uint32_t drive_ma;
+
+	for (uint32_t i = 0; i < sizeof(chains)/sizeof(rgb_chain_t *); i++) {
+		num_leds += chains[i]->num_leds;
+		sum += chain_sums[i];
+	}
+
+	idle_ma = num_leds * LIGHT_RESOURCE_LED_IDLE_MA;
+	drive_ma = (uint64_t)sum * LIGHT_RESOURCE_CHANNEL_MA / (UINT8_MAX << 8);
+	estimated_ma = idle_ma + drive_ma;
+
+	if (estimated_ma <= power_budget_ma) {
+		return 256;
+	}
+
+	/* Rounded down to stay within the budget. */
+	return (power_budget_ma > idle_ma) ? ((power_budget_ma - idle_ma) << 8) / drive_ma : 0;
+}
+
+static inline uint16_t apply_scale(uint16_t val, uint32_t scale)
+{
+	return (scale < 256) ? (val * scale) >> 8 : val;
+}
+
+static inline uint8_t round_channel(uint16_t value)
+{
+	return MIN((value + 0x80) >> 8, UINT8_MAX);
+}
+
+/* Bring a composed chain down to the 8 bit LED values, dithered or rounded.
+ * Returns true if a fraction is dithered, so the LEDs change next frame.
+ */
+static bool output_chain(uint32_t chain, uint32_t scale, bool dither)
+{
+	uint16_t fraction = 0;
+	const struct rgb16_value *frame = chain_frames[chain];
+#if LIGHT_RESOURCE_DITHER
+	struct dither_error *error = chain_errors[chain];
+#endif
+	rgb_t *out = chains[chain]->rgb_values;
+
+	for (uint32_t j = 0; j < chains[chain]->num_leds; j++) {
+		uint16_t red = apply_scale(frame[j].r, scale);
+		uint16_t green = apply_scale(frame[j].g, scale);
+		uint16_t blue = apply_scale(frame[j].b, scale);
+
+		fraction |= red | green | blue;
+
+#if LIGHT_RESOURCE_DITHER
+		if (dither) {
+			out[j].red = dither_channel(red, &error[j].r);
+			out[j].green = dither_channel(green, &error[j].g);
+			out[j].blue = dither_channel(blue, &error[j].b);
+			continue;
+		}
+#endif
+		out[j].red = round_channel(red);
+		out[j].green = round_channel(green);
+		out[j].blue = round_channel(blue);
+	}
+
+	return LIGHT_RESOURCE_DITHER && dither && (fraction & 0xff);
+}
+
+/* Write the shown layers into the LED chains, once per frame.
+ * Gamma, brightness and the power budget are applied on the way.
+ * Only chains written since the last frame are composed again, all of
+ * them while a crossfade runs or when the correction changed. After
+ * LIGHT_RESOURCE_DITHER_SETTLE_FRAMES frames without changes the LEDs
+ * show the rounded values.
+ * Returns true if the next frame differs even without new LED values.
+ */
+static bool compose_layers(void)
+{
+	/* Channel sums of the composed chains, kept between frames */
+	static uint32_t chain_sums[sizeof(chains)/sizeof(rgb_chain_t *)];
+	static uint32_t last_scale = 256;
+	static uint32_t dithering_chains;
+	static uint32_t num_static_frames;
+
+	k_spinlock_key_t key = k_spin_lock(&layer_lock);
+	uint8_t front = front_layer;
+	uint8_t back = (front_layer + 1) % LIGHT_RESOURCE_NUM_LAYERS;
+	uint32_t step = 0;
+	uint32_t num_steps = num_fade_steps;
+	struct gamma_config new_correction = correction;
+	bool rebuild_lut = correction_changed;
+	uint32_t dirty = atomic_clear(&dirty_chains);
+	uint32_t scale;
+	bool dither;
+
+	correction_changed = false;
+
+	/* A crossfade changes every chain, up to its last step. */
+	if (rebuild_lut || num_steps > 0) {
+		dirty = ALL_CHAINS;
+	}
+
+	if (num_steps > 0) {
+		step = ++fade_step;
+		if (step >= num_steps) {
+			/* Crossfade done, swap the layers at this frame. */
+			front_layer = back;
+			front = back;
+			num_fade_steps = 0;
+			num_steps = 0;
+			k_sem_give(&crossfade_done_sem);
+		}
+	}
+	k_spin_unlock(&layer_lock, key);
+
+	if (rebuild_lut) {
+		gamma_lut_build(&correction_lut, &new_correction);
+	}
+
+	for (uint32_t i = 0; i < sizeof(chains)/sizeof(rgb_chain_t *); i++) {
+		uint32_t num_leds = chains[i]->num_leds;
+		const struct rgb16_value *from = &chain_layers[i][front * num_leds];
+		const struct rgb16_value *to = &chain_layers[i][back * num_leds];
+		struct rgb16_value *frame = chain_frames[i];
+
+		if (!(dirty & BIT(i))) {
+			continue;
+		}
+
+		chain_sums[i] = 0;
+
+		if (num_steps == 0) {
+			for (uint32_t j = 0; j < num_leds; j++) {
+				correct(&frame[j], &from[j]);
+				chain_sums[i] += channel_sum(&frame[j]);
+			}
+			continue;
+		}
+
+		/* Blend after correction, so the fraction of the blend is kept. */
+		for (uint32_t j = 0; j < num_leds; j++) {
+			struct rgb16_value target;
+
+			correct(&frame[j], &from[j]);
+			correct(&target, &to[j]);
+			frame[j].r = blend(frame[j].r, target.r, step, num_steps);
+			frame[j].g = blend(frame[j].g, target.g, step, num_steps);
+			frame[j].b = blend(frame[j].b, target.b, step, num_steps);
+			chain_sums[i] += channel_sum(&frame[j]);
+		}
+	}
+
+	scale = limit_power(chain_sums);
+
+	/* Chains that did not change keep their LED values, unless they are
+	 * dimmed differently or still dither a fraction.
+	 */
+	if (scale != last_scale) {
+		dirty = ALL_CHAINS;
+		last_scale = scale;
+	}
+
+	/* Settle the dither once the frame stayed the same for a while. */
+	num_static_frames = (dirty != 0) ? 0 : MIN(num_static_frames + 1,
+						      LIGHT_RESOURCE_DITHER_SETTLE_FRAMES);
+	dither = (num_static_frames < LIGHT_RESOURCE_DITHER_SETTLE_FRAMES);
+	dirty |= dithering_chains;
+
+	for (uint32_t i = 0; i < sizeof(chains)/sizeof(rgb_chain_t *); i++) {
+		if (!(dirty & BIT(i))) {
+			continue;
+		}
+
+		WRITE_BIT(dithering_chains, i, output_chain(i, scale, dither));
+	}
+
+	return dithering_chains != 0 || num_steps > 0;
+}
+
+/* Mark the chain holding a LED buffer written by a LED slab. */
+static void led_written(void *led_buf)
+{
+	struct rgb16_value *led = led_buf;
+
+	for (uint32_t i = 0; i < sizeof(chains)/sizeof(rgb_chain_t *); i++) {
+		uint32_t num_values = LIGHT_RESOURCE_NUM_LAYERS * chains[i]->num_leds;
+
+		if (led >= chain_layers[i] && led < chain_layers[i] + num_values) {
+			atomic_or(&dirty_chains, BIT(i));
+			k_sem_give(&light_update_sem);
+			return;
+		}
+	}
+
+	light_resource_changed();
 }
 
 /*==============================[Light Update Thread]========================*/
@@ -233,6 +488,7 @@ static void light_update_loop(void *p1, void *p2, void *p3)
 	k_sem_take(&light_init_sem, K_FOREVER);
 
 	while (1) {
+		bool is_changing = compose_layers();
 
 		for (uint32_t i = 0; i < sizeof(chains)/sizeof(rgb_chain_t *); i++) {
 			do {
@@ -243,6 +499,11 @@ static void light_update_loop(void *p1, void *p2, void *p3)
 			} while (ret != 0);
 		}
 
+		/* Static output, sleep until a LED or the correction changes. */
+		if (!is_changing) {
+			k_sem_take(&light_update_sem, K_FOREVER);
+		}
+
 		k_sleep(K_MSEC(LIGHT_RESOURCE_UPDATE_PERIOD_MS));
 	}
 }
@@ -264,6 +525,8 @@ void light_resource_init(void)
 
 	setup_light_resources();
 
+	slab_led_written_cb_set(led_written);
+
 	k_sem_give(&light_init_sem);
 }
 
@@ -271,8 +534,10 @@ light_res_err_t light_resource_use(char *id, struct light_resource **res)
 {
 	sys_dnode_t *elem;
 	struct light_resource *res_elem;
+	struct light_resource *found = NULL;
 	bool id_wrong;
 
+	/* Prefer the front layer, fall back to the back layer. */
 	SYS_DLIST_FOR_EACH_NODE(&resources, elem) {
 		res_elem = CONTAINER_OF(elem, struct light_resource, root);
 
@@ -281,18 +546,32 @@ light_res_err_t light_resource_use(char *id, struct light_resource **res)
 			continue;
 		}
 
+		if (found == NULL) {
+			found = res_elem;
+		}
+
 		if (res_elem->used) {
-			*res = NULL;
-			return LIGHT_RESOURCE_ALLREADY_USED;
-		} else {
-			res_elem->used = true;
-			*res = res_elem;
-			return LIGHT_RESOURCE_SUCCESS;
+			continue;
+		}
+
+		if (found->used || res_elem->layer == front_layer) {
+			found = res_elem;
 		}
 	}
 
-	*res = NULL;
-	return LIGHT_RESOURCE_NOT_FOUND;
+	if (found == NULL) {
+		*res = NULL;
+		return LIGHT_RESOURCE_NOT_FOUND;
+	}
+
+	if (found->used) {
+		*res = NULL;
+		return LIGHT_RESOURCE_ALLREADY_USED;
+	}
+
+	found->used = true;
+	*res = found;
+	return LIGHT_RESOURCE_SUCCESS;
 }
 
 light_res_err_t light_resource_return(struct light_resource *res)
@@ -308,10 +587,74 @@ light_res_err_t light_resource_return(struct light_resource *res)
 		}
 
 		res->used = false;
+
+		/* Blank hidden layers, so their next user starts from black. */
+		if (res->layer != front_layer) {
+			memset(res->data, 0, res->data_size);
+		}
 		return LIGHT_RESOURCE_SUCCESS;
 	}
 
 	return LIGHT_RESOURCE_NOT_FOUND;
 }
 
+void light_resource_crossfade(uint32_t duration_ms)
+{
+	k_spinlock_key_t key;
+
+	if (!is_initialized) {
+		front_layer = (front_layer + 1) % LIGHT_RESOURCE_NUM_LAYERS;
+		return;
+	}
+
+	key = k_spin_lock(&layer_lock);
+	fade_step = 0;
+	num_fade_steps = MAX(DIV_ROUND_UP(duration_ms, LIGHT_RESOURCE_UPDATE_PERIOD_MS), 1);
+	k_spin_unlock(&layer_lock, key);
+
+	light_resource_changed();
+
+	k_sem_take(&crossfade_done_sem, K_FOREVER);
+}
+
+void light_resource_correction_set(const struct gamma_config *config)
+{
+	k_spinlock_key_t key = k_spin_lock(&layer_lock);
+
+	correction = *config;
+	correction_changed = true;
+	k_spin_unlock(&layer_lock, key);
+
+	light_resource_changed();
+}
+
+void light_resource_power_budget_set(uint32_t budget_ma)
+{
+	power_budget_ma = budget_ma;
+
+	light_resource_changed();
+}
+
+uint32_t light_resource_power_estimate_get(void)
+{
+	return estimated_ma;
+}
+
+void light_resource_brightness_set(uint8_t brightness)
+{
+	k_spinlock_key_t key = k_spin_lock(&layer_lock);
+
+	correction.brightness = brightness;
+	correction_changed = true;
+	k_spin_unlock(&layer_lock, key);
+
+	light_resource_changed();
+}
+
+void light_resource_changed(void)
+{
+	atomic_or(&dirty_chains, ALL_CHAINS);
+	k_sem_give(&light_update_sem);
+}
+
 /*============================================================================*/
@@ -1,5 +1,6 @@
 #include "light_resource.h"
 #include "slab.h"
+#include "slab_graph.h"
 #include "slabs/slab_led.h"
 
 /* LED resources */
@@ -22,42 +23,45 @@ static struct light_resource *lls[3];
 static struct light_resource *lrs[3];
 
 /* Slabs */
-static struct slab *slp[2];
-static struct slab *slc[6];
-static struct slab *slsq[4];
+SLAB_LED_ARRAY_DEFINE(slp, 2, LED_TYPE_GRB16);
+SLAB_LED_ARRAY_DEFINE(slc, 6, LED_TYPE_RGB16);
+SLAB_LED_ARRAY_DEFINE(slsq, 4, LED_TYPE_RGB16);
 
-static struct slab *slms[6];
-static struct slab *slts[2];
+SLAB_LED_ARRAY_DEFINE(slms, 6, LED_TYPE_RGB16);
+SLAB_LED_ARRAY_DEFINE(slts, 2, LED_TYPE_GRB16);
 
-static struct slab *sllb[6];
-static struct slab *sllt[8];
-static struct slab *slrb[6];
-static struct slab *slrt[8];
+SLAB_LED_ARRAY_DEFINE(sllb, 6, LED_TYPE_RGB16);
+SLAB_LED_ARRAY_DEFINE(sllt, 8, LED_TYPE_RGB16);
+SLAB_LED_ARRAY_DEFINE(slrb, 6, LED_TYPE_RGB16);
+SLAB_LED_ARRAY_DEFINE(slrt, 8, LED_TYPE_RGB16);
 
-static struct slab *sllg[4];
-static struct slab *slrg[4];
+SLAB_LED_ARRAY_DEFINE(sllg, 4, LED_TYPE_RGB16);
+SLAB_LED_ARRAY_DEFINE(slrg, 4, LED_TYPE_RGB16);
 
-static struct slab *slls[3];
-static struct slab *slrs[3];
+SLAB_LED_ARRAY_DEFINE(slls, 3, LED_TYPE_GRB16);
+SLAB_LED_ARRAY_DEFINE(slrs, 3, LED_TYPE_GRB16);
 
-#define CREATE_LED_ARRAY(_slab_array, _led_array)                                       \
-	if (sizeof(_slab_array)/sizeof(struct slab *) !=                                    \
-		sizeof(_led_array)/sizeof(struct light_resource *)) {                           \
+/* Edge into an LED slab. LEDs only consume colors, so ticks and resets
+ * are not passed on to them, nor through the LED fan-outs below them.
+ */
+#define SLAB_LED_EDGE(_parent, _child)                                                  \
+	SLAB_EDGE_MASK(_parent, _child,                                                     \
+		       SLAB_EVENT_MASK(SLAB_EVENT_RGB) | SLAB_EVENT_MASK(SLAB_EVENT_RGB_FRAME))
+
+#define BIND_LED_ARRAY(_slab_array, _led_array)                                         \
+	if (ARRAY_SIZE(_slab_array) != ARRAY_SIZE(_led_array)) {                            \
 		printk("slab and led resource array sizes mismatch");                           \
 		k_oops();                                                                       \
 	}                                                                                   \
-	for (int i = 0; i < sizeof(_slab_array)/sizeof(struct slab *); i++) {               \
-		_slab_array[i] = slab_create(SLAB_TYPE_LED, _led_array[i]->data, LED_TYPE_RGB); \
+	for (int i = 0; i < ARRAY_SIZE(_slab_array); i++) {                                 \
+		slab_led_set_buffer(SLAB_OF(_slab_array[i]), _led_array[i]->data);              \
 	}
 
-#define DESTROY_LED_ARRAY(_slab_array)                                                  \
-	for (int i = sizeof(_slab_array)/sizeof(struct slab *) - 1; i >= 0; i--) {          \
-		slab_destroy(_slab_array[i]);                                                   \
+#define UNBIND_LED_ARRAY(_slab_array)                                                   \
+	for (int i = 0; i < ARRAY_SIZE(_slab_array); i++) {                                 \
+		slab_led_set_buffer(SLAB_OF(_slab_array[i]), NULL);                             \
 	}
 
-#define SET_LED_TYPE(_led_slab, _type)                                                  \
-	((struct slab_led *)_led_slab)->led_type = _type
-
 #define USE_ALL_HIKARI_LIGHT_RESOURCES            \
 	  light_resource_use("pommel_f", &lp[0])      \
 	| light_resource_use("pommel_b", &lp[1])      \
@@ -134,45 +138,35 @@ static struct slab *slrs[3];
 	| light_resource_use("Rspike_b", &lrs[1])     \
 	| light_resource_use("Rspike", &lrs[2])
 
-#define CREATE_ALL_HIKARI_LIGHT_SLABS    \
-	CREATE_LED_ARRAY(slp, lp);           \
-	SET_LED_TYPE(slp[0], LED_TYPE_GRB);  \
-	SET_LED_TYPE(slp[1], LED_TYPE_GRB);  \
-	CREATE_LED_ARRAY(slc, lc);           \
-	CREATE_LED_ARRAY(slsq, lsq);         \
-	CREATE_LED_ARRAY(slms, lms);         \
-	CREATE_LED_ARRAY(slts, lts);         \
-	SET_LED_TYPE(slts[0], LED_TYPE_GRB); \
-	SET_LED_TYPE(slts[1], LED_TYPE_GRB); \
-	CREATE_LED_ARRAY(sllb, llb);         \
-	CREATE_LED_ARRAY(sllt, llt);         \
-	CREATE_LED_ARRAY(slrb, lrb);         \
-	CREATE_LED_ARRAY(slrt, lrt);         \
-	CREATE_LED_ARRAY(sllg, llg);         \
-	CREATE_LED_ARRAY(slrg, lrg);         \
-	CREATE_LED_ARRAY(slls, lls);         \
-	SET_LED_TYPE(slls[0], LED_TYPE_GRB); \
-	SET_LED_TYPE(slls[1], LED_TYPE_GRB); \
-	SET_LED_TYPE(slls[2], LED_TYPE_GRB); \
-	CREATE_LED_ARRAY(slrs, lrs);         \
-	SET_LED_TYPE(slrs[0], LED_TYPE_GRB); \
-	SET_LED_TYPE(slrs[1], LED_TYPE_GRB); \
-	SET_LED_TYPE(slrs[2], LED_TYPE_GRB)
-
-#define DESTROY_ALL_HIKARI_LIGHT_SLABS \
-	DESTROY_LED_ARRAY(slrs);           \
-	DESTROY_LED_ARRAY(slls);           \
-	DESTROY_LED_ARRAY(slrg);           \
-	DESTROY_LED_ARRAY(sllg);           \
-	DESTROY_LED_ARRAY(slrt);           \
-	DESTROY_LED_ARRAY(slrb);           \
-	DESTROY_LED_ARRAY(sllt);           \
-	DESTROY_LED_ARRAY(sllb);           \
-	DESTROY_LED_ARRAY(slts);           \
-	DESTROY_LED_ARRAY(slms);           \
-	DESTROY_LED_ARRAY(slsq);           \
-	DESTROY_LED_ARRAY(slc);            \
-	DESTROY_LED_ARRAY(slp)
+#define BIND_ALL_HIKARI_LIGHT_SLABS \
+	BIND_LED_ARRAY(slp, lp);        \
+	BIND_LED_ARRAY(slc, lc);        \
+	BIND_LED_ARRAY(slsq, lsq);      \
+	BIND_LED_ARRAY(slms, lms);      \
+	BIND_LED_ARRAY(slts, lts);      \
+	BIND_LED_ARRAY(sllb, llb);      \
+	BIND_LED_ARRAY(sllt, llt);      \
+	BIND_LED_ARRAY(slrb, lrb);      \
+	BIND_LED_ARRAY(slrt, lrt);      \
+	BIND_LED_ARRAY(sllg, llg);      \
+	BIND_LED_ARRAY(slrg, lrg);      \
+	BIND_LED_ARRAY(slls, lls);      \
+	BIND_LED_ARRAY(slrs, lrs)
+
+#define UNBIND_ALL_HIKARI_LIGHT_SLABS \
+	UNBIND_LED_ARRAY(slrs);           \
+	UNBIND_LED_ARRAY(slls);           \
+	UNBIND_LED_ARRAY(slrg);           \
+	UNBIND_LED_ARRAY(sllg);           \
+	UNBIND_LED_ARRAY(slrt);           \
+	UNBIND_LED_ARRAY(slrb);           \
+	UNBIND_LED_ARRAY(sllt);           \
+	UNBIND_LED_ARRAY(sllb);           \
+	UNBIND_LED_ARRAY(slts);           \
+	UNBIND_LED_ARRAY(slms);           \
+	UNBIND_LED_ARRAY(slsq);           \
+	UNBIND_LED_ARRAY(slc);            \
+	UNBIND_LED_ARRAY(slp)
 
 #define RETURN_ALL_HIKARI_LIGHT_RESOURCES \
 	  light_resource_return(lp[0])        \
@@ -249,3 +243,41 @@ static struct slab *slrs[3];
 	| light_resource_return(lrs[0])       \
 	| light_resource_return(lrs[1])       \
 	| light_resource_return(lrs[2])
+
+static bool resources_used = false;
+
+/* Use all LED resources and bind the LED slabs of the mode to them. */
+static void use_all_resources(void)
+{
+	light_res_err_t res_err = 0;
+
+	res_err = USE_ALL_HIKARI_LIGHT_RESOURCES;
+	if (res_err) {
+		printk("resource use err %d", res_err);
+		k_oops();
+	}
+
+	BIND_ALL_HIKARI_LIGHT_SLABS;
+
+	resources_used = true;
+}
+
+/* Unbind the LED slabs of the mode and return all LED resources. */
+static void return_all_resources(void)
+{
+	light_res_err_t res_err = 0;
+
+	if (!resources_used) {
+		return;
+	}
+
+	UNBIND_ALL_HIKARI_LIGHT_SLABS;
+
+	res_err = RETURN_ALL_HIKARI_LIGHT_RESOURCES;
+	if (res_err) {
+		printk("resource return err %d", res_err);
+		k_oops();
+	}
+
+	resources_used = false;
+}
@@ -4,7 +4,11 @@
 #include "hikari_light.h"
 
 #include "slab.h"
+#include "slab_graph.h"
+#include "slabs/slab_ticker.h"
 #include "slabs/slab_glower.h"
+#include "slabs/slab_hsv2rgb.h"
+#include "slabs/slab_delay.h"
 #include "slabs/slab_led.h"
 #include "slabs/slab_notifier.h"
 
@@ -12,27 +16,19 @@
 #include "../lib/slab/events/slab_event_rgb.h"
 
 #include "default_resources.h"
+#include "static_frame.h"
+
+/* Source Generator */
+static const struct slab_glower_config sg_config = {
+	.hue = COLOR_NUM(130), .sat = COLOR_NUM(0.9),
+	.val = {.a = COLOR_NUM(0.25), .b = COLOR_NUM(0.25),
+		.ym = COLOR_NUM(0.3), .yd = COLOR_NUM(4.0)}
+};
 
 /* Slabs */
-static struct slab *st;
-static struct slab *sg;
-static struct slab *sc;
-
-static struct slab *cb1;
-
-static struct slab *sd1;
-static struct slab *sd2;
-static struct slab *sd3;
-static struct slab *sd4;
-static struct slab *sd5;
-static struct slab *sd6;
-static struct slab *sd7;
-static struct slab *sd8;
-static struct slab *sd9;
-static struct slab *sd10;
-static struct slab *sd11;
-static struct slab *sd12;
-static struct slab *sd13;
+SLAB_TICKER_DEFINE(st, 25);
+SLAB_GLOWER_DEFINE(sg, &sg_config);
+SLAB_HSV2RGB_DEFINE(sc);
 
 static void print_callback(struct slab_event *evt, void *ctx)
 {
@@ -43,189 +39,167 @@ static void print_callback(struct slab_event *evt, void *ctx)
 	}*/
 }
 
-static void glow_constructor(void)
-{
-	light_res_err_t res_err = 0;
+/* Debug callback */
+SLAB_NOTIFIER_DEFINE(cb1, print_callback, NULL);
 
-	res_err = USE_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource use err %d", res_err);
-		k_oops();
-	}
+/* Delay of each part, in ticks. One tap per part, in the order of the edges below. */
+SLAB_TAPPED_DELAY_DEFINE(std, 100, 80, 20, 60, 100, 20, 40, 60, 80, 100, 20, 40, 20, 20);
 
-	CREATE_ALL_HIKARI_LIGHT_SLABS;
+/* Idle the ticker once the source color settled on every part */
+STATIC_FRAME_WATCH_DEFINE(watch, st, 100);
+SLAB_NOTIFIER_DEFINE(ssw, static_frame_watch_cb, &watch);
 
+SLAB_GRAPH_DEFINE(graph,
 	/* Source Generator */
-	struct slab_glower_config sg_config = {
-		.hue = 130, .sat = 0.9,
-		.val = {.a = 0.25, .b = 0.25, .ym = 0.3, .yd = 4.0}
-	};
-	st = slab_create(SLAB_TYPE_TICKER, K_MSEC(25));
-	sg = slab_create(SLAB_TYPE_GLOWER, &sg_config);
-	sc = slab_create(SLAB_TYPE_HSV2RGB);
-	slab_connect(sg, st);
-	slab_connect(sc, sg);
+	SLAB_EDGE(st, sg),
+	SLAB_EDGE(sg, sc),
 
 	/* Debug callback */
-	cb1 = slab_create(SLAB_TYPE_NOTIFIER, print_callback, NULL);
-	slab_connect(cb1, sc);
+	SLAB_EDGE(sc, cb1),
+
+	/* Static frame watch */
+	SLAB_EDGE_MASK(sc, ssw, SLAB_EVENT_MASK(SLAB_EVENT_RGB) | SLAB_EVENT_MASK(SLAB_EVENT_RESET)),
 
 	/* Start glow from core */
-	slab_connect(slc[0], sc);
-	slab_connect(slc[1], slc[0]);
-	slab_connect(slc[2], slc[0]);
-	slab_connect(slc[3], slc[0]);
-	slab_connect(slc[4], slc[0]);
-	slab_connect(slc[5], slc[0]);
+	SLAB_LED_EDGE(sc, slc[0]),
+	SLAB_LED_EDGE(slc[0], slc[1]),
+	SLAB_LED_EDGE(slc[0], slc[2]),
+	SLAB_LED_EDGE(slc[0], slc[3]),
+	SLAB_LED_EDGE(slc[0], slc[4]),
+	SLAB_LED_EDGE(slc[0], slc[5]),
+
+	/* Delayed glow, one tap per part */
+	SLAB_EDGE(sc, std),
 
 	/* Pommel glow */
-	sd1 = slab_create(SLAB_TYPE_DELAY, 80);
-	slab_connect(sd1, sc);
-	slab_connect(slp[0], sd1);
-	slab_connect(slp[1], sd1);
+	SLAB_LED_EDGE(std, slp[0]),
+	SLAB_LED_EDGE(slp[0], slp[1]),
 
 	/* Inner blade glow stage 1 */
-	sd2 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd2, sc);
-	slab_connect(slsq[0], sd2);
-	slab_connect(slsq[1], sd2);
+	SLAB_LED_EDGE(std, slsq[0]),
+	SLAB_LED_EDGE(slsq[0], slsq[1]),
 
 	/* Inner blade glow stage 2 */
-	sd3 = slab_create(SLAB_TYPE_DELAY, 40);
-	slab_connect(sd3, sd2);
-	slab_connect(slms[0], sd3);
-	slab_connect(slms[1], sd3);
-	slab_connect(slms[2], sd3);
-	slab_connect(slms[3], sd3);
-	slab_connect(slms[4], sd3);
-	slab_connect(slms[5], sd3);
+	SLAB_LED_EDGE(std, slms[0]),
+	SLAB_LED_EDGE(slms[0], slms[1]),
+	SLAB_LED_EDGE(slms[0], slms[2]),
+	SLAB_LED_EDGE(slms[0], slms[3]),
+	SLAB_LED_EDGE(slms[0], slms[4]),
+	SLAB_LED_EDGE(slms[0], slms[5]),
 
 	/* Inner blade glow stage 3 */
-	sd4 = slab_create(SLAB_TYPE_DELAY, 40);
-	slab_connect(sd4, sd3);
-	slab_connect(slts[0], sd4);
-	slab_connect(slts[1], sd4);
+	SLAB_LED_EDGE(std, slts[0]),
+	SLAB_LED_EDGE(slts[0], slts[1]),
 
 	/* Outer blade glow stage 1 */
-	sd5 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd5, sc);
-	slab_connect(sllb[0], sd5);
-	slab_connect(sllb[1], sd5);
-	slab_connect(slrb[0], sd5);
-	slab_connect(slrb[1], sd5);
+	SLAB_LED_EDGE(std, sllb[0]),
+	SLAB_LED_EDGE(sllb[0], sllb[1]),
+	SLAB_LED_EDGE(sllb[0], slrb[0]),
+	SLAB_LED_EDGE(sllb[0], slrb[1]),
 
 	/* Outer blade glow stage 2 */
-	sd6 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd6, sd5);
-	slab_connect(sllb[2], sd6);
-	slab_connect(sllb[3], sd6);
-	slab_connect(slrb[2], sd6);
-	slab_connect(slrb[3], sd6);
+	SLAB_LED_EDGE(std, sllb[2]),
+	SLAB_LED_EDGE(sllb[2], sllb[3]),
+	SLAB_LED_EDGE(sllb[2], slrb[2]),
+	SLAB_LED_EDGE(sllb[2], slrb[3]),
 
 	/* Outer blade glow stage 3 */
-	sd7 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd7, sd6);
-	slab_connect(sllb[4], sd7);
-	slab_connect(sllb[5], sd7);
-	slab_connect(slrb[4], sd7);
-	slab_connect(slrb[5], sd7);
+	SLAB_LED_EDGE(std, sllb[4]),
+	SLAB_LED_EDGE(sllb[4], sllb[5]),
+	SLAB_LED_EDGE(sllb[4], slrb[4]),
+	SLAB_LED_EDGE(sllb[4], slrb[5]),
 
 	/* Outer blade glow stage 4 */
-	sd8 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd8, sd7);
-	slab_connect(sllt[2], sd8);
-	slab_connect(sllt[3], sd8);
-	slab_connect(sllt[6], sd8);
-	slab_connect(sllt[7], sd8);
-	slab_connect(slrt[2], sd8);
-	slab_connect(slrt[3], sd8);
-	slab_connect(slrt[6], sd8);
-	slab_connect(slrt[7], sd8);
+	SLAB_LED_EDGE(std, sllt[2]),
+	SLAB_LED_EDGE(sllt[2], sllt[3]),
+	SLAB_LED_EDGE(sllt[2], sllt[6]),
+	SLAB_LED_EDGE(sllt[2], sllt[7]),
+	SLAB_LED_EDGE(sllt[2], slrt[2]),
+	SLAB_LED_EDGE(sllt[2], slrt[3]),
+	SLAB_LED_EDGE(sllt[2], slrt[6]),
+	SLAB_LED_EDGE(sllt[2], slrt[7]),
 
 	/* Outer blade glow stage 5 */
-	sd9 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd9, sd8);
-	slab_connect(sllt[0], sd9);
-	slab_connect(sllt[1], sd9);
-	slab_connect(sllt[4], sd9);
-	slab_connect(sllt[5], sd9);
-	slab_connect(slrt[0], sd9);
-	slab_connect(slrt[1], sd9);
-	slab_connect(slrt[4], sd9);
-	slab_connect(slrt[5], sd9);
+	SLAB_LED_EDGE(std, sllt[0]),
+	SLAB_LED_EDGE(sllt[0], sllt[1]),
+	SLAB_LED_EDGE(sllt[0], sllt[4]),
+	SLAB_LED_EDGE(sllt[0], sllt[5]),
+	SLAB_LED_EDGE(sllt[0], slrt[0]),
+	SLAB_LED_EDGE(sllt[0], slrt[1]),
+	SLAB_LED_EDGE(sllt[0], slrt[4]),
+	SLAB_LED_EDGE(sllt[0], slrt[5]),
 
 	/* Spike glow stage 1 */
-	sd10 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd10, sc);
-	slab_connect(slls[0], sd10);
-	slab_connect(slls[1], sd10);
-	slab_connect(slrs[0], sd10);
-	slab_connect(slrs[1], sd10);
+	SLAB_LED_EDGE(std, slls[0]),
+	SLAB_LED_EDGE(slls[0], slls[1]),
+	SLAB_LED_EDGE(slls[0], slrs[0]),
+	SLAB_LED_EDGE(slls[0], slrs[1]),
 
 	/* Spike glow stage 2 */
-	sd11 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd11, sd10);
-	slab_connect(slls[2], sd11);
-	slab_connect(slrs[2], sd11);
+	SLAB_LED_EDGE(std, slls[2]),
+	SLAB_LED_EDGE(slls[2], slrs[2]),
 
 	/* Guard glow stage 1 */
-	sd12 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd12, sc);
-	slab_connect(sllg[0], sd12);
-	slab_connect(sllg[3], sd12);
-	slab_connect(slrg[0], sd12);
-	slab_connect(slrg[3], sd12);
+	SLAB_LED_EDGE(std, sllg[0]),
+	SLAB_LED_EDGE(sllg[0], sllg[3]),
+	SLAB_LED_EDGE(sllg[0], slrg[0]),
+	SLAB_LED_EDGE(sllg[0], slrg[3]),
 
 	/* Guard glow stage 2 */
-	sd13 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd13, sc);
-	slab_connect(sllg[1], sd13);
-	slab_connect(sllg[2], sd13);
-	slab_connect(slrg[1], sd13);
-	slab_connect(slrg[2], sd13);
-}
+	SLAB_LED_EDGE(std, sllg[1]),
+	SLAB_LED_EDGE(sllg[1], sllg[2]),
+	SLAB_LED_EDGE(sllg[1], slrg[1]),
+	SLAB_LED_EDGE(sllg[1], slrg[2])
+);
 
-static void glow_destructor(void)
+static void glow_constructor(void)
 {
-	light_res_err_t res_err = 0;
-
-	DESTROY_ALL_HIKARI_LIGHT_SLABS;
-
-	slab_destroy(sc);
-	slab_destroy(sg);
-	slab_destroy(st);
-
-	slab_destroy(cb1);
-
-	slab_destroy(sd1);
-	slab_destroy(sd2);
-	slab_destroy(sd3);
-	slab_destroy(sd4);
-	slab_destroy(sd5);
-	slab_destroy(sd6);
-	slab_destroy(sd7);
-	slab_destroy(sd8);
-	slab_destroy(sd9);
-	slab_destroy(sd10);
-	slab_destroy(sd11);
-	slab_destroy(sd12);
-	slab_destroy(sd13);
-
-	res_err = RETURN_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource return err %d", res_err);
+	int err;
+
+	use_all_resources();
+
+	err = slab_graph_start(&graph);
+	if (err) {
+		printk("slab graph start err %d", err);
 		k_oops();
 	}
+
+	static_frame_watch_wake(&watch);
+}
+
+static void glow_destructor(void)
+{
+	slab_graph_stop(&graph);
+
+	return_all_resources();
+}
+
+static void glow_pause(void)
+{
+	slab_graph_pause(&graph);
+
+	return_all_resources();
+}
+
+static void glow_resume(void)
+{
+	use_all_resources();
+
+	slab_graph_resume(&graph);
+
+	static_frame_watch_wake(&watch);
 }
 
  void glow_reset(void)
 {
-	slab_stim(st, slab_event_create(SLAB_EVENT_RESET));
+	slab_stim(SLAB_OF(st), slab_event_create(SLAB_EVENT_RESET));
 }
 
 static struct hikari_light_mode_api glow_api = {
 	.constructor = glow_constructor,
 	.destructor = glow_destructor,
+	.pause = glow_pause,
+	.resume = glow_resume,
 	.tweak_color = NULL,
 	.tweak_intensity = NULL,
 	.tweak_gain = NULL,
@@ -4,6 +4,7 @@
 #include "hikari_light.h"
 
 #include "slab.h"
+#include "slab_graph.h"
 #include "slabs/slab_led.h"
 
 #include "slab_event.h"
@@ -11,119 +12,136 @@
 
 #include "default_resources.h"
 
+/* Slabs */
+SLAB_GRAPH_DEFINE(graph,
+	SLAB_LED_EDGE(slp[0], slp[1]),
+
+	SLAB_LED_EDGE(slc[0], slc[1]),
+	SLAB_LED_EDGE(slc[0], slc[2]),
+	SLAB_LED_EDGE(slc[0], slc[3]),
+	SLAB_LED_EDGE(slc[0], slc[4]),
+	SLAB_LED_EDGE(slc[0], slc[5]),
+
+	SLAB_LED_EDGE(slsq[0], slsq[1]),
+	SLAB_LED_EDGE(slsq[0], slsq[2]),
+	SLAB_LED_EDGE(slsq[0], slsq[3]),
+
+	SLAB_LED_EDGE(slms[0], slms[1]),
+	SLAB_LED_EDGE(slms[0], slms[2]),
+	SLAB_LED_EDGE(slms[0], slms[3]),
+	SLAB_LED_EDGE(slms[0], slms[4]),
+	SLAB_LED_EDGE(slms[0], slms[5]),
+
+	SLAB_LED_EDGE(slts[0], slts[1]),
+
+	SLAB_LED_EDGE(sllb[0], sllb[1]),
+	SLAB_LED_EDGE(sllb[0], sllb[2]),
+	SLAB_LED_EDGE(sllb[0], sllb[3]),
+	SLAB_LED_EDGE(sllb[0], sllb[4]),
+	SLAB_LED_EDGE(sllb[0], sllb[5]),
+
+	SLAB_LED_EDGE(sllt[0], sllt[1]),
+	SLAB_LED_EDGE(sllt[0], sllt[2]),
+	SLAB_LED_EDGE(sllt[0], sllt[3]),
+	SLAB_LED_EDGE(sllt[0], sllt[4]),
+	SLAB_LED_EDGE(sllt[0], sllt[5]),
+	SLAB_LED_EDGE(sllt[0], sllt[6]),
+	SLAB_LED_EDGE(sllt[0], sllt[7]),
+
+	SLAB_LED_EDGE(sllb[0], slrb[1]),
+	SLAB_LED_EDGE(sllb[0], slrb[2]),
+	SLAB_LED_EDGE(sllb[0], slrb[3]),
+	SLAB_LED_EDGE(sllb[0], slrb[4]),
+	SLAB_LED_EDGE(sllb[0], slrb[5]),
+
+	SLAB_LED_EDGE(slrt[0], slrt[1]),
+	SLAB_LED_EDGE(slrt[0], slrt[2]),
+	SLAB_LED_EDGE(slrt[0], slrt[3]),
+	SLAB_LED_EDGE(slrt[0], slrt[4]),
+	SLAB_LED_EDGE(slrt[0], slrt[5]),
+	SLAB_LED_EDGE(slrt[0], slrt[6]),
+	SLAB_LED_EDGE(slrt[0], slrt[7]),
+
+	SLAB_LED_EDGE(sllg[0], sllg[1]),
+	SLAB_LED_EDGE(sllg[0], sllg[2]),
+	SLAB_LED_EDGE(sllg[0], sllg[3]),
+
+	SLAB_LED_EDGE(slrg[0], slrg[1]),
+	SLAB_LED_EDGE(slrg[0], slrg[2]),
+	SLAB_LED_EDGE(slrg[0], slrg[3]),
+
+	SLAB_LED_EDGE(slls[0], slls[1]),
+	SLAB_LED_EDGE(slls[0], slls[2]),
+
+	SLAB_LED_EDGE(slrs[0], slrs[1]),
+	SLAB_LED_EDGE(slrs[0], slrs[2]),
+
+	SLAB_LED_EDGE(slp[0], slc[0]),
+	SLAB_LED_EDGE(slp[0], slsq[0]),
+	SLAB_LED_EDGE(slp[0], slms[0]),
+	SLAB_LED_EDGE(slp[0], slts[0]),
+	SLAB_LED_EDGE(slp[0], sllb[0]),
+	SLAB_LED_EDGE(slp[0], sllt[0]),
+	SLAB_LED_EDGE(slp[0], slrb[0]),
+	SLAB_LED_EDGE(slp[0], slrt[0]),
+	SLAB_LED_EDGE(slp[0], sllg[0]),
+	SLAB_LED_EDGE(slp[0], slrg[0]),
+	SLAB_LED_EDGE(slp[0], slls[0]),
+	SLAB_LED_EDGE(slp[0], slrs[0])
+);
+
 void off_constructor(void)
 {
-	light_res_err_t res_err = 0;
+	int err;
+
+	use_all_resources();
 
-	res_err = USE_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource use err %d", res_err);
+	err = slab_graph_start(&graph);
+	if (err) {
+		printk("slab graph start err %d", err);
 		k_oops();
 	}
 
-	CREATE_ALL_HIKARI_LIGHT_SLABS;
-
-	slab_connect(slp[1], slp[0]);
-
-	slab_connect(slc[1], slc[0]);
-	slab_connect(slc[2], slc[0]);
-	slab_connect(slc[3], slc[0]);
-	slab_connect(slc[4], slc[0]);
-	slab_connect(slc[5], slc[0]);
-
-	slab_connect(slsq[1], slsq[0]);
-	slab_connect(slsq[2], slsq[0]);
-	slab_connect(slsq[3], slsq[0]);
-
-	slab_connect(slms[1], slms[0]);
-	slab_connect(slms[2], slms[0]);
-	slab_connect(slms[3], slms[0]);
-	slab_connect(slms[4], slms[0]);
-	slab_connect(slms[5], slms[0]);
-
-	slab_connect(slts[1], slts[0]);
-
-	slab_connect(sllb[1], sllb[0]);
-	slab_connect(sllb[2], sllb[0]);
-	slab_connect(sllb[3], sllb[0]);
-	slab_connect(sllb[4], sllb[0]);
-	slab_connect(sllb[5], sllb[0]);
-
-	slab_connect(sllt[1], sllt[0]);
-	slab_connect(sllt[2], sllt[0]);
-	slab_connect(sllt[3], sllt[0]);
-	slab_connect(sllt[4], sllt[0]);
-	slab_connect(sllt[5], sllt[0]);
-	slab_connect(sllt[6], sllt[0]);
-	slab_connect(sllt[7], sllt[0]);
-
-	slab_connect(slrb[1], sllb[0]);
-	slab_connect(slrb[2], sllb[0]);
-	slab_connect(slrb[3], sllb[0]);
-	slab_connect(slrb[4], sllb[0]);
-	slab_connect(slrb[5], sllb[0]);
-
-	slab_connect(slrt[1], slrt[0]);
-	slab_connect(slrt[2], slrt[0]);
-	slab_connect(slrt[3], slrt[0]);
-	slab_connect(slrt[4], slrt[0]);
-	slab_connect(slrt[5], slrt[0]);
-	slab_connect(slrt[6], slrt[0]);
-	slab_connect(slrt[7], slrt[0]);
-
-	slab_connect(sllg[1], sllg[0]);
-	slab_connect(sllg[2], sllg[0]);
-	slab_connect(sllg[3], sllg[0]);
-
-	slab_connect(slrg[1], slrg[0]);
-	slab_connect(slrg[2], slrg[0]);
-	slab_connect(slrg[3], slrg[0]);
-
-	slab_connect(slls[1], slls[0]);
-	slab_connect(slls[2], slls[0]);
-
-	slab_connect(slrs[1], slrs[0]);
-	slab_connect(slrs[2], slrs[0]);
-
-	slab_connect(slc[0], slp[0]);
-	slab_connect(slsq[0], slp[0]);
-	slab_connect(slms[0], slp[0]);
-	slab_connect(slts[0], slp[0]);
-	slab_connect(sllb[0], slp[0]);
-	slab_connect(sllt[0], slp[0]);
-	slab_connect(slrb[0], slp[0]);
-	slab_connect(slrt[0], slp[0]);
-	slab_connect(sllg[0], slp[0]);
-	slab_connect(slrg[0], slp[0]);
-	slab_connect(slls[0], slp[0]);
-	slab_connect(slrs[0], slp[0]);
-
 	struct rgb_value rgb_val = {.r = 0, .g = 0, .b = 0};
 	struct slab_event *rgb_evt = slab_event_create(SLAB_EVENT_RGB, rgb_val);
-	slab_stim(slp[0], rgb_evt);
+	slab_stim(SLAB_OF(slp[0]), rgb_evt);
 }
 
 void off_destructor(void)
 {
-	light_res_err_t res_err = 0;
+	slab_graph_stop(&graph);
+
+	return_all_resources();
+}
 
-	DESTROY_ALL_HIKARI_LIGHT_SLABS;
+void off_pause(void)
+{
+	slab_graph_pause(&graph);
 
-	res_err = RETURN_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource return err %d", res_err);
-		k_oops();
-	}
+	return_all_resources();
+}
+
+void off_resume(void)
+{
+	use_all_resources();
+
+	slab_graph_resume(&graph);
+
+	struct rgb_value rgb_val = {.r = 0, .g = 0, .b = 0};
+	struct slab_event *rgb_evt = slab_event_create(SLAB_EVENT_RGB, rgb_val);
+	slab_stim(SLAB_OF(slp[0]), rgb_evt);
 }
 
 void off_reset(void)
 {
-	slab_stim(slp[0], slab_event_create(SLAB_EVENT_RESET));
+	slab_stim(SLAB_OF(slp[0]), slab_event_create(SLAB_EVENT_RESET));
 }
 
 static struct hikari_light_mode_api off_api = {
 	.constructor = off_constructor,
 	.destructor = off_destructor,
+	.pause = off_pause,
+	.resume = off_resume,
 	.tweak_color = NULL,
 	.tweak_intensity = NULL,
 	.tweak_gain = NULL,
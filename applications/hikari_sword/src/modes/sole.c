@@ -4,6 +4,8 @@
 #include "hikari_light.h"
 
 #include "slab.h"
+#include "slab_graph.h"
+#include "slabs/slab_hsv2rgb.h"
 #include "slabs/slab_led.h"
 
 #include "slab_event.h"
@@ -12,120 +14,131 @@
 #include "default_resources.h"
 
 /* Slabs */
-static struct slab *sc;
-
-static struct hsv_value sole_color = {.h = 130, .s = 0.9, .v = 0.3};
+SLAB_HSV2RGB_DEFINE(sc);
+
+SLAB_GRAPH_DEFINE(graph,
+	SLAB_LED_EDGE(slp[0], slp[1]),
+
+	SLAB_LED_EDGE(slc[0], slc[1]),
+	SLAB_LED_EDGE(slc[0], slc[2]),
+	SLAB_LED_EDGE(slc[0], slc[3]),
+	SLAB_LED_EDGE(slc[0], slc[4]),
+	SLAB_LED_EDGE(slc[0], slc[5]),
+
+	SLAB_LED_EDGE(slsq[0], slsq[1]),
+	SLAB_LED_EDGE(slsq[0], slsq[2]),
+	SLAB_LED_EDGE(slsq[0], slsq[3]),
+
+	SLAB_LED_EDGE(slms[0], slms[1]),
+	SLAB_LED_EDGE(slms[0], slms[2]),
+	SLAB_LED_EDGE(slms[0], slms[3]),
+	SLAB_LED_EDGE(slms[0], slms[4]),
+	SLAB_LED_EDGE(slms[0], slms[5]),
+
+	SLAB_LED_EDGE(slts[0], slts[1]),
+
+	SLAB_LED_EDGE(sllb[0], sllb[1]),
+	SLAB_LED_EDGE(sllb[0], sllb[2]),
+	SLAB_LED_EDGE(sllb[0], sllb[3]),
+	SLAB_LED_EDGE(sllb[0], sllb[4]),
+	SLAB_LED_EDGE(sllb[0], sllb[5]),
+
+	SLAB_LED_EDGE(sllt[0], sllt[1]),
+	SLAB_LED_EDGE(sllt[0], sllt[2]),
+	SLAB_LED_EDGE(sllt[0], sllt[3]),
+	SLAB_LED_EDGE(sllt[0], sllt[4]),
+	SLAB_LED_EDGE(sllt[0], sllt[5]),
+	SLAB_LED_EDGE(sllt[0], sllt[6]),
+	SLAB_LED_EDGE(sllt[0], sllt[7]),
+
+	SLAB_LED_EDGE(sllb[0], slrb[1]),
+	SLAB_LED_EDGE(sllb[0], slrb[2]),
+	SLAB_LED_EDGE(sllb[0], slrb[3]),
+	SLAB_LED_EDGE(sllb[0], slrb[4]),
+	SLAB_LED_EDGE(sllb[0], slrb[5]),
+
+	SLAB_LED_EDGE(slrt[0], slrt[1]),
+	SLAB_LED_EDGE(slrt[0], slrt[2]),
+	SLAB_LED_EDGE(slrt[0], slrt[3]),
+	SLAB_LED_EDGE(slrt[0], slrt[4]),
+	SLAB_LED_EDGE(slrt[0], slrt[5]),
+	SLAB_LED_EDGE(slrt[0], slrt[6]),
+	SLAB_LED_EDGE(slrt[0], slrt[7]),
+
+	SLAB_LED_EDGE(sllg[0], sllg[1]),
+	SLAB_LED_EDGE(sllg[0], sllg[2]),
+	SLAB_LED_EDGE(sllg[0], sllg[3]),
+
+	SLAB_LED_EDGE(slrg[0], slrg[1]),
+	SLAB_LED_EDGE(slrg[0], slrg[2]),
+	SLAB_LED_EDGE(slrg[0], slrg[3]),
+
+	SLAB_LED_EDGE(slls[0], slls[1]),
+	SLAB_LED_EDGE(slls[0], slls[2]),
+
+	SLAB_LED_EDGE(slrs[0], slrs[1]),
+	SLAB_LED_EDGE(slrs[0], slrs[2]),
+
+	SLAB_LED_EDGE(sc, slp[0]),
+	SLAB_LED_EDGE(sc, slc[0]),
+	SLAB_LED_EDGE(sc, slsq[0]),
+	SLAB_LED_EDGE(sc, slms[0]),
+	SLAB_LED_EDGE(sc, slts[0]),
+	SLAB_LED_EDGE(sc, sllb[0]),
+	SLAB_LED_EDGE(sc, sllt[0]),
+	SLAB_LED_EDGE(sc, slrb[0]),
+	SLAB_LED_EDGE(sc, slrt[0]),
+	SLAB_LED_EDGE(sc, sllg[0]),
+	SLAB_LED_EDGE(sc, slrg[0]),
+	SLAB_LED_EDGE(sc, slls[0]),
+	SLAB_LED_EDGE(sc, slrs[0])
+);
+
+static struct hsv_value sole_color = {.h = COLOR_NUM(130), .s = COLOR_NUM(0.9), .v = COLOR_NUM(0.3)};
 
 void sole_constructor(void)
 {
-	light_res_err_t res_err = 0;
+	int err;
+
+	use_all_resources();
 
-	res_err = USE_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource use err %d", res_err);
+	err = slab_graph_start(&graph);
+	if (err) {
+		printk("slab graph start err %d", err);
 		k_oops();
 	}
 
-	CREATE_ALL_HIKARI_LIGHT_SLABS;
-
-	sc = slab_create(SLAB_TYPE_HSV2RGB);
-
-	slab_connect(slp[1], slp[0]);
-
-	slab_connect(slc[1], slc[0]);
-	slab_connect(slc[2], slc[0]);
-	slab_connect(slc[3], slc[0]);
-	slab_connect(slc[4], slc[0]);
-	slab_connect(slc[5], slc[0]);
-
-	slab_connect(slsq[1], slsq[0]);
-	slab_connect(slsq[2], slsq[0]);
-	slab_connect(slsq[3], slsq[0]);
-
-	slab_connect(slms[1], slms[0]);
-	slab_connect(slms[2], slms[0]);
-	slab_connect(slms[3], slms[0]);
-	slab_connect(slms[4], slms[0]);
-	slab_connect(slms[5], slms[0]);
-
-	slab_connect(slts[1], slts[0]);
-
-	slab_connect(sllb[1], sllb[0]);
-	slab_connect(sllb[2], sllb[0]);
-	slab_connect(sllb[3], sllb[0]);
-	slab_connect(sllb[4], sllb[0]);
-	slab_connect(sllb[5], sllb[0]);
-
-	slab_connect(sllt[1], sllt[0]);
-	slab_connect(sllt[2], sllt[0]);
-	slab_connect(sllt[3], sllt[0]);
-	slab_connect(sllt[4], sllt[0]);
-	slab_connect(sllt[5], sllt[0]);
-	slab_connect(sllt[6], sllt[0]);
-	slab_connect(sllt[7], sllt[0]);
-
-	slab_connect(slrb[1], sllb[0]);
-	slab_connect(slrb[2], sllb[0]);
-	slab_connect(slrb[3], sllb[0]);
-	slab_connect(slrb[4], sllb[0]);
-	slab_connect(slrb[5], sllb[0]);
-
-	slab_connect(slrt[1], slrt[0]);
-	slab_connect(slrt[2], slrt[0]);
-	slab_connect(slrt[3], slrt[0]);
-	slab_connect(slrt[4], slrt[0]);
-	slab_connect(slrt[5], slrt[0]);
-	slab_connect(slrt[6], slrt[0]);
-	slab_connect(slrt[7], slrt[0]);
-
-	slab_connect(sllg[1], sllg[0]);
-	slab_connect(sllg[2], sllg[0]);
-	slab_connect(sllg[3], sllg[0]);
-
-	slab_connect(slrg[1], slrg[0]);
-	slab_connect(slrg[2], slrg[0]);
-	slab_connect(slrg[3], slrg[0]);
-
-	slab_connect(slls[1], slls[0]);
-	slab_connect(slls[2], slls[0]);
-
-	slab_connect(slrs[1], slrs[0]);
-	slab_connect(slrs[2], slrs[0]);
-
-	slab_connect(slp[0], sc);
-	slab_connect(slc[0], sc);
-	slab_connect(slsq[0], sc);
-	slab_connect(slms[0], sc);
-	slab_connect(slts[0], sc);
-	slab_connect(sllb[0], sc);
-	slab_connect(sllt[0], sc);
-	slab_connect(slrb[0], sc);
-	slab_connect(slrt[0], sc);
-	slab_connect(sllg[0], sc);
-	slab_connect(slrg[0], sc);
-	slab_connect(slls[0], sc);
-	slab_connect(slrs[0], sc);
-
 	struct slab_event *hsv_evt = slab_event_create(SLAB_EVENT_HSV, sole_color);
-	slab_stim(sc, hsv_evt);
+	slab_stim(SLAB_OF(sc), hsv_evt);
 }
 
 void sole_destructor(void)
 {
-	light_res_err_t res_err = 0;
+	slab_graph_stop(&graph);
 
-	DESTROY_ALL_HIKARI_LIGHT_SLABS;
+	return_all_resources();
+}
 
-	res_err = RETURN_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource return err %d", res_err);
-		k_oops();
-	}
+void sole_pause(void)
+{
+	slab_graph_pause(&graph);
+
+	return_all_resources();
+}
+
+void sole_resume(void)
+{
+	use_all_resources();
+
+	slab_graph_resume(&graph);
+
+	struct slab_event *hsv_evt = slab_event_create(SLAB_EVENT_HSV, sole_color);
+	slab_stim(SLAB_OF(sc), hsv_evt);
 }
 
 void sole_reset(void)
 {
-	slab_stim(sc, slab_event_create(SLAB_EVENT_RESET));
+	slab_stim(SLAB_OF(sc), slab_event_create(SLAB_EVENT_RESET));
 }
 
 /* Tweak function implementation could be dropped.
@@ -133,28 +146,30 @@ void sole_reset(void)
 
 void sole_tweak_color(float hue)
 {
-	sole_color.h = hue;
+	sole_color.h = COLOR_NUM_FROM_FLOAT(hue);
 	struct slab_event *hsv_evt = slab_event_create(SLAB_EVENT_HSV, sole_color);
-	slab_stim(sc, hsv_evt);
+	slab_stim(SLAB_OF(sc), hsv_evt);
 }
 
 void sole_tweak_intensity(float saturation)
 {
-	sole_color.s = saturation;
+	sole_color.s = COLOR_NUM_FROM_FLOAT(saturation);
 	struct slab_event *hsv_evt = slab_event_create(SLAB_EVENT_HSV, sole_color);
-	slab_stim(sc, hsv_evt);
+	slab_stim(SLAB_OF(sc), hsv_evt);
 }
 
 void sole_tweak_gain(float value)
 {
-	sole_color.v = value;
+	sole_color.v = COLOR_NUM_FROM_FLOAT(value);
 	struct slab_event *hsv_evt = slab_event_create(SLAB_EVENT_HSV, sole_color);
-	slab_stim(sc, hsv_evt);
+	slab_stim(SLAB_OF(sc), hsv_evt);
 }
 
 static struct hikari_light_mode_api sole_api = {
 	.constructor = sole_constructor,
 	.destructor = sole_destructor,
+	.pause = sole_pause,
+	.resume = sole_resume,
 	.tweak_color = sole_tweak_color,
 	.tweak_intensity = sole_tweak_intensity,
 	.tweak_gain = sole_tweak_gain,
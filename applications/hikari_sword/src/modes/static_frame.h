@@ -0,0 +1,69 @@
+#ifndef STATIC_FRAME_H__
+#define STATIC_FRAME_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rgb_hsv.h"
+#include "slab.h"
+#include "slab_event.h"
+#include "slabs/slab_ticker.h"
+
+#include "../lib/slab/events/slab_event_rgb.h"
+
+/* Watch the source color of a mode for a static frame.
+ *
+ * In a mode whose LEDs all follow one source, directly or through delays,
+ * the frame is static once the source kept its color for longer than the
+ * longest delay. The ticker of the mode is then idled until the mode is
+ * reset or tweaked, so neither the ticker nor the LED update run.
+ *
+ * Connect a notifier with static_frame_watch_cb() and the watch as context
+ * to the slab sending the source color, passing RGB and reset events.
+ */
+struct static_frame_watch {
+	struct slab *ticker;
+	uint32_t num_values;   /* Equal source colors making a static frame */
+	uint32_t num_static;   /* Source colors equal to the last one */
+	struct rgb16_value last;
+};
+
+#define STATIC_FRAME_WATCH_DEFINE(name, _ticker, _longest_delay)                       \
+	static struct static_frame_watch name = {                                      \
+		.ticker = SLAB_OF(_ticker), .num_values = (_longest_delay) + 1         \
+	}
+
+static inline void static_frame_watch_cb(struct slab_event *evt, void *ctx)
+{
+	struct static_frame_watch *watch = ctx;
+	struct rgb16_value rgb;
+
+	if (evt->id != SLAB_EVENT_RGB) {
+		/* A reset restarts the source. */
+		watch->num_static = 0;
+		return;
+	}
+
+	rgb = slab_event_rgb_get_val16(evt);
+	if (memcmp(&rgb, &watch->last, sizeof(rgb)) != 0) {
+		watch->last = rgb;
+		watch->num_static = 0;
+		return;
+	}
+
+	watch->num_static += 1;
+	if (watch->num_static == watch->num_values) {
+		slab_ticker_idle_until(watch->ticker, SLAB_TICKER_IDLE_FOREVER);
+	}
+}
+
+/* Restart watching after the mode changed its slabs directly, and end the
+ * idle time of the ticker. Also call it when the graph is (re)started.
+ */
+static inline void static_frame_watch_wake(struct static_frame_watch *watch)
+{
+	watch->num_static = 0;
+	slab_ticker_wake(watch->ticker);
+}
+
+#endif /* STATIC_FRAME_H__ */
@@ -4,7 +4,11 @@
 #include "hikari_light.h"
 
 #include "slab.h"
+#include "slab_graph.h"
+#include "slabs/slab_ticker.h"
 #include "slabs/slab_waver.h"
+#include "slabs/slab_hsv2rgb.h"
+#include "slabs/slab_delay.h"
 #include "slabs/slab_led.h"
 #include "slabs/slab_notifier.h"
 
@@ -13,27 +17,18 @@
 #include "wave_func.h"
 
 #include "default_resources.h"
+#include "static_frame.h"
+
+/* Source Generator */
+static const struct slab_waver_config sw_config = {
+	.hue = COLOR_NUM(120.0), .sat = COLOR_NUM(0.7),
+	.val = {.T = 1000, .ym = COLOR_NUM(0.3), .yd = COLOR_NUM(0.2) }
+};
 
 /* Slabs */
-static struct slab *st;
-static struct slab *sw;
-static struct slab *sc;
-
-static struct slab *cb1;
-
-static struct slab *sd1;
-static struct slab *sd2;
-static struct slab *sd3;
-static struct slab *sd4;
-static struct slab *sd5;
-static struct slab *sd6;
-static struct slab *sd7;
-static struct slab *sd8;
-static struct slab *sd9;
-static struct slab *sd10;
-static struct slab *sd11;
-static struct slab *sd12;
-static struct slab *sd13;
+SLAB_TICKER_DEFINE(st, 25);
+SLAB_WAVER_DEFINE(sw, &sw_config);
+SLAB_HSV2RGB_DEFINE(sc);
 
 static void print_callback(struct slab_event *evt, void *ctx)
 {
@@ -44,210 +39,190 @@ static void print_callback(struct slab_event *evt, void *ctx)
 	}*/
 }
 
-static void wave_constructor(void)
-{
-	light_res_err_t res_err = 0;
+/* Debug callback */
+SLAB_NOTIFIER_DEFINE(cb1, print_callback, NULL);
 
-	res_err = USE_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource use err %d", res_err);
-		k_oops();
-	}
+/* Delay of each part, in ticks. One tap per part, in the order of the edges below. */
+SLAB_TAPPED_DELAY_DEFINE(std, 100, 80, 20, 60, 100, 20, 40, 60, 80, 100, 20, 40, 20, 20);
 
-	CREATE_ALL_HIKARI_LIGHT_SLABS;
+/* Idle the ticker once the source color settled on every part */
+STATIC_FRAME_WATCH_DEFINE(watch, st, 100);
+SLAB_NOTIFIER_DEFINE(ssw, static_frame_watch_cb, &watch);
 
+SLAB_GRAPH_DEFINE(graph,
 	/* Source Generator */
-	struct slab_waver_config sw_config = {
-		.hue = 120.0, .sat = 0.7,
-		.val = {.T = 1000, .ym = 0.3, .yd = 0.2 }
-	};
-	st = slab_create(SLAB_TYPE_TICKER, K_MSEC(25));
-	sw = slab_create(SLAB_TYPE_WAVER, &sw_config);
-	sc = slab_create(SLAB_TYPE_HSV2RGB);
-	slab_connect(sw, st);
-	slab_connect(sc, sw);
+	SLAB_EDGE(st, sw),
+	SLAB_EDGE(sw, sc),
 
 	/* Debug callback */
-	cb1 = slab_create(SLAB_TYPE_NOTIFIER, print_callback, NULL);
-	slab_connect(cb1, sc);
+	SLAB_EDGE(sc, cb1),
+
+	/* Static frame watch */
+	SLAB_EDGE_MASK(sc, ssw, SLAB_EVENT_MASK(SLAB_EVENT_RGB) | SLAB_EVENT_MASK(SLAB_EVENT_RESET)),
 
 	/* Start wave from core */
-	slab_connect(slc[0], sc);
-	slab_connect(slc[1], slc[0]);
-	slab_connect(slc[2], slc[0]);
-	slab_connect(slc[3], slc[0]);
-	slab_connect(slc[4], slc[0]);
-	slab_connect(slc[5], slc[0]);
+	SLAB_LED_EDGE(sc, slc[0]),
+	SLAB_LED_EDGE(slc[0], slc[1]),
+	SLAB_LED_EDGE(slc[0], slc[2]),
+	SLAB_LED_EDGE(slc[0], slc[3]),
+	SLAB_LED_EDGE(slc[0], slc[4]),
+	SLAB_LED_EDGE(slc[0], slc[5]),
+
+	/* Delayed wave, one tap per part */
+	SLAB_EDGE(sc, std),
 
 	/* Pommel wave */
-	sd1 = slab_create(SLAB_TYPE_DELAY, 80);
-	slab_connect(sd1, sc);
-	slab_connect(slp[0], sd1);
-	slab_connect(slp[1], sd1);
+	SLAB_LED_EDGE(std, slp[0]),
+	SLAB_LED_EDGE(slp[0], slp[1]),
 
 	/* Inner blade wave stage 1 */
-	sd2 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd2, sc);
-	slab_connect(slsq[0], sd2);
-	slab_connect(slsq[1], sd2);
-	slab_connect(slsq[2], sd2);
-	slab_connect(slsq[3], sd2);
+	SLAB_LED_EDGE(std, slsq[0]),
+	SLAB_LED_EDGE(slsq[0], slsq[1]),
+	SLAB_LED_EDGE(slsq[0], slsq[2]),
+	SLAB_LED_EDGE(slsq[0], slsq[3]),
 
 	/* Inner blade wave stage 2 */
-	sd3 = slab_create(SLAB_TYPE_DELAY, 40);
-	slab_connect(sd3, sd2);
-	slab_connect(slms[0], sd3);
-	slab_connect(slms[1], sd3);
-	slab_connect(slms[2], sd3);
-	slab_connect(slms[3], sd3);
-	slab_connect(slms[4], sd3);
-	slab_connect(slms[5], sd3);
+	SLAB_LED_EDGE(std, slms[0]),
+	SLAB_LED_EDGE(slms[0], slms[1]),
+	SLAB_LED_EDGE(slms[0], slms[2]),
+	SLAB_LED_EDGE(slms[0], slms[3]),
+	SLAB_LED_EDGE(slms[0], slms[4]),
+	SLAB_LED_EDGE(slms[0], slms[5]),
 
 	/* Inner blade wave stage 3 */
-	sd4 = slab_create(SLAB_TYPE_DELAY, 40);
-	slab_connect(sd4, sd3);
-	slab_connect(slts[0], sd4);
-	slab_connect(slts[1], sd4);
+	SLAB_LED_EDGE(std, slts[0]),
+	SLAB_LED_EDGE(slts[0], slts[1]),
 
 	/* Outer blade wave stage 1 */
-	sd5 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd5, sc);
-	slab_connect(sllb[0], sd5);
-	slab_connect(sllb[1], sd5);
-	slab_connect(slrb[0], sd5);
-	slab_connect(slrb[1], sd5);
+	SLAB_LED_EDGE(std, sllb[0]),
+	SLAB_LED_EDGE(sllb[0], sllb[1]),
+	SLAB_LED_EDGE(sllb[0], slrb[0]),
+	SLAB_LED_EDGE(sllb[0], slrb[1]),
 
 	/* Outer blade wave stage 2 */
-	sd6 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd6, sd5);
-	slab_connect(sllb[2], sd6);
-	slab_connect(sllb[3], sd6);
-	slab_connect(slrb[2], sd6);
-	slab_connect(slrb[3], sd6);
+	SLAB_LED_EDGE(std, sllb[2]),
+	SLAB_LED_EDGE(sllb[2], sllb[3]),
+	SLAB_LED_EDGE(sllb[2], slrb[2]),
+	SLAB_LED_EDGE(sllb[2], slrb[3]),
 
 	/* Outer blade wave stage 3 */
-	sd7 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd7, sd6);
-	slab_connect(sllb[4], sd7);
-	slab_connect(sllb[5], sd7);
-	slab_connect(slrb[4], sd7);
-	slab_connect(slrb[5], sd7);
+	SLAB_LED_EDGE(std, sllb[4]),
+	SLAB_LED_EDGE(sllb[4], sllb[5]),
+	SLAB_LED_EDGE(sllb[4], slrb[4]),
+	SLAB_LED_EDGE(sllb[4], slrb[5]),
 
 	/* Outer blade wave stage 4 */
-	sd8 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd8, sd7);
-	slab_connect(sllt[2], sd8);
-	slab_connect(sllt[3], sd8);
-	slab_connect(sllt[6], sd8);
-	slab_connect(sllt[7], sd8);
-	slab_connect(slrt[2], sd8);
-	slab_connect(slrt[3], sd8);
-	slab_connect(slrt[6], sd8);
-	slab_connect(slrt[7], sd8);
+	SLAB_LED_EDGE(std, sllt[2]),
+	SLAB_LED_EDGE(sllt[2], sllt[3]),
+	SLAB_LED_EDGE(sllt[2], sllt[6]),
+	SLAB_LED_EDGE(sllt[2], sllt[7]),
+	SLAB_LED_EDGE(sllt[2], slrt[2]),
+	SLAB_LED_EDGE(sllt[2], slrt[3]),
+	SLAB_LED_EDGE(sllt[2], slrt[6]),
+	SLAB_LED_EDGE(sllt[2], slrt[7]),
 
 	/* Outer blade wave stage 5 */
-	sd9 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd9, sd8);
-	slab_connect(sllt[0], sd9);
-	slab_connect(sllt[1], sd9);
-	slab_connect(sllt[4], sd9);
-	slab_connect(sllt[5], sd9);
-	slab_connect(slrt[0], sd9);
-	slab_connect(slrt[1], sd9);
-	slab_connect(slrt[4], sd9);
-	slab_connect(slrt[5], sd9);
+	SLAB_LED_EDGE(std, sllt[0]),
+	SLAB_LED_EDGE(sllt[0], sllt[1]),
+	SLAB_LED_EDGE(sllt[0], sllt[4]),
+	SLAB_LED_EDGE(sllt[0], sllt[5]),
+	SLAB_LED_EDGE(sllt[0], slrt[0]),
+	SLAB_LED_EDGE(sllt[0], slrt[1]),
+	SLAB_LED_EDGE(sllt[0], slrt[4]),
+	SLAB_LED_EDGE(sllt[0], slrt[5]),
 
 	/* Spike wave stage 1 */
-	sd10 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd10, sc);
-	slab_connect(slls[0], sd10);
-	slab_connect(slls[1], sd10);
-	slab_connect(slrs[0], sd10);
-	slab_connect(slrs[1], sd10);
+	SLAB_LED_EDGE(std, slls[0]),
+	SLAB_LED_EDGE(slls[0], slls[1]),
+	SLAB_LED_EDGE(slls[0], slrs[0]),
+	SLAB_LED_EDGE(slls[0], slrs[1]),
 
 	/* Spike wave stage 2 */
-	sd11 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd11, sd10);
-	slab_connect(slls[2], sd11);
-	slab_connect(slrs[2], sd11);
+	SLAB_LED_EDGE(std, slls[2]),
+	SLAB_LED_EDGE(slls[2], slrs[2]),
 
 	/* Guard wave stage 1 */
-	sd12 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd12, sc);
-	slab_connect(sllg[0], sd12);
-	slab_connect(sllg[3], sd12);
-	slab_connect(slrg[0], sd12);
-	slab_connect(slrg[3], sd12);
+	SLAB_LED_EDGE(std, sllg[0]),
+	SLAB_LED_EDGE(sllg[0], sllg[3]),
+	SLAB_LED_EDGE(sllg[0], slrg[0]),
+	SLAB_LED_EDGE(sllg[0], slrg[3]),
 
 	/* Guard wave stage 2 */
-	sd13 = slab_create(SLAB_TYPE_DELAY, 20);
-	slab_connect(sd13, sc);
-	slab_connect(sllg[1], sd13);
-	slab_connect(sllg[2], sd13);
-	slab_connect(slrg[1], sd13);
-	slab_connect(slrg[2], sd13);
-}
+	SLAB_LED_EDGE(std, sllg[1]),
+	SLAB_LED_EDGE(sllg[1], sllg[2]),
+	SLAB_LED_EDGE(sllg[1], slrg[1]),
+	SLAB_LED_EDGE(sllg[1], slrg[2])
+);
 
-static void wave_destructor(void)
+static void wave_constructor(void)
 {
-	light_res_err_t res_err = 0;
-
-	DESTROY_ALL_HIKARI_LIGHT_SLABS;
-
-	slab_destroy(sc);
-	slab_destroy(sw);
-	slab_destroy(st);
-
-	slab_destroy(cb1);
-
-	slab_destroy(sd1);
-	slab_destroy(sd2);
-	slab_destroy(sd3);
-	slab_destroy(sd4);
-	slab_destroy(sd5);
-	slab_destroy(sd6);
-	slab_destroy(sd7);
-	slab_destroy(sd8);
-	slab_destroy(sd9);
-	slab_destroy(sd10);
-	slab_destroy(sd11);
-	slab_destroy(sd12);
-	slab_destroy(sd13);
-
-	res_err = RETURN_ALL_HIKARI_LIGHT_RESOURCES;
-	if (res_err) {
-		printk("resource return err %d", res_err);
+	int err;
+
+	use_all_resources();
+
+	err = slab_graph_start(&graph);
+	if (err) {
+		printk("slab graph start err %d", err);
 		k_oops();
 	}
+
+	static_frame_watch_wake(&watch);
+}
+
+static void wave_destructor(void)
+{
+	slab_graph_stop(&graph);
+
+	return_all_resources();
+}
+
+static void wave_pause(void)
+{
+	slab_graph_pause(&graph);
+
+	return_all_resources();
+}
+
+static void wave_resume(void)
+{
+	use_all_resources();
+
+	slab_graph_resume(&graph);
+
+	static_frame_watch_wake(&watch);
 }
 
 void wave_reset(void)
 {
-	slab_stim(st, slab_event_create(SLAB_EVENT_RESET));
+	slab_stim(SLAB_OF(st), slab_event_create(SLAB_EVENT_RESET));
 }
 
 void wave_tweak_color(float hue)
 {
 	struct slab_waver *s;
 
-	if (sw == NULL || hue > 360.0f || hue < 0.0f) {
+	if (sw.step == NULL || hue > 360.0f || hue < 0.0f) {
 		return;
 	}
 
-	s = (struct slab_waver *)sw;
-	s->data.h = hue;
+	s = &sw;
+	s->data.h = COLOR_NUM_FROM_FLOAT(hue);
+
+	static_frame_watch_wake(&watch);
 }
 
 void wave_tweak_intensity(float saturation)
 {
 	struct slab_waver *s;
 
-	if (sw == NULL || saturation > 1.0f || saturation < 0.0f) {
+	if (sw.step == NULL || saturation > 1.0f || saturation < 0.0f) {
 		return;
 	}
 
-	s = (struct slab_waver *)sw;
-	s->data.s = saturation;
+	s = &sw;
+	s->data.s = COLOR_NUM_FROM_FLOAT(saturation);
+
+	static_frame_watch_wake(&watch);
 }
 
 void wave_tweak_gain(float value)
@@ -255,12 +230,13 @@ void wave_tweak_gain(float value)
 	struct slab_waver *s;
 	struct wave_func *wf;
 	struct wave_func_conf *conf;
+	color_num_t ym;
 
-	if (sw == NULL || value > 1.0f || value < 0.0f) {
+	if (sw.step == NULL || value > 1.0f || value < 0.0f) {
 		return;
 	}
 
-	s = (struct slab_waver *)sw;
+	s = &sw;
 	wf = (struct wave_func *)s->gen;
 
 	if (wf == NULL) {
@@ -268,17 +244,20 @@ void wave_tweak_gain(float value)
 	}
 	conf = &wf->conf;
 
-	if (conf->yd > 1.0f || conf->yd < 0.0f) {
+	if (conf->yd > COLOR_NUM_ONE || conf->yd < 0) {
 		return;
 	}
 
-	float ym_min = 0.0f + conf->yd;
-	float ym_max = 1.0f - conf->yd;
+	color_num_t ym_min = 0 + conf->yd;
+	color_num_t ym_max = COLOR_NUM_ONE - conf->yd;
 
-	value = (value < ym_min) ? ym_min : value;
-	value = (value > ym_max) ? ym_max : value;
+	ym = COLOR_NUM_FROM_FLOAT(value);
+	ym = (ym < ym_min) ? ym_min : ym;
+	ym = (ym > ym_max) ? ym_max : ym;
 
-	conf->ym = value;
+	conf->ym = ym;
+
+	static_frame_watch_wake(&watch);
 }
 
 void wave_tweak_speed(float speed)
@@ -287,11 +266,11 @@ void wave_tweak_speed(float speed)
 	struct wave_func *wf;
 	struct wave_func_conf *conf;
 
-	if (sw == NULL || speed > 1.0f || speed < 0.0f) {
+	if (sw.step == NULL || speed > 1.0f || speed < 0.0f) {
 		return;
 	}
 
-	s = (struct slab_waver *)sw;
+	s = &sw;
 	wf = (struct wave_func *)s->gen;
 
 	if (wf == NULL) {
@@ -302,11 +281,15 @@ void wave_tweak_speed(float speed)
 	uint32_t T_new = 100 + (uint32_t)(1900.0f*speed);
 
 	conf->T = T_new;
+
+	static_frame_watch_wake(&watch);
 }
 
 static struct hikari_light_mode_api wave_api = {
 	.constructor = wave_constructor,
 	.destructor = wave_destructor,
+	.pause = wave_pause,
+	.resume = wave_resume,
 	.tweak_color = wave_tweak_color,
 	.tweak_intensity = wave_tweak_intensity,
 	.tweak_gain = wave_tweak_gain,
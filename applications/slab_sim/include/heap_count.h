@@ -0,0 +1,19 @@
+#ifndef HEAP_COUNT_H__
+#define HEAP_COUNT_H__
+
+#include <stdint.h>
+
+/* Counters of the heap use of the slabs
+ *
+ * k_malloc(), k_calloc() and k_free() are wrapped by the linker to count
+ * the calls. Link with -Wl,--wrap=k_malloc -Wl,--wrap=k_calloc
+ * -Wl,--wrap=k_free to use them, see CMakeLists.txt.
+ */
+
+/* Number of k_malloc() and k_calloc() calls. */
+uint32_t heap_count_allocs(void);
+
+/* Number of k_free() calls with a block to free. */
+uint32_t heap_count_frees(void);
+
+#endif /* HEAP_COUNT_H__ */
@@ -0,0 +1,25 @@
+#ifndef SIM_LIGHT_RESOURCE_H__
+#define SIM_LIGHT_RESOURCE_H__
+
+#include <stdint.h>
+
+#include "light_resource.h"
+
+/* Light resources of the simulated sword
+ *
+ * Implements light_resource.h with one layer of plain buffers instead of
+ * LED chains. The resources have the same ids as on the sword and are
+ * listed in LED chain order. The buffers hold what the LED slabs wrote,
+ * crossfades, correction, power limiting and dithering are not simulated.
+ */
+
+/* Number of resources, one per LED. */
+int sim_light_resource_num(void);
+
+/* Get resource idx, in LED chain order. */
+const struct light_resource *sim_light_resource_get(int idx);
+
+/* Number of times light_resource_changed() was called. */
+uint32_t sim_light_resource_num_changes(void);
+
+#endif /* SIM_LIGHT_RESOURCE_H__ */
@@ -0,0 +1,40 @@
+#include <zephyr/kernel.h>
+
+#include "heap_count.h"
+
+static uint32_t num_allocs;
+static uint32_t num_frees;
+
+void *__real_k_malloc(size_t size);
+void *__real_k_calloc(size_t nmemb, size_t size);
+void __real_k_free(void *ptr);
+
+void *__wrap_k_malloc(size_t size)
+{
+	num_allocs += 1;
+	return __real_k_malloc(size);
+}
+
+void *__wrap_k_calloc(size_t nmemb, size_t size)
+{
+	num_allocs += 1;
+	return __real_k_calloc(nmemb, size);
+}
+
+void __wrap_k_free(void *ptr)
+{
+	if (ptr != NULL) {
+		num_frees += 1;
+	}
+	__real_k_free(ptr);
+}
+
+uint32_t heap_count_allocs(void)
+{
+	return num_allocs;
+}
+
+uint32_t heap_count_frees(void)
+{
+	return num_frees;
+}
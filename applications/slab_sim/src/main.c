@@ -0,0 +1,167 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+#ifdef CONFIG_ARCH_POSIX
+#include <posix_board_if.h>
+#endif
+
+#include "heap_count.h"
+#include "hikari_light.h"
+#include "light_resource.h"
+#include "sim_light_resource.h"
+#include "slab_event.h"
+#include "slab_stats.h"
+#include "slabs/slab_ticker.h"
+
+/* Runs one light mode of the sword application in virtual time.
+ *
+ * The mode graph is started as on the sword, but its tickers are driven by
+ * slab_clock_advance() instead of a timer, so every run sends the same ticks.
+ * After every frame period the LED buffers are printed as one CSV line:
+ *
+ *	frame,time_ms,<id>.0,<id>.1,<id>.2,...
+ *
+ * with the integer part of the three channels of every LED in LED chain
+ * order, as written by the LED slabs of the mode. The output stage of the
+ * sword is not simulated, so crossfades, gamma correction, power limiting
+ * and dithering are not part of the values. A summary follows as lines
+ * starting with '#'.
+ */
+
+#define NUM_FRAMES (CONFIG_SLAB_SIM_DURATION_MS / CONFIG_SLAB_SIM_FRAME_PERIOD_MS)
+#define PERIODS_PER_FRAME (CONFIG_SLAB_SIM_FRAME_PERIOD_MS / CONFIG_SLAB_CLOCK_PERIOD_MS)
+#define SIM_DURATION_MS (NUM_FRAMES * CONFIG_SLAB_SIM_FRAME_PERIOD_MS)
+
+BUILD_ASSERT(PERIODS_PER_FRAME > 0, "Frame period shorter than the slab clock period");
+
+static const char *const event_names[] = {
+	[SLAB_EVENT_RESET] = "RESET",
+	[SLAB_EVENT_TICK] = "TICK",
+	[SLAB_EVENT_RGB] = "RGB",
+	[SLAB_EVENT_HSV] = "HSV",
+	[SLAB_EVENT_RGB_FRAME] = "RGB_FRAME",
+	[SLAB_EVENT_HSV_FRAME] = "HSV_FRAME",
+};
+
+/*==================================[Output]==================================*/
+/* Lines are printed field by field, a header line of all LEDs is longer
+ * than any buffer worth keeping for it.
+ */
+static void print_header(void)
+{
+	printk("frame,time_ms");
+
+	for (int i = 0; i < sim_light_resource_num(); i++) {
+		const char *id = sim_light_resource_get(i)->id;
+
+		printk(",%s.0,%s.1,%s.2", id, id, id);
+	}
+
+	printk("\n");
+}
+
+static void print_frame(uint32_t frame, uint32_t time_ms)
+{
+	printk("%u,%u", frame, time_ms);
+
+	for (int i = 0; i < sim_light_resource_num(); i++) {
+		const uint16_t *data = (const uint16_t *)sim_light_resource_get(i)->data;
+
+		printk(",%u,%u,%u", data[0] >> 8, data[1] >> 8, data[2] >> 8);
+	}
+
+	printk("\n");
+}
+
+static bool sum_slab(const struct slab_stats_snapshot *snapshot, void *user_data)
+{
+	struct slab_stats_snapshot *sum = user_data;
+
+	sum->num_stims += snapshot->num_stims;
+	sum->num_emitted += snapshot->num_emitted;
+
+	return true;
+}
+
+static uint32_t per_second(uint32_t count)
+{
+	return (uint32_t)(((uint64_t)count * 1000) / SIM_DURATION_MS);
+}
+
+static void print_summary(uint32_t num_changes, uint32_t sim_allocs, uint32_t sim_frees)
+{
+	struct slab_stats_snapshot sum = {0};
+	struct slab_ticker_stats ticker_stats;
+	struct slab_event_pool_stats pool_stats;
+
+	slab_stats_foreach(sum_slab, &sum);
+	slab_ticker_stats_get(&ticker_stats);
+
+	printk("# mode %d, simulated %u ms, %u frames\n", CONFIG_SLAB_SIM_MODE, SIM_DURATION_MS,
+	       NUM_FRAMES);
+	printk("# per simulated second: %u stims, %u emitted, %u LED writes\n",
+	       per_second(sum.num_stims), per_second(sum.num_emitted), per_second(num_changes));
+	printk("# per simulated second: %u allocations, %u frees\n", per_second(sim_allocs),
+	       per_second(sim_frees));
+	printk("# ticks dropped: %u\n", ticker_stats.num_dropped);
+
+	for (int id = SLAB_EVENT_RESET; id < ARRAY_SIZE(event_names); id++) {
+		slab_event_pool_stats_get(id, &pool_stats);
+		printk("# event pool %s: %u of %u used at most, %u exhausted\n", event_names[id],
+		       pool_stats.max_used, pool_stats.num_blocks, pool_stats.num_exhausted);
+	}
+}
+
+/*===================================[Main]===================================*/
+static const struct hikari_light_mode_api *find_mode(enum hikari_light_mode mode)
+{
+	STRUCT_SECTION_FOREACH(hikari_light_mode_entry, entry) {
+		if (entry->mode == mode) {
+			return entry->api;
+		}
+	}
+
+	return NULL;
+}
+
+int main(void)
+{
+	const struct hikari_light_mode_api *api = find_mode(CONFIG_SLAB_SIM_MODE);
+	uint32_t setup_allocs;
+	uint32_t setup_frees;
+	uint32_t setup_changes;
+
+	if (api == NULL) {
+		printk("# mode %d not found\n", CONFIG_SLAB_SIM_MODE);
+		return 0;
+	}
+
+	light_resource_init();
+
+	api->constructor();
+
+	/* Count from the first frame on, without the setup of the mode. */
+	setup_allocs = heap_count_allocs();
+	setup_frees = heap_count_frees();
+	setup_changes = sim_light_resource_num_changes();
+	slab_stats_reset();
+	slab_ticker_stats_reset();
+
+	print_header();
+
+	for (uint32_t frame = 0; frame < NUM_FRAMES; frame++) {
+		slab_clock_advance(PERIODS_PER_FRAME);
+		print_frame(frame, (frame + 1) * CONFIG_SLAB_SIM_FRAME_PERIOD_MS);
+	}
+
+	print_summary(sim_light_resource_num_changes() - setup_changes,
+		      heap_count_allocs() - setup_allocs, heap_count_frees() - setup_frees);
+
+	api->destructor();
+
+	printk("# done\n");
+
+#ifdef CONFIG_ARCH_POSIX
+	posix_exit(0);
+#endif
+	return 0;
+}
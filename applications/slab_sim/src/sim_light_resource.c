@@ -0,0 +1,130 @@
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "adrledrgb.h"
+#include "light_resource.h"
+#include "rgb_hsv.h"
+#include "sim_light_resource.h"
+#include "slabs/slab_led.h"
+#include "sword_leds.h"
+
+#define LED_ID(_id, _chain, _idx) _id,
+
+/* Ids of all LEDs of the sword, in LED chain order */
+static char *const ids[] = {SWORD_LEDS(LED_ID)};
+
+#define NUM_RESOURCES ARRAY_SIZE(ids)
+
+static struct rgb16_value leds[NUM_RESOURCES];
+static struct light_resource resources[NUM_RESOURCES];
+static uint32_t num_changes;
+static bool is_initialized;
+
+static void led_written(void *led_buf)
+{
+	ARG_UNUSED(led_buf);
+
+	light_resource_changed();
+}
+
+/*==============================[Public methods]==============================*/
+void light_resource_init(void)
+{
+	if (is_initialized) {
+		return;
+	}
+	is_initialized = true;
+
+	for (int i = 0; i < NUM_RESOURCES; i++) {
+		resources[i].id = ids[i];
+		resources[i].data = (uint8_t *)&leds[i];
+		resources[i].data_size = sizeof(struct rgb16_value);
+		resources[i].layer = 0;
+		resources[i].used = false;
+	}
+
+	slab_led_written_cb_set(led_written);
+}
+
+light_res_err_t light_resource_use(char *id, struct light_resource **res)
+{
+	*res = NULL;
+
+	if (!is_initialized) {
+		return LIGHT_RESOURCE_NOT_INITIALIZED;
+	}
+
+	for (int i = 0; i < NUM_RESOURCES; i++) {
+		if (strcmp(resources[i].id, id)) {
+			continue;
+		}
+
+		if (resources[i].used) {
+			return LIGHT_RESOURCE_ALLREADY_USED;
+		}
+
+		resources[i].used = true;
+		*res = &resources[i];
+		return LIGHT_RESOURCE_SUCCESS;
+	}
+
+	return LIGHT_RESOURCE_NOT_FOUND;
+}
+
+light_res_err_t light_resource_return(struct light_resource *res)
+{
+	for (int i = 0; i < NUM_RESOURCES; i++) {
+		if (res == &resources[i]) {
+			res->used = false;
+			return LIGHT_RESOURCE_SUCCESS;
+		}
+	}
+
+	return LIGHT_RESOURCE_NOT_FOUND;
+}
+
+void light_resource_crossfade(uint32_t duration_ms)
+{
+	ARG_UNUSED(duration_ms);
+}
+
+void light_resource_correction_set(const struct gamma_config *config)
+{
+	ARG_UNUSED(config);
+}
+
+void light_resource_brightness_set(uint8_t brightness)
+{
+	ARG_UNUSED(brightness);
+}
+
+void light_resource_power_budget_set(uint32_t budget_ma)
+{
+	ARG_UNUSED(budget_ma);
+}
+
+uint32_t light_resource_power_estimate_get(void)
+{
+	return 0;
+}
+
+void light_resource_changed(void)
+{
+	num_changes += 1;
+}
+
+int sim_light_resource_num(void)
+{
+	return NUM_RESOURCES;
+}
+
+const struct light_resource *sim_light_resource_get(int idx)
+{
+	return &resources[idx];
+}
+
+uint32_t sim_light_resource_num_changes(void)
+{
+	return num_changes;
+}
@@ -0,0 +1,33 @@
+#ifndef DITHER_H__
+#define DITHER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rgb_hsv.h"
+
+/* Fraction of each channel not shown yet, carried to the next frame */
+struct dither_error {
+	uint8_t r;
+	uint8_t g;
+	uint8_t b;
+};
+
+/* Reduce one channel to 8 bit and keep the remainder in error.
+ * Over frames the shown values average to the 16 bit value.
+ */
+static inline uint8_t dither_channel(uint16_t value, uint8_t *error)
+{
+	uint32_t sum = value + *error;
+
+	*error = sum & 0xff;
+	return sum >> 8;
+}
+
+/* Reduce a frame of n pixels to 8 bit. error holds one entry per pixel
+ * and must be kept between frames, zero it to start.
+ */
+void dither_frame(const struct rgb16_value *in, struct dither_error *error,
+		  struct rgb_value *out, size_t n);
+
+#endif /* DITHER_H__ */
@@ -0,0 +1,77 @@
+#ifndef GAMMA_LUT_H__
+#define GAMMA_LUT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rgb_hsv.h"
+
+struct gamma_config {
+	float gamma;        /* Exponent of the curve, 1.0 for linear */
+	uint8_t brightness; /* Scale of all channels [0,255] */
+	uint8_t balance[3]; /* Scale of red, green and blue [0,255], for white balance */
+};
+
+#define GAMMA_CONFIG_LINEAR {.gamma = 1.0f, .brightness = 255, .balance = {255, 255, 255}}
+
+/* Output value of every input value, per channel, with 8 fractional bits
+ * so the fraction can be dithered at the output, see dither.h.
+ */
+struct gamma_lut {
+	uint16_t r[256];
+	uint16_t g[256];
+	uint16_t b[256];
+};
+
+/* Round a table entry to 8 bit */
+#define GAMMA_LUT_TO_U8(x) ((uint8_t)(((x) + 0x80) >> 8))
+
+/* Fill the tables for a configuration.
+ *
+ * Uses floats, so only call it when the configuration changes.
+ */
+void gamma_lut_build(struct gamma_lut *lut, const struct gamma_config *config);
+
+static inline struct rgb_value gamma_lut_apply(const struct gamma_lut *lut, struct rgb_value val)
+{
+	struct rgb_value out = {
+		.r = GAMMA_LUT_TO_U8(lut->r[val.r]),
+		.g = GAMMA_LUT_TO_U8(lut->g[val.g]),
+		.b = GAMMA_LUT_TO_U8(lut->b[val.b]),
+	};
+
+	return out;
+}
+
+/* Look up a channel value with 8 fractional bits, interpolating between
+ * the two entries around it, so the fraction is kept.
+ */
+static inline uint16_t gamma_lut_lookup16(const uint16_t *table, uint16_t val)
+{
+	uint32_t i = val >> 8;
+	uint32_t frac = val & 0xff;
+
+	if (i >= 255) {
+		return table[255];
+	}
+
+	return table[i] + (((uint32_t)(table[i + 1] - table[i]) * frac) >> 8);
+}
+
+static inline struct rgb16_value gamma_lut_apply16(const struct gamma_lut *lut,
+						   struct rgb16_value val)
+{
+	struct rgb16_value out = {
+		.r = gamma_lut_lookup16(lut->r, val.r),
+		.g = gamma_lut_lookup16(lut->g, val.g),
+		.b = gamma_lut_lookup16(lut->b, val.b),
+	};
+
+	return out;
+}
+
+/* Apply the tables to n pixels, rounded to 8 bit. in and out may be the same array. */
+void gamma_lut_apply_batch(const struct gamma_lut *lut, const struct rgb_value *in,
+			   struct rgb_value *out, size_t n);
+
+#endif /* GAMMA_LUT_H__ */
@@ -3,23 +3,25 @@
 
 #include <stdint.h>
 
+#include "rgb_hsv.h"
+
 /*
 	ym = 0.5 * (yh + yl);
 	yd = yh - yl;
 */
 
 struct glow_func_conf {
-	float a;  /* Time constant */
-	float b;  /* Gain constant */
-	float ym; /* Middle value of window */
-	float yd; /* Width of window */
+	color_num_t a;  /* Time constant */
+	color_num_t b;  /* Gain constant */
+	color_num_t ym; /* Middle value of window */
+	color_num_t yd; /* Width of window */
 };
 
 struct glow_func {
 	struct glow_func_conf conf;
 
 	/* States */
-	float y1; /* First state, usually holds the previous value */
+	color_num_t y1; /* First state, usually holds the previous value */
 	uint32_t t1; /* Time of previous calculation (milliseconds) */
 };
 
@@ -34,6 +36,6 @@ void glow_func_reset(struct glow_func *gf, const struct glow_func_conf *config);
  *
  * Return Glow function output value y
  */
-float glow_func_process(struct glow_func *gf, uint32_t t, float w);
+color_num_t glow_func_process(struct glow_func *gf, uint32_t t, color_num_t w);
 
 #endif /* GLOW_FUNCTION_H__ */
@@ -1,22 +1,118 @@
 #ifndef RGB_HSV_H__
 #define RGB_HSV_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
+/* Number type of HSV values and of the glow and wave functions.
+ *
+ * With CONFIG_COLOR_FIXED_POINT the numbers are signed Q16.16 fixed point,
+ * so the color pipeline needs no FPU. Otherwise they are floats.
+ *
+ * Use the COLOR_NUM macros for constants, conversions and arithmetic,
+ * so code builds for both number types:
+ *	COLOR_NUM(x)            Constant expression from a literal, like 0.5
+ *	COLOR_NUM_FROM_INT(i)   From an integer
+ *	COLOR_NUM_FROM_FLOAT(f) From a float, for values given at runtime
+ *	COLOR_NUM_TO_INT(n)     To an integer, rounded towards minus infinity
+ *	                        for fixed point, towards zero for floats
+ *	COLOR_NUM_TO_FLOAT(n)   To a float
+ *	COLOR_NUM_MUL(a, b)     a * b
+ *	COLOR_NUM_DIV(a, b)     a / b
+ * Addition, subtraction, comparison and multiplication or division by an
+ * integer use the normal operators.
+ *
+ * Fixed point values are within 2^-16 of the float value. Conversions
+ * between HSV and RGB give the same RGB values as the float reference,
+ * or values 1 apart.
+ */
+#ifdef CONFIG_COLOR_FIXED_POINT
+
+typedef int32_t color_num_t;
+
+#define COLOR_NUM_FRAC_BITS 16
+#define COLOR_NUM_ONE       ((color_num_t)1 << COLOR_NUM_FRAC_BITS)
+
+#define COLOR_NUM(x) ((color_num_t)((x) * COLOR_NUM_ONE + (((x) < 0) ? -0.5 : 0.5)))
+#define COLOR_NUM_FROM_INT(i) ((color_num_t)((i) * COLOR_NUM_ONE))
+#define COLOR_NUM_FROM_FLOAT(f) COLOR_NUM((float)(f))
+#define COLOR_NUM_TO_INT(n) ((int32_t)((n) >> COLOR_NUM_FRAC_BITS))
+#define COLOR_NUM_TO_FLOAT(n) ((float)(n) / COLOR_NUM_ONE)
+#define COLOR_NUM_MUL(a, b) ((color_num_t)(((int64_t)(a) * (b)) >> COLOR_NUM_FRAC_BITS))
+#define COLOR_NUM_DIV(a, b) ((color_num_t)((int64_t)(a) * COLOR_NUM_ONE / (b)))
+
+#else
+
+typedef float color_num_t;
+
+#define COLOR_NUM_ONE 1.0f
+
+#define COLOR_NUM(x) ((color_num_t)(x))
+#define COLOR_NUM_FROM_INT(i) ((color_num_t)(i))
+#define COLOR_NUM_FROM_FLOAT(f) ((color_num_t)(f))
+#define COLOR_NUM_TO_INT(n) ((int32_t)(n))
+#define COLOR_NUM_TO_FLOAT(n) ((float)(n))
+#define COLOR_NUM_MUL(a, b) ((a) * (b))
+#define COLOR_NUM_DIV(a, b) ((a) / (b))
+
+#endif /* CONFIG_COLOR_FIXED_POINT */
+
 struct rgb_value {
 	uint8_t r;
 	uint8_t g;
 	uint8_t b;
 };
 
+/* RGB value with 8 fractional bits per channel, [0,255 << 8].
+ * The fraction is shown over several frames by dithering, see dither.h.
+ */
+struct rgb16_value {
+	uint16_t r;
+	uint16_t g;
+	uint16_t b;
+};
+
 struct hsv_value {
-	float h; // [0,360]
-	float s; // [0,1]
-	float v; // [0,1]
+	color_num_t h; // [0,360]
+	color_num_t s; // [0,1]
+	color_num_t v; // [0,1]
+};
+
+/* HSV value in 8 bit integers, for integer only conversions.
+ * Hue is in 1/256 of a 60 degree sector, so it goes from 0 to
+ * HSV_INT_HUE_MAX, and wraps around above.
+ */
+#define HSV_INT_HUE_MAX 1536
+
+struct hsv_int_value {
+	uint16_t h; // [0,HSV_INT_HUE_MAX)
+	uint8_t s;  // [0,255]
+	uint8_t v;  // [0,255]
 };
 
 struct rgb_value hsv2rgb(const struct hsv_value val);
 
+/* Convert keeping 8 fractional bits per channel. The integer part is the
+ * value given by hsv2rgb(), so dim colors keep the fraction it drops.
+ */
+struct rgb16_value hsv2rgb16(const struct hsv_value val);
+
 struct hsv_value rgb2hsv(const struct rgb_value val);
 
+/* Convert n pixels, giving the same values as converting them one by one.
+ * Use for frames, the per pixel work is inlined into one loop.
+ */
+void hsv2rgb_batch(const struct hsv_value *in, struct rgb_value *out, size_t n);
+
+void rgb2hsv_batch(const struct rgb_value *in, struct hsv_value *out, size_t n);
+
+/* Convert n pixels with integer math and lookup tables only.
+ *
+ * RGB values are within 2 of hsv2rgb() for the same color. Unlike
+ * rgb2hsv(), saturation and value are scaled to [0,255].
+ */
+void hsv2rgb_int_batch(const struct hsv_int_value *in, struct rgb_value *out, size_t n);
+
+void rgb2hsv_int_batch(const struct rgb_value *in, struct hsv_int_value *out, size_t n);
+
 #endif /* RGB_HSV_H__ */
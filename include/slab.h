@@ -1,8 +1,10 @@
 #ifndef SLAB_H__
 #define SLAB_H__
 
+#include <stdarg.h>
 #include <stdint.h>
 #include <zephyr/sys/dlist.h>
+#include <zephyr/sys/iterable_sections.h>
 
 #include "slab_event.h"
 
@@ -18,11 +20,102 @@ enum slab_type {
 	SLAB_TYPE_HSV2RGB,
 	SLAB_TYPE_RGB2HSV,
 	SLAB_TYPE_NOTIFIER,
+	SLAB_TYPE_LED_STRIP,
+	SLAB_TYPE_TAPPED_DELAY,
+	SLAB_TYPE_GAMMA,
+	SLAB_TYPE_MIXER,
+	SLAB_TYPE_MIXER_PORT,
+
+	/* First id free for slab types defined outside of this library */
+	SLAB_TYPE_CUSTOM = 0x100,
+};
+
+struct slab;
+struct slab_graph_step;
+
+/* Operations implementing one slab type.
+ *
+ * create:  Allocate and set up the type specific part of a slab from the
+ *          extra arguments given to slab_create(). Return NULL on failure.
+ * destroy: Free everything allocated by create, including the slab itself.
+ * stim:    Process an event. Takes over the reference held on the event,
+ *          so it must either forward it with slab_stim_childs() or
+ *          release it with slab_event_release().
+ * init:    Optional. Prepare a statically defined slab when its graph is
+ *          started, see SLAB_GRAPH_DEFINE().
+ * deinit:  Optional. Stop a statically defined slab when its graph is
+ *          stopped and drop everything it holds, without freeing the slab.
+ */
+struct slab_type_api {
+	enum slab_type type;
+	struct slab *(*create)(va_list *args);
+	void (*destroy)(struct slab *slab);
+	void (*stim)(struct slab *slab, struct slab_event *evt);
+	void (*init)(struct slab *slab);
+	void (*deinit)(struct slab *slab);
+};
+
+/* Register a slab type so it can be created with slab_create().
+ *
+ * The first member of the type specific slab struct must be the common
+ * part of struct slab. Applications may register their own types with
+ * ids starting at SLAB_TYPE_CUSTOM.
+ */
+#define SLAB_TYPE_DEFINE(name, _type, _create, _destroy, _stim, _init, _deinit) \
+	const STRUCT_SECTION_ITERABLE(slab_type_api, name) = { \
+		.type = _type, .create = _create, .destroy = _destroy, .stim = _stim, \
+		.init = _init, .deinit = _deinit \
+	}
+
+/* Make a slab type defined in another file usable in static slab definitions. */
+#define SLAB_TYPE_DECLARE(name) extern const struct slab_type_api name
+
+/* Initializer for the common part of a statically defined slab.
+ *
+ * The slab starts without childs. Statically defined slabs get their childs
+ * from the static graph they are part of, see SLAB_GRAPH_DEFINE().
+ */
+#define SLAB_STATIC_INITIALIZER(_type, _api) \
+	.childs = {.list = NULL, .masks = NULL, .num = 0, .cap = 0}, .type = _type, .api = &(_api), .step = NULL
+
+/* Get a statically defined slab as a generic slab pointer. */
+#define SLAB_OF(_static_slab) ((struct slab *)&(_static_slab))
+
+/* Set of childs of a slab, kept in connection order.
+ *
+ * The first CONFIG_SLAB_INLINE_CHILDS childs are stored inside the slab.
+ * Beyond that the set moves to a heap allocated array that grows by
+ * doubling. list points at whichever array is in use. A zeroed set with
+ * no list is empty and switches to the inline array on first use.
+ *
+ * masks[i] holds the events passed on to list[i], and lives next to
+ * whichever list is in use.
+ */
+struct slab_childs {
+	struct slab **list;
+	slab_event_mask_t *masks;
+	uint16_t num;
+	uint16_t cap;
+	struct slab *inline_list[CONFIG_SLAB_INLINE_CHILDS];
+	slab_event_mask_t inline_masks[CONFIG_SLAB_INLINE_CHILDS];
+};
+
+/* Runtime counters of a slab, see slab_stats.h. */
+struct slab_stats {
+	sys_dnode_t node;     /* Entry in the list of slabs that processed events */
+	uint32_t num_stims;   /* Events processed */
+	uint32_t num_emitted; /* Events sent to the childs */
+	uint64_t cycles;      /* Cycles spent processing events, excluding the childs */
 };
 
 struct slab {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step; /* Set while the slab is part of a compiled graph */
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 };
 
 /* Call to dynamically allocate and initialize slabs of different types.
@@ -31,8 +124,13 @@ struct slab {
  * List of extra arguments:
  * SLAB_TYPE_LED:      void *led_buf, enum led_type type
  *
+ * SLAB_TYPE_LED_STRIP: void *led_buf, uint32_t first_pixel, uint32_t num_leds,
+ *                      enum led_type type
+ *
  * SLAB_TYPE_DELAY:    uint32_t delay_periods
  *
+ * SLAB_TYPE_TAPPED_DELAY: const uint16_t *taps, uint32_t num_taps
+ *
  * SLAB_TYPE_TICKER:   k_timeout_t tick_period
  *
  * SLAB_TYPE_GLOWER:   struct slab_glower_config *config
@@ -52,8 +150,16 @@ struct slab {
  *
  * SLAB_TYPE_RGB2HSV: No extra arguments
  *
+ * SLAB_TYPE_GAMMA:   const struct gamma_config *config
+ *
+ * SLAB_TYPE_MIXER:   enum slab_mixer_mode mode, uint32_t num_ports
+ *     The ports are taken with slab_mixer_port(), see slab_mixer.h.
+ *
  * SLAB_TYPE_NOTIFIER: slab_notifier_cb subscriber, void *context
  *     typedef void (*slab_notifier_cb)(struct slab_event *evt, void *ctx)
+ *
+ * Types registered with SLAB_TYPE_DEFINE() define their own extra arguments.
+ * NULL is returned if no slab type with the given id is registered.
  */
 struct slab *slab_create(enum slab_type type, ...);
 void slab_destroy(struct slab *slab);
@@ -63,9 +169,25 @@ void slab_destroy(struct slab *slab);
  *
  * Multiple slabs can be connected to the output of another slab.
  * A slab can be connected to multiple slabs.
+ *
+ * Slabs that are part of a compiled graph can not be connected or
+ * disconnected. Release the graph with slab_graph_release() first.
  */
 void slab_connect(struct slab *slab, struct slab *connect_to);
 
+/* Connect slab to the output of another slab for some events only.
+ *
+ * Only events whose id is set in mask are sent to the slab, all other
+ * events sent or forwarded by the parent slab skip it. Build the mask
+ * with SLAB_EVENT_MASK(), for example to connect an LED that only
+ * consumes colors:
+ *	slab_connect_mask(led, hsv2rgb, SLAB_EVENT_MASK(SLAB_EVENT_RGB));
+ *
+ * slab_connect() is the same as passing SLAB_EVENT_MASK_ALL. Connecting
+ * a slab that is already connected replaces the mask of the connection.
+ */
+void slab_connect_mask(struct slab *slab, struct slab *connect_to, slab_event_mask_t mask);
+
 /* Disconnect a slab from the output of another slab.
  *
  * This will do nothing if the slab is not connected the the parent slab.
@@ -76,6 +198,9 @@ void slab_disconnect(struct slab *slab, struct slab *disconnect_from);
  *
  * The slab will process the event, possibly sending one or more events
  * to the connected child slabs.
+ *
+ * If the slab is part of a compiled graph, the event is queued on the
+ * slab and the graph is evaluated iteratively, see slab_graph.h.
  */
 void slab_stim(struct slab *slab, struct slab_event *evt);
 
@@ -87,7 +212,18 @@ void slab_stim(struct slab *slab, struct slab_event *evt);
   * calling this function. If slab_event_acquire() is not called
   * prior to this, the event will be destroyed at the end of
   * this function.
+  *
+  * Childs connected with a mask that does not contain the event id
+  * are skipped, see slab_connect_mask().
   */
 void slab_stim_childs(struct slab *slab, struct slab_event *evt);
 
+/* Send an event to one child slab of a slab, the idx-th in connection order.
+ *
+ * For slabs sending different events to different childs. The reference
+ * rules of slab_stim_childs() apply. The event is released if the slab
+ * has no such child or the connection to it does not pass the event.
+ */
+void slab_stim_child(struct slab *slab, uint16_t idx, struct slab_event *evt);
+
 #endif /* SLAB_H__ */
@@ -3,18 +3,38 @@
 
 #include <stdint.h>
 
+#include "rgb_hsv.h"
+
 enum slab_event_id {
 	SLAB_EVENT_RESET = 1,
 	SLAB_EVENT_TICK,
 	SLAB_EVENT_RGB,
 	SLAB_EVENT_HSV,
+	SLAB_EVENT_RGB_FRAME,
+	SLAB_EVENT_HSV_FRAME,
 };
 
+/* Set of event ids, one bit per id. Used on edges between slabs to only
+ * pass on the events the child slab consumes, see slab_connect_mask().
+ */
+typedef uint16_t slab_event_mask_t;
+
+#define SLAB_EVENT_MASK(_id) ((slab_event_mask_t)(1U << (_id)))
+#define SLAB_EVENT_MASK_ALL  ((slab_event_mask_t)UINT16_MAX)
+
 struct slab_event {
 	enum slab_event_id id;
 	int num_refs;
 };
 
+/* Usage statistics of the fixed size block pool backing one event type. */
+struct slab_event_pool_stats {
+	uint32_t num_blocks;    /* Number of blocks in the pool */
+	uint32_t num_used;      /* Number of blocks currently in use */
+	uint32_t max_used;      /* High-water mark of blocks in use */
+	uint32_t num_exhausted; /* Number of creations that failed on an empty pool */
+};
+
 /* Call to create events of different types. Based on the types, the
  * events takes extra arguments at creation.
  *
@@ -23,9 +43,30 @@ struct slab_event {
  * SLAB_EVENT_TICK:   uint32_t time
  * SLAB_EVENT_RGB:    struct rgb_value val
  * SLAB_EVENT_HSV:    struct hsv_value val
+ * SLAB_EVENT_RGB_FRAME: const struct rgb_value *pixels, uint32_t num_pixels
+ * SLAB_EVENT_HSV_FRAME: const struct hsv_value *pixels, uint32_t num_pixels
+ *
+ * Frame events carry a whole strip segment in one event. The pixel array
+ * is borrowed from the creator of the event and is only guaranteed to be
+ * valid until the creator emits its next frame. Slabs that keep frames
+ * for longer, like delays, must copy the pixels.
+ *
+ * Events are taken from a fixed size pool per event type, sized by
+ * CONFIG_SLAB_EVENT_POOL_<TYPE>_BLOCKS. Creation takes constant time and
+ * never touches the system heap. NULL is returned if the pool is exhausted.
+ * Slabs silently drop NULL events, so an exhausted pool shows up as
+ * missing frames and in slab_event_pool_stats_get(), not as a crash.
  */
 struct slab_event *slab_event_create(enum slab_event_id event_id, ...);
 
+/* Create an RGB event keeping 8 fractional bits per channel.
+ *
+ * Slabs converting or delaying RGB events pass the fraction on, so the
+ * LED output can dither it. Slabs reading the value as struct rgb_value
+ * see the integer part.
+ */
+struct slab_event *slab_event_create_rgb16(struct rgb16_value val);
+
 /* Call on an event to destroy it.
  *
  * NOTE: Events passed to a slab will automatically be destroyed
@@ -56,4 +97,15 @@ void slab_event_acquire(struct slab_event *evt);
  */
 void slab_event_release(struct slab_event *evt);
 
+/* Get usage statistics of the event pool for an event type.
+ *
+ * Returns 0 on success or -EINVAL if the event type has no pool.
+ */
+int slab_event_pool_stats_get(enum slab_event_id event_id, struct slab_event_pool_stats *stats);
+
+/* Reset high-water marks to the current usage and clear exhaustion counts
+ * of all event pools.
+ */
+void slab_event_pool_stats_reset(void);
+
 #endif /* SLAB_EVENT_H__ */
@@ -0,0 +1,54 @@
+#ifndef SLAB_FRAME_H__
+#define SLAB_FRAME_H__
+
+#include <stdint.h>
+
+#include "slab_event.h"
+#include "rgb_hsv.h"
+
+/** Pixel buffers of slabs sending RGB frames
+ *
+ * Frame events only borrow their pixels, see SLAB_EVENT_RGB_FRAME. A slab
+ * that fills frames from its own buffer must not write the buffer again
+ * while an event still points into it, which happens when events wait in
+ * the inbox of a compiled graph or on the work list of queued dispatch.
+ *
+ * The slab keeps a reference to the last event sent from each buffer, and
+ * a buffer is only reused once that reference is the last one left. If all
+ * CONFIG_SLAB_FRAME_BUFFERS buffers are still in use, the frame is dropped.
+ */
+
+struct slab_frame_buf {
+	struct rgb_value *pixels;
+	uint32_t cap;           /* Pixels that fit in pixels */
+	struct slab_event *evt; /* Last event sent from the buffer, NULL if none */
+};
+
+struct slab_frame_bufs {
+	struct slab_frame_buf bufs[CONFIG_SLAB_FRAME_BUFFERS];
+};
+
+#define SLAB_FRAME_BUFS_INITIALIZER {0}
+
+/* Get a buffer for num_pixels pixels that no event points into.
+ *
+ * The buffer is taken from the heap, or grown, if needed. Returns NULL if
+ * all buffers are in use or the heap is exhausted.
+ */
+struct slab_frame_buf *slab_frame_buf_get(struct slab_frame_bufs *bufs, uint32_t num_pixels);
+
+/* Create an RGB frame event pointing into a buffer from slab_frame_buf_get().
+ *
+ * The event is acquired once for the caller, to pass on with
+ * slab_stim_childs(), and once for the buffer.
+ */
+struct slab_event *slab_frame_buf_send(struct slab_frame_buf *buf, uint32_t num_pixels);
+
+/* Drop the references to sent events and give the buffers back to the heap.
+ *
+ * Call when the slab is destroyed or stopped, when none of its events are
+ * in use any more.
+ */
+void slab_frame_bufs_free(struct slab_frame_bufs *bufs);
+
+#endif /* SLAB_FRAME_H__ */
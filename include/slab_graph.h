@@ -0,0 +1,198 @@
+#ifndef SLAB_GRAPH_H__
+#define SLAB_GRAPH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#include "slab.h"
+#include "slab_event.h"
+
+/** Compiled slab graph
+ *
+ * A connected graph of slabs can be frozen into a flat, topologically
+ * sorted schedule. Each step in the schedule holds a slab, the indices
+ * of its childs and a small inbox of pending events.
+ *
+ * Events given to a slab of a compiled graph are not passed on by
+ * recursion. They are queued in the inbox of the receiving slab, and the
+ * schedule is walked front to back until all inboxes are empty. A slab is
+ * therefore only evaluated after all of its parents, and stack use is
+ * bounded regardless of the depth of the graph.
+ */
+
+struct slab_graph;
+
+struct slab_graph_step {
+	struct slab_graph *graph;
+	struct slab *slab;
+	uint16_t first_edge; /* Index of first child in the edge array */
+	uint16_t num_edges;  /* Number of childs */
+
+	/* Inbox of pending events */
+	uint8_t head;
+	uint8_t count;
+	struct slab_event *inbox[CONFIG_SLAB_GRAPH_INBOX_SIZE];
+};
+
+struct slab_graph {
+	struct slab_graph_step *steps;
+	uint16_t *edges; /* Child step indices, grouped per step */
+	slab_event_mask_t *edge_masks; /* Events passed on along each edge */
+	uint16_t num_steps;
+	uint16_t num_edges;
+
+	/* Evaluation state */
+	struct k_mutex lock;
+	bool running;
+	uint16_t next; /* Lowest step index with pending events */
+
+	uint32_t num_dropped; /* Events dropped on a full inbox */
+};
+
+/* Connection from a parent slab to a child slab of a static graph. */
+struct slab_edge {
+	struct slab *parent;
+	struct slab *child;
+	slab_event_mask_t mask;
+};
+
+/* Edge from statically defined slab _parent to statically defined slab _child. */
+#define SLAB_EDGE(_parent, _child) SLAB_EDGE_MASK(_parent, _child, SLAB_EVENT_MASK_ALL)
+
+/* Edge only passing on the events set in _mask, see slab_connect_mask(). */
+#define SLAB_EDGE_MASK(_parent, _child, _mask) \
+	{.parent = SLAB_OF(_parent), .child = SLAB_OF(_child), .mask = (_mask)}
+
+/* Statically defined slab graph
+ *
+ * Holds the edges of the graph and storage for its schedule, so starting
+ * the graph does not allocate from the heap. See SLAB_GRAPH_DEFINE().
+ */
+struct slab_static_graph {
+	struct slab_graph graph;
+	const struct slab_edge *edges;
+	uint16_t num_edges;
+	uint16_t max_nodes;
+	bool paused;
+
+	/* Storage used by slab_graph_start() */
+	struct slab **nodes;
+	struct slab **childs;  /* Child lists of all slabs, grouped per parent */
+	slab_event_mask_t *child_masks;
+	uint16_t *scratch;     /* Two entries per node */
+	struct slab_graph_step *steps;
+	uint16_t *step_edges;
+	slab_event_mask_t *step_edge_masks;
+};
+
+/* Statically define a slab graph from a list of SLAB_EDGE() and
+ * SLAB_EDGE_MASK() entries.
+ *
+ * The slabs must be statically defined with the SLAB_<TYPE>_DEFINE()
+ * macros of their types and form one connected graph. Childs of a slab
+ * receive events in the order their edges are listed. An edge listed
+ * twice passes on the events of both masks.
+ *
+ * Example:
+ *	SLAB_TICKER_DEFINE(ticker, 25);
+ *	SLAB_GLOWER_DEFINE(glower, &glower_config);
+ *	SLAB_HSV2RGB_DEFINE(hsv2rgb);
+ *	SLAB_LED_DEFINE(led, led_buf, LED_TYPE_RGB);
+ *
+ *	SLAB_GRAPH_DEFINE(graph,
+ *		SLAB_EDGE(ticker, glower),
+ *		SLAB_EDGE(glower, hsv2rgb),
+ *		SLAB_EDGE(hsv2rgb, led));
+ */
+#define SLAB_GRAPH_DEFINE(name, ...)                                                          \
+	static const struct slab_edge name##_edges[] = {__VA_ARGS__};                       \
+	static struct slab *name##_nodes[ARRAY_SIZE(name##_edges) + 1];                     \
+	static struct slab *name##_childs[ARRAY_SIZE(name##_edges)];                        \
+	static slab_event_mask_t name##_child_masks[ARRAY_SIZE(name##_edges)];              \
+	static uint16_t name##_scratch[2 * (ARRAY_SIZE(name##_edges) + 1)];                 \
+	static struct slab_graph_step name##_steps[ARRAY_SIZE(name##_edges) + 1];           \
+	static uint16_t name##_step_edges[ARRAY_SIZE(name##_edges)];                        \
+	static slab_event_mask_t name##_step_edge_masks[ARRAY_SIZE(name##_edges)];          \
+	static struct slab_static_graph name = {                                            \
+		.edges = name##_edges,                                                      \
+		.num_edges = ARRAY_SIZE(name##_edges),                                      \
+		.max_nodes = ARRAY_SIZE(name##_edges) + 1,                                  \
+		.nodes = name##_nodes,                                                      \
+		.childs = name##_childs,                                                    \
+		.child_masks = name##_child_masks,                                          \
+		.scratch = name##_scratch,                                                  \
+		.steps = name##_steps,                                                      \
+		.step_edges = name##_step_edges,                                            \
+		.step_edge_masks = name##_step_edge_masks,                                  \
+	}
+
+/* Compile the graph of all slabs reachable from a root slab.
+ *
+ * All reachable slabs are bound to the graph until slab_graph_release()
+ * is called. They can not be connected, disconnected or destroyed while
+ * bound.
+ *
+ * Returns 0 on success.
+ * Returns -EINVAL if an argument is NULL.
+ * Returns -EBUSY if a reachable slab is already part of a compiled graph.
+ * Returns -ELOOP if the graph contains a cycle.
+ * Returns -ENOMEM if the schedule could not be allocated.
+ */
+int slab_graph_compile(struct slab_graph *graph, struct slab *root);
+
+/* Release a compiled graph.
+ *
+ * Pending events are dropped and all slabs of the graph are unbound,
+ * so they can be reconnected or destroyed again.
+ */
+void slab_graph_release(struct slab_graph *graph);
+
+/* Start a statically defined graph.
+ *
+ * Connects the slabs along the edges of the graph, compiles the schedule
+ * into the storage of the graph and runs the init operation of every slab.
+ * Nothing is taken from the heap.
+ *
+ * Returns 0 on success.
+ * Returns -EINVAL if graph is NULL or its edges do not form one connected
+ *         graph.
+ * Returns -EBUSY if a slab is already part of a graph or has been
+ *         connected with slab_connect().
+ * Returns -ELOOP if the graph contains a cycle.
+ */
+int slab_graph_start(struct slab_static_graph *graph);
+
+/* Stop a statically defined graph.
+ *
+ * Runs the deinit operation of every slab, drops pending events and
+ * disconnects the slabs again. The graph can be started again afterwards.
+ * A paused graph can be stopped as well.
+ */
+void slab_graph_stop(struct slab_static_graph *graph);
+
+/* Pause a started static graph.
+ *
+ * Runs the deinit operation of every slab and drops pending events, but
+ * keeps the slabs connected and the schedule compiled, so resuming is
+ * much cheaper than starting the graph again. Slabs stay bound to the
+ * graph and still pass on events given to them while paused.
+ *
+ * Returns 0 on success.
+ * Returns -EINVAL if graph is NULL or not started.
+ * Returns -EALREADY if the graph is already paused.
+ */
+int slab_graph_pause(struct slab_static_graph *graph);
+
+/* Resume a paused static graph.
+ *
+ * Runs the init operation of every slab again, which resets the slabs
+ * to their initial state.
+ *
+ * Returns 0 on success.
+ * Returns -EINVAL if graph is NULL or not started.
+ * Returns -EALREADY if the graph is not paused.
+ */
+int slab_graph_resume(struct slab_static_graph *graph);
+
+#endif /* SLAB_GRAPH_H__ */
@@ -0,0 +1,45 @@
+#ifndef SLAB_QUEUE_H__
+#define SLAB_QUEUE_H__
+
+#include <stdint.h>
+
+/** Queued slab dispatch
+ *
+ * By default an event given to a slab is processed right away, and the
+ * slab passes events on to its childs by recursion, so stack use grows
+ * with the depth of the graph.
+ *
+ * With CONFIG_SLAB_DISPATCH_QUEUE events given to slabs are put on a work
+ * list of (slab, event) pairs instead. The outermost slab_stim() or
+ * slab_stim_childs() call of a thread processes the list until it is
+ * empty, so stack use does not depend on the shape of the graph. The
+ * list holds up to CONFIG_SLAB_DISPATCH_QUEUE_SIZE events and lives on
+ * the stack of that outermost call. Events given to a slab on a full
+ * list are dropped and counted.
+ *
+ * Depth first order (CONFIG_SLAB_DISPATCH_DEPTH_FIRST) processes events
+ * in the same order as recursive dispatch. The events a slab sends while
+ * processing one event are reversed on the list, so everything following
+ * from the first event sent is processed before the next one. Breadth
+ * first order (CONFIG_SLAB_DISPATCH_BREADTH_FIRST) lets all childs of a
+ * slab process an event before any of their own childs do, and needs a
+ * longer list for wide graphs.
+ *
+ * Slabs of a compiled graph are evaluated by their graph either way, see
+ * slab_graph.h. Slabs must not be stimulated from interrupts.
+ */
+
+/* Work list counters, summed over all threads */
+struct slab_queue_stats {
+	uint32_t num_dispatched; /* Events processed from a work list */
+	uint32_t num_dropped;    /* Events dropped on a full work list */
+	uint16_t max_queued;     /* High-water mark of events on one work list */
+};
+
+/* Get the work list counters. Only available with CONFIG_SLAB_DISPATCH_QUEUE. */
+void slab_queue_stats_get(struct slab_queue_stats *stats);
+
+/* Clear the work list counters. Only available with CONFIG_SLAB_DISPATCH_QUEUE. */
+void slab_queue_stats_reset(void);
+
+#endif /* SLAB_QUEUE_H__ */
@@ -0,0 +1,91 @@
+#ifndef SLAB_STATS_H__
+#define SLAB_STATS_H__
+
+#include <stdint.h>
+
+#include "slab.h"
+
+/** Slab runtime statistics
+ *
+ * With CONFIG_SLAB_STATS every slab counts the events it processes, the
+ * events it sends to its childs and the cycles spent in its stim
+ * operation. Cycles spent in childs that are stimulated recursively are
+ * not included, so the counters show which slab dominates a frame.
+ *
+ * Slabs are listed from the first event they process until they are
+ * destroyed.
+ *
+ * In addition, the time from a tick leaving a ticker slab to the last
+ * LED written because of it is collected in a histogram with power of
+ * two buckets: bucket 0 counts latencies below 2 us and bucket i counts
+ * latencies from 2^i us up to 2^(i+1) us. The last bucket also counts
+ * everything longer.
+ *
+ * The counters are meant for diagnostics. Cycle counts of slabs stimulated
+ * from several threads at the same time are not exact.
+ */
+
+/* Counters of one slab */
+struct slab_stats_snapshot {
+	const struct slab *slab;
+	enum slab_type type;
+	uint32_t num_stims;
+	uint32_t num_emitted;
+	uint64_t cycles;
+};
+
+#ifdef CONFIG_SLAB_STATS
+
+/* Tick to LED latency histogram */
+struct slab_latency_stats {
+	uint32_t num_ticks; /* Ticks that lead to at least one LED write */
+	uint32_t max_us;
+	uint32_t buckets[CONFIG_SLAB_STATS_LATENCY_BUCKETS];
+};
+
+/* Called for every slab listed by slab_stats_foreach().
+ *
+ * Return false to stop the iteration.
+ */
+typedef bool (*slab_stats_cb)(const struct slab_stats_snapshot *snapshot, void *user_data);
+
+/* Get the counters of one slab. */
+void slab_stats_get(const struct slab *slab, struct slab_stats_snapshot *snapshot);
+
+/* Call cb with the counters of every listed slab.
+ *
+ * Slabs can not be destroyed from the callback.
+ */
+void slab_stats_foreach(slab_stats_cb cb, void *user_data);
+
+/* Copy the counters of up to max_snapshots listed slabs.
+ *
+ * Returns the number of listed slabs, which may be larger than max_snapshots.
+ */
+int slab_stats_snapshot(struct slab_stats_snapshot *snapshots, int max_snapshots);
+
+/* Get the tick to LED latency histogram. */
+void slab_stats_latency_get(struct slab_latency_stats *latency);
+
+/* Clear the counters of all listed slabs and the latency histogram. */
+void slab_stats_reset(void);
+
+/* Latency measurement hooks.
+ *
+ * A ticker calls slab_stats_tick_begin() before sending a tick and
+ * slab_stats_tick_end() once the tick has been processed. Slabs that
+ * write LEDs call slab_stats_led_written() after every write.
+ */
+void slab_stats_tick_begin(void);
+void slab_stats_tick_end(void);
+void slab_stats_led_written(void);
+
+#else
+
+static inline void slab_stats_tick_begin(void) {}
+static inline void slab_stats_tick_end(void) {}
+static inline void slab_stats_led_written(void) {}
+
+#endif /* CONFIG_SLAB_STATS */
+
+#endif /* SLAB_STATS_H__ */
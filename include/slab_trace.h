@@ -0,0 +1,69 @@
+#ifndef SLAB_TRACE_H__
+#define SLAB_TRACE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+#include "slab.h"
+#include "slab_event.h"
+
+/** Slab event tracer
+ *
+ * With CONFIG_SLAB_TRACE every event given to a slab and every event sent
+ * to the childs of a slab is recorded in a ring buffer. Records have a
+ * fixed size, so tracing costs a copy of 16 bytes and never blocks on
+ * output. When the buffer is full the oldest records are overwritten.
+ *
+ * Records are read with slab_trace_drain(), or dumped as hex with the
+ * "slab trace dump" shell command, and decoded on the host with
+ * scripts/slab_trace_decode.py.
+ */
+
+enum slab_trace_kind {
+	SLAB_TRACE_STIM = 1,    /* Event given to a slab */
+	SLAB_TRACE_EMIT,        /* Event sent to the childs of a slab */
+};
+
+/* One trace record. All fields are little endian. */
+struct slab_trace_record {
+	uint32_t timestamp; /* k_cycle_get_32() */
+	uint32_t slab;      /* Low 32 bits of the slab address */
+	uint16_t slab_type;
+	uint16_t num_refs;  /* References held on the event when recorded */
+	uint8_t event_id;
+	uint8_t kind;       /* enum slab_trace_kind */
+	uint16_t reserved;
+} __packed;
+
+BUILD_ASSERT(sizeof(struct slab_trace_record) == 16, "Trace records must stay 16 bytes");
+
+#ifdef CONFIG_SLAB_TRACE
+
+/* Record an event passing a slab. */
+void slab_trace(enum slab_trace_kind kind, const struct slab *slab, const struct slab_event *evt);
+
+/* Move the oldest trace records into a buffer.
+ *
+ * Only whole records are moved. Returns the number of records moved.
+ */
+size_t slab_trace_drain(struct slab_trace_record *records, size_t max_records);
+
+/* Drop all trace records and clear the count of overwritten records. */
+void slab_trace_clear(void);
+
+/* Number of records overwritten before they were drained. */
+uint32_t slab_trace_num_lost(void);
+
+/* Pause or resume tracing. Tracing is enabled from start. */
+void slab_trace_enable(bool enable);
+
+#else
+
+static inline void slab_trace(enum slab_trace_kind kind, const struct slab *slab,
+			      const struct slab_event *evt) {}
+
+#endif /* CONFIG_SLAB_TRACE */
+
+#endif /* SLAB_TRACE_H__ */
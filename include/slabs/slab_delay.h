@@ -3,21 +3,139 @@
 
 #include <stdint.h>
 
+#include <rbuf.h>
+
 #include "slab.h"
 
+/* Size of one delayed value in bytes: the event id and a packed value of
+ * up to 6 bytes. RGB values are stored as is, with their fraction, HSV
+ * values are quantized to 16 bit hue and 8 bit saturation and value.
+ */
+#define SLAB_DELAY_ENTRY_SIZE 7
+
+/* Copies of delayed frames.
+ *
+ * Allocated on the first frame with room for num_frames frames of
+ * frame_size bytes each, which is one more than the delay can hold,
+ * so the frame being sent is not overwritten by the one being queued.
+ */
+struct slab_delay_frames {
+	uint8_t *buf;
+	uint32_t frame_size;
+	uint32_t num_frames;
+	uint32_t idx;
+};
+
+#define SLAB_DELAY_FRAMES_INITIALIZER(_num_frames) \
+	{.buf = NULL, .frame_size = 0, .num_frames = _num_frames, .idx = 0}
+
 struct slab_delay {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 
-	const struct slab_event** queue;
+	/* Delayed values, one entry per period */
+	struct rbuf line;
 	uint32_t length;
-	uint32_t idx;
+
+	struct slab_delay_frames frames;
+};
+
+/* Delay with one history and several outputs.
+ *
+ * Child i, in connection order, receives the value given to the delay
+ * taps[i] periods ago. Tap 0 is the value just given. Childs without
+ * a tap receive nothing.
+ */
+struct slab_tapped_delay {
+	struct slab_childs childs;
+	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
+
+	/* The last depth values, one entry per period */
+	struct rbuf history;
+	uint32_t depth;
+
+	const uint16_t *taps;
+	uint16_t num_taps;
+
+	struct slab_delay_frames frames;
 };
 
+SLAB_TYPE_DECLARE(slab_type_delay);
+SLAB_TYPE_DECLARE(slab_type_tapped_delay);
+
+/* Statically define a delay slab, see slab_delay_create().
+ *
+ * Frame copies are still taken from the heap on the first frame event,
+ * and given back when the graph is stopped.
+ */
+#define SLAB_DELAY_DEFINE(name, _delay_periods)                                          \
+	static uint8_t name##_line[(_delay_periods) * SLAB_DELAY_ENTRY_SIZE];           \
+	static struct slab_delay name = {                                                \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_DELAY, slab_type_delay),               \
+		.line = RBUF_INITIALIZER(name##_line, sizeof(name##_line), 0),           \
+		.length = _delay_periods,                                                \
+		.frames = SLAB_DELAY_FRAMES_INITIALIZER((_delay_periods) + 1)            \
+	}
+
+/* Statically define a tapped delay slab, see slab_tapped_delay_create().
+ *
+ * _max_periods is the longest tap. The taps follow as a list, one per child.
+ *
+ * Example:
+ *	SLAB_TAPPED_DELAY_DEFINE(wave, 40, 0, 20, 40);
+ *
+ *	SLAB_GRAPH_DEFINE(graph,
+ *		SLAB_EDGE(source, wave),
+ *		SLAB_EDGE(wave, led_near),
+ *		SLAB_EDGE(wave, led_middle),
+ *		SLAB_EDGE(wave, led_far));
+ */
+#define SLAB_TAPPED_DELAY_DEFINE(name, _max_periods, ...)                                       \
+	static const uint16_t name##_taps[] = {__VA_ARGS__};                                   \
+	static uint8_t name##_history[((_max_periods) + 1) * SLAB_DELAY_ENTRY_SIZE];           \
+	static struct slab_tapped_delay name = {                                                \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_TAPPED_DELAY, slab_type_tapped_delay),        \
+		.history = RBUF_INITIALIZER(name##_history, sizeof(name##_history), 0),         \
+		.depth = (_max_periods) + 1,                                                    \
+		.taps = name##_taps, .num_taps = ARRAY_SIZE(name##_taps),                       \
+		.frames = SLAB_DELAY_FRAMES_INITIALIZER((_max_periods) + 2)                     \
+	}
+
+/* Create a slab delaying events by delay_periods events.
+ *
+ * Every RGB, HSV, tick and frame event takes one period. The delay keeps
+ * no references to events. It stores their values and sends new events
+ * with the same values once they come out of the delay, so memory use is
+ * SLAB_DELAY_ENTRY_SIZE bytes per period. At most 9362 periods.
+ */
 struct slab *slab_delay_create(uint32_t delay_periods);
 
 void slab_delay_destroy(struct slab *slab);
 
 void slab_delay_stim(struct slab *slab, struct slab_event *evt);
 
+/* Create a tapped delay slab, sending child i the events given to it
+ * taps[i] periods ago.
+ *
+ * Periods are counted as for slab_delay_create(). All taps share one
+ * history as long as the longest tap, so each event costs one write
+ * and one read per tap, instead of a chain of delay slabs. The taps
+ * are copied. At most 9361 periods.
+ */
+struct slab *slab_tapped_delay_create(const uint16_t *taps, uint16_t num_taps);
+
+void slab_tapped_delay_destroy(struct slab *slab);
+
+void slab_tapped_delay_stim(struct slab *slab, struct slab_event *evt);
+
 #endif /* SLAB_DELAY_H__ */
@@ -0,0 +1,63 @@
+#ifndef SLAB_GAMMA_H__
+#define SLAB_GAMMA_H__
+
+#include <zephyr/kernel.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_frame.h"
+#include "rgb_hsv.h"
+#include "gamma_lut.h"
+
+struct slab_gamma {
+	struct slab_childs childs;
+	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
+
+	/* Specific data */
+	struct k_spinlock lock;
+	struct gamma_config config;
+	bool config_changed; /* The tables are rebuilt on the next event */
+	struct gamma_lut lut;
+
+	struct slab_frame_bufs frames; /* Corrected pixels of RGB frames */
+};
+
+SLAB_TYPE_DECLARE(slab_type_gamma);
+
+/* Statically define a gamma and brightness slab, see slab_gamma_create().
+ *
+ * The buffers for corrected frames are taken from the heap on the first
+ * RGB frames, and given back when the graph is stopped.
+ */
+#define SLAB_GAMMA_DEFINE(name, _gamma, _brightness)                                  \
+	static struct slab_gamma name = {                                            \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_GAMMA, slab_type_gamma),           \
+		.config = {.gamma = _gamma, .brightness = _brightness,               \
+			   .balance = {255, 255, 255}},                              \
+		.config_changed = true, .frames = SLAB_FRAME_BUFS_INITIALIZER        \
+	}
+
+/* Create a slab correcting RGB values and frames with lookup tables.
+ *
+ * Each channel goes through its own 256 entry table, which is only
+ * rebuilt when the configuration changes. RGB values keep the fraction
+ * of the table entries, frames are rounded to 8 bit. Other events are
+ * forwarded.
+ */
+struct slab *slab_gamma_create(const struct gamma_config *config);
+
+void slab_gamma_destroy(struct slab *slab);
+
+void slab_gamma_stim(struct slab *slab, struct slab_event *evt);
+
+/* Change the configuration. May be called from any thread, the tables
+ * are rebuilt by the slab when it gets its next event.
+ */
+void slab_gamma_config_set(struct slab *slab, const struct gamma_config *config);
+
+#endif /* SLAB_GAMMA_H__ */
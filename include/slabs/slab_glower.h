@@ -6,20 +6,39 @@
 #include "glow_func.h"
 
 struct slab_glower_config {
-	float hue; /* [0,360] */
-	float sat; /* [0,1] */
+	color_num_t hue; /* [0,360] */
+	color_num_t sat; /* [0,1] */
 	struct glow_func_conf val;
 };
 
 struct slab_glower {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 
 	/* Specific data */
 	void *gen;
 	struct hsv_value data;
+	const struct slab_glower_config *config; /* Set for statically defined glowers */
 };
 
+SLAB_TYPE_DECLARE(slab_type_glower);
+
+/* Statically define a glower slab, see slab_glower_create().
+ *
+ * The configuration is applied when the graph of the slab is started.
+ */
+#define SLAB_GLOWER_DEFINE(name, _config)                                        \
+	static struct glow_func name##_gen;                                     \
+	static struct slab_glower name = {                                    \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_GLOWER, slab_type_glower),     \
+		.gen = &name##_gen, .config = _config                          \
+	}
+
 struct slab *slab_glower_create(struct slab_glower_config *config);
 
 void slab_glower_destroy(struct slab *slab);
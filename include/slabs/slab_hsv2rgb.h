@@ -3,6 +3,34 @@
 
 #include "slab.h"
 #include "slab_event.h"
+#include "slab_frame.h"
+#include "rgb_hsv.h"
+
+struct slab_hsv2rgb {
+	struct slab_childs childs;
+	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
+
+	/* Specific data */
+	struct slab_frame_bufs frames; /* Converted pixels of HSV frames */
+};
+
+SLAB_TYPE_DECLARE(slab_type_hsv2rgb);
+
+/* Statically define an HSV to RGB converter slab.
+ *
+ * The buffers for converted frames are still taken from the heap on the
+ * first HSV frames, and given back when the graph is stopped.
+ */
+#define SLAB_HSV2RGB_DEFINE(name)                                              \
+	static struct slab_hsv2rgb name = {                                    \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_HSV2RGB, slab_type_hsv2rgb), \
+		.frames = SLAB_FRAME_BUFS_INITIALIZER                          \
+	}
 
 struct slab *slab_hsv2rgb_create(void);
 
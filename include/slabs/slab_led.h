@@ -10,20 +10,88 @@ enum led_type {
 	LED_TYPE_RED,
 	LED_TYPE_GREEN,
 	LED_TYPE_BLUE,
+	LED_TYPE_RGB16, /* As LED_TYPE_RGB, with 8 fractional bits per channel */
+	LED_TYPE_GRB16, /* As LED_TYPE_GRB, with 8 fractional bits per channel */
 };
 
 struct slab_led {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 
 	uint8_t *led;
 	enum led_type led_type;
+	uint16_t num_leds;    /* Number of consecutive LEDs in led */
+	uint16_t first_pixel; /* Pixel of a frame written to the first LED */
 };
 
+SLAB_TYPE_DECLARE(slab_type_led);
+SLAB_TYPE_DECLARE(slab_type_led_strip);
+
+#define SLAB_LED_INITIALIZER(_led_buf, _led_type)                     \
+	{                                                                 \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_LED, slab_type_led),       \
+		.led = (uint8_t *)(_led_buf), .led_type = _led_type,          \
+		.num_leds = 1, .first_pixel = 0                               \
+	}
+
+/* Statically define a LED slab, see slab_led_create(). */
+#define SLAB_LED_DEFINE(name, _led_buf, _led_type) \
+	static struct slab_led name = SLAB_LED_INITIALIZER(_led_buf, _led_type)
+
+/* Statically define an array of LED slabs without LED buffers.
+ *
+ * Use slab_led_set_buffer() to bind each slab to its LED buffer.
+ */
+#define SLAB_LED_ARRAY_DEFINE(name, _num, _led_type) \
+	static struct slab_led name[_num] = {[0 ...(_num) - 1] = SLAB_LED_INITIALIZER(NULL, _led_type)}
+
+/* Statically define a LED strip slab, see slab_led_strip_create(). */
+#define SLAB_LED_STRIP_DEFINE(name, _led_buf, _first_pixel, _num_leds, _led_type)   \
+	static struct slab_led name = {                                             \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_LED_STRIP, slab_type_led_strip),  \
+		.led = (uint8_t *)(_led_buf), .led_type = _led_type,                 \
+		.num_leds = _num_leds, .first_pixel = _first_pixel                   \
+	}
+
 struct slab *slab_led_create(void *led_buf, enum led_type type);
 
+/* Create a LED slab driving num_leds consecutive LEDs in led_buf.
+ *
+ * Frame events write pixels [first_pixel, first_pixel + num_leds) to the
+ * LEDs, single RGB events set all LEDs to the same color. LEDs of type
+ * LED_TYPE_RGB and LED_TYPE_GRB take 3 bytes each, single color LEDs
+ * take 1 byte each. LEDs of type LED_TYPE_RGB16 and LED_TYPE_GRB16 take
+ * 3 uint16_t each, holding the fraction of RGB events for dithering at
+ * the output, see struct rgb16_value. Their buffer must be aligned for
+ * uint16_t.
+ */
+struct slab *slab_led_strip_create(void *led_buf, uint16_t first_pixel, uint16_t num_leds,
+				   enum led_type type);
+
 void slab_led_destroy(struct slab *slab);
 
+/* Point a LED slab at another LED buffer, or NULL to stop writing LEDs.
+ *
+ * Used for statically defined slabs whose LED buffer is only known at run time.
+ */
+void slab_led_set_buffer(struct slab *slab, void *led_buf);
+
 void slab_led_stim(struct slab *slab, struct slab_event *evt);
 
+/* Called after a LED slab wrote its LED buffer led_buf, from the thread
+ * that stimulated the slab.
+ */
+typedef void (*slab_led_written_cb)(void *led_buf);
+
+/* Set the function called after every LED write, NULL for none.
+ *
+ * Lets the code sending the LED buffers to the LEDs sleep while they do not change.
+ */
+void slab_led_written_cb_set(slab_led_written_cb cb);
+
 #endif /* SLAB_LED_H__ */
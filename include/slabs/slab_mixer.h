@@ -0,0 +1,124 @@
+#ifndef SLAB_MIXER_H__
+#define SLAB_MIXER_H__
+
+#include <stdbool.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "rgb_hsv.h"
+
+/* How the values of the input ports are combined, in port order.
+ * All modes saturate at 255 per channel.
+ */
+enum slab_mixer_mode {
+	SLAB_MIXER_ADD,       /* Sum of the values */
+	SLAB_MIXER_MULTIPLY,  /* Product of the values, 255 being one */
+	SLAB_MIXER_MAX,       /* Brightest value per channel */
+	SLAB_MIXER_CROSSFADE, /* Each port covers the ports before it by its alpha */
+};
+
+struct slab_mixer;
+
+/* Input port of a mixer. Connect it to the slab whose output it takes. */
+struct slab_mixer_port {
+	struct slab_childs childs;
+	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
+
+	/* Specific data */
+	struct slab_mixer *mixer;
+	struct rgb_value val; /* Latest value */
+	bool has_val;         /* Set once a value arrived since the last reset */
+	uint8_t alpha;        /* Cover of the ports before, SLAB_MIXER_CROSSFADE only */
+};
+
+struct slab_mixer {
+	struct slab_childs childs;
+	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
+
+	/* Specific data */
+	enum slab_mixer_mode mode;
+	uint16_t num_ports;
+	struct slab_mixer_port *ports;
+};
+
+SLAB_TYPE_DECLARE(slab_type_mixer);
+SLAB_TYPE_DECLARE(slab_type_mixer_port);
+
+/* Statically define a mixer with _num_ports input ports.
+ *
+ * The ports are defined as name##_ports[], all with alpha 255. Add them
+ * to the graph with SLAB_MIXER_PORT_EDGE(), not SLAB_EDGE().
+ *
+ * Example:
+ *	SLAB_MIXER_DEFINE(mix, SLAB_MIXER_ADD, 2);
+ *
+ *	SLAB_GRAPH_DEFINE(graph,
+ *		SLAB_EDGE(ticker, glower),
+ *		SLAB_EDGE(ticker, waver),
+ *		SLAB_EDGE(ticker, mix),
+ *		SLAB_MIXER_PORT_EDGE(glower_rgb, mix, 0),
+ *		SLAB_MIXER_PORT_EDGE(waver_rgb, mix, 1),
+ *		SLAB_EDGE(mix, led));
+ */
+#define SLAB_MIXER_DEFINE(name, _mode, _num_ports)                                          \
+	static struct slab_mixer name;                                                     \
+	static struct slab_mixer_port name##_ports[_num_ports] = {                         \
+		[0 ...(_num_ports) - 1] = {                                                \
+			SLAB_STATIC_INITIALIZER(SLAB_TYPE_MIXER_PORT, slab_type_mixer_port), \
+			.mixer = &name, .has_val = false, .alpha = 255                     \
+		}                                                                          \
+	};                                                                                 \
+	static struct slab_mixer name = {                                                  \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_MIXER, slab_type_mixer),                 \
+		.mode = _mode, .num_ports = _num_ports, .ports = name##_ports              \
+	}
+
+/* Edges of a static graph connecting _parent to port _idx of a mixer.
+ *
+ * Besides the edge to the port, this adds an edge from the port to the
+ * mixer that passes no events. It orders the port before the mixer in
+ * the schedule of the graph, see slab_mixer_create().
+ */
+#define SLAB_MIXER_PORT_EDGE(_parent, _mixer, _idx)                                         \
+	SLAB_EDGE(_parent, _mixer##_ports[_idx]),                                          \
+	SLAB_EDGE_MASK(_mixer##_ports[_idx], _mixer, 0)
+
+/* Create a slab combining the latest values of num_ports input ports.
+ *
+ * The ports keep the last RGB or HSV value they got, HSV is converted on
+ * arrival. On each tick the mixer sends one RGB event with the combined
+ * value of all ports that have one, and nothing if none has. A reset
+ * clears all ports and is forwarded.
+ *
+ * Each port is connected to the mixer with an edge passing no events, so
+ * a compiled graph runs the ports before the mixer and the mixer mixes the
+ * values of the same tick. Without a compiled graph, connect the mixer to
+ * the ticker after the sources for the same result.
+ *
+ * Disconnect the ports before destroying the mixer, they are freed with it.
+ */
+struct slab *slab_mixer_create(enum slab_mixer_mode mode, uint16_t num_ports);
+
+void slab_mixer_destroy(struct slab *slab);
+
+void slab_mixer_stim(struct slab *slab, struct slab_event *evt);
+
+/* Get input port idx of a mixer, NULL if there is no such port. */
+struct slab *slab_mixer_port(struct slab *slab, uint16_t idx);
+
+/* Set how much port idx covers the ports before it in SLAB_MIXER_CROSSFADE,
+ * from 0 (not shown) to 255 (only this port shown).
+ */
+void slab_mixer_alpha_set(struct slab *slab, uint16_t idx, uint8_t alpha);
+
+#endif /* SLAB_MIXER_H__ */
@@ -8,14 +8,28 @@
 typedef void (*slab_notifier_cb)(struct slab_event *evt, void *ctx);
 
 struct slab_notifier {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 
 	/* Specific data */
 	slab_notifier_cb sub;
 	void *ctx;
 };
 
+SLAB_TYPE_DECLARE(slab_type_notifier);
+
+/* Statically define a notifier slab, see slab_notifier_create(). */
+#define SLAB_NOTIFIER_DEFINE(name, _subscriber, _context)                          \
+	static struct slab_notifier name = {                                       \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_NOTIFIER, slab_type_notifier),   \
+		.sub = _subscriber, .ctx = _context                                \
+	}
+
 struct slab *slab_notifier_create(slab_notifier_cb subscriber, void *context);
 
 void slab_notifier_destroy(struct slab *slab);
@@ -4,6 +4,12 @@
 #include "slab.h"
 #include "slab_event.h"
 
+SLAB_TYPE_DECLARE(slab_type_rgb2hsv);
+
+/* Statically define an RGB to HSV converter slab. */
+#define SLAB_RGB2HSV_DEFINE(name) \
+	static struct slab name = {SLAB_STATIC_INITIALIZER(SLAB_TYPE_RGB2HSV, slab_type_rgb2hsv)}
+
 struct slab *slab_rgb2hsv_create(void);
 
 void slab_rgb2hsv_destroy(struct slab *slab);
@@ -2,25 +2,113 @@
 #define SLAB_TICKER_H__
 
 #include "zephyr/kernel.h"
+#include "zephyr/sys/dlist.h"
 #include "slab.h"
 
 #define TICKER_WORKQUEUE_STACK_SIZE 2048
 #define TICKER_WORKQUEUE_THREAD_PRIO 10
 
 struct slab_ticker {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 
 	/* Specific data */
-	k_timeout_t period;
-	struct k_timer tick_timer;
-	struct k_work tick_work;
+	uint32_t period_ms; /* Tick period of statically defined tickers */
+	uint32_t phase_ms;  /* Tick phase of statically defined tickers */
+	sys_dnode_t node;   /* Entry in the list of running tickers */
+	uint32_t divider;   /* Clock periods per tick */
+	uint32_t phase;     /* Clock periods the ticks are shifted by */
+	uint32_t next_tick; /* Clock period of the next tick */
+	bool is_idle;       /* No ticks until idle_until, or until stimulated */
+	bool idle_forever;  /* Idle until stimulated */
+	uint32_t idle_until; /* Clock period the idle time ends */
+	bool tick_due;      /* Tick of the current clock period still to be sent */
 };
 
+/* Overrun counters of the clock driving all tickers */
+struct slab_ticker_stats {
+	uint32_t num_periods;        /* Clock periods processed */
+	uint32_t num_overruns;       /* Times the clock was processed after its next period */
+	uint32_t num_missed_periods; /* Clock periods passed without processing */
+	uint32_t num_late;           /* Catch-up ticks sent after their period */
+	uint32_t num_dropped;        /* Ticks not sent */
+	uint32_t max_cycles;         /* Longest processing of one clock period */
+};
+
+SLAB_TYPE_DECLARE(slab_type_ticker);
+
+/* Statically define a ticker slab, see slab_ticker_create().
+ *
+ * The ticker only runs while its graph is started.
+ */
+#define SLAB_TICKER_DEFINE(name, _period_ms) SLAB_TICKER_PHASE_DEFINE(name, _period_ms, 0)
+
+/* Statically define a ticker slab ticking _phase_ms after the tickers
+ * with the same period and no phase.
+ */
+#define SLAB_TICKER_PHASE_DEFINE(name, _period_ms, _phase_ms)                  \
+	static struct slab_ticker name = {                                     \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_TICKER, slab_type_ticker),   \
+		.period_ms = _period_ms, .phase_ms = _phase_ms                 \
+	}
+
+/* Create a slab sending a tick event every tick_period.
+ *
+ * All tickers run from one clock with a period of CONFIG_SLAB_CLOCK_PERIOD_MS,
+ * tick_period is rounded to a whole number of clock periods. Tickers with
+ * the same period tick together and do not drift apart. The ticks of one
+ * clock period are sent in one go from the ticker work queue, and carry
+ * the time of that clock period.
+ *
+ * A reset event restarts the period of the ticker.
+ */
 struct slab *slab_ticker_create(k_timeout_t tick_period);
 
 void slab_ticker_destroy(struct slab *slab);
 
 void slab_ticker_stim(struct slab *slab, struct slab_event *evt);
 
+/* idle_until value that keeps a ticker idle until it is stimulated. */
+#define SLAB_TICKER_IDLE_FOREVER UINT32_MAX
+
+/* Report that the output driven by a ticker stays the same until until_ms,
+ * in the time carried by ticks, or until it is stimulated for
+ * SLAB_TICKER_IDLE_FOREVER.
+ *
+ * The ticker sends no ticks until then. Any event other than a tick, such
+ * as a tweak or a reset stimulated into the ticker, ends the idle time
+ * early. While all tickers are idle the clock timer stops, so the system
+ * only wakes for the end of the earliest idle time.
+ */
+void slab_ticker_idle_until(struct slab *slab, uint32_t until_ms);
+
+/* End the idle time of a ticker early, see slab_ticker_idle_until().
+ *
+ * For code changing the slabs driven by the ticker directly, instead of
+ * through events. Does nothing if the ticker is not idle.
+ */
+void slab_ticker_wake(struct slab *slab);
+
+/* Get the overrun counters. Overruns mean the graphs take longer than
+ * the tick period, see CONFIG_SLAB_TICKER_OVERRUN for how they are handled.
+ */
+void slab_ticker_stats_get(struct slab_ticker_stats *stats);
+
+/* Clear the overrun counters. */
+void slab_ticker_stats_reset(void);
+
+/* Advance the clock of all tickers by num_periods clock periods and send
+ * the ticks that are due, from the calling thread.
+ *
+ * Only available with CONFIG_SLAB_CLOCK_MANUAL. The clock then does not
+ * follow the uptime but starts at 0 ms and only moves here, so ticks carry
+ * the same times on every run, as fast as they can be processed.
+ */
+void slab_clock_advance(uint32_t num_periods);
+
 #endif /* SLAB_TICKER_H__ */
@@ -6,20 +6,39 @@
 #include "wave_func.h"
 
 struct slab_waver_config {
-	float hue; /* [0,360] */
-	float sat; /* [0,1] */
+	color_num_t hue; /* [0,360] */
+	color_num_t sat; /* [0,1] */
 	struct wave_func_conf val;
 };
 
 struct slab_waver {
-	sys_dlist_t childs;
+	struct slab_childs childs;
 	enum slab_type type;
+	const struct slab_type_api *api;
+	struct slab_graph_step *step;
+#ifdef CONFIG_SLAB_STATS
+	struct slab_stats stats;
+#endif
 
 	/* Specific data */
 	void *gen;
 	struct hsv_value data;
+	const struct slab_waver_config *config; /* Set for statically defined wavers */
 };
 
+SLAB_TYPE_DECLARE(slab_type_waver);
+
+/* Statically define a waver slab, see slab_waver_create().
+ *
+ * The configuration is applied when the graph of the slab is started.
+ */
+#define SLAB_WAVER_DEFINE(name, _config)                                        \
+	static struct wave_func name##_gen;                                     \
+	static struct slab_waver name = {                                    \
+		SLAB_STATIC_INITIALIZER(SLAB_TYPE_WAVER, slab_type_waver),     \
+		.gen = &name##_gen, .config = _config                          \
+	}
+
 struct slab *slab_waver_create(struct slab_waver_config *config);
 
 void slab_waver_destroy(struct slab *slab);
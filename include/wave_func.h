@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#include "rgb_hsv.h"
+
 /*
 	ym = 0.5 * (yh + yl);
 	yd = yh - yl;
@@ -10,8 +12,8 @@
 
 struct wave_func_conf {
 	uint32_t T; /* Period in miliseconds */
-	float ym;   /* Middle value of window */
-	float yd;   /* Width of window */
+	color_num_t ym; /* Middle value of window */
+	color_num_t yd; /* Width of window */
 };
 
 struct wave_func {
@@ -31,6 +33,6 @@ void wave_func_reset(struct wave_func *wf, const struct wave_func_conf *config);
  *
  * Return Wave function output value y
  */
-float wave_func_process(struct wave_func *wf, uint32_t t);
+color_num_t wave_func_process(struct wave_func *wf, uint32_t t);
 
 #endif /* WAVE_FUNCTION_H__ */
@@ -37,16 +37,16 @@ void glow_func_reset(struct glow_func *gf, const struct glow_func_conf *config)
 	}
 }
 
-float glow_func_process(struct glow_func *gf, uint32_t t, float w)
+color_num_t glow_func_process(struct glow_func *gf, uint32_t t, color_num_t w)
 {
-	float dt;
-	float p1;
-	float p2;
-	float y;
+	color_num_t dt;
+	color_num_t p1;
+	color_num_t p2;
+	color_num_t y;
 	struct glow_func_conf *params;
 	
 	if (gf == NULL) {
-		return 0.0;
+		return 0;
 	}
 
 	params = &(gf->conf);
@@ -58,20 +58,20 @@ float glow_func_process(struct glow_func *gf, uint32_t t, float w)
 	}
 
 	/* Calculate timestep */
-	dt = (t - gf->t1)/1000.0;
+	dt = COLOR_NUM_FROM_INT(t - gf->t1) / 1000;
 	if (t < gf->t1) {
 		dt = -dt;
 	}
 
-	if (w < 0 || 1 < w) {
+	if (w < 0 || COLOR_NUM_ONE < w) {
 		/* Collapse into low-pass filter with middle value ym */
-		w = 0.5;
+		w = COLOR_NUM(0.5);
 	}
 
 	/* Calculate output value */
-	p1 = dt * (params->a + params->b);
-	p2 = dt * params->b * params->yd;
-	y = gf->y1 + p1 * (params->ym - gf->y1) + p2 * (w - 0.5f);
+	p1 = COLOR_NUM_MUL(dt, params->a + params->b);
+	p2 = COLOR_NUM_MUL(COLOR_NUM_MUL(dt, params->b), params->yd);
+	y = gf->y1 + COLOR_NUM_MUL(p1, params->ym - gf->y1) + COLOR_NUM_MUL(p2, w - COLOR_NUM(0.5));
 
 	/* Update states */
 	gf->t1 = t;
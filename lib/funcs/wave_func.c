@@ -11,6 +11,16 @@ static void reset(struct wave_func *wf, const struct wave_func_conf *conf)
 	wf->t0 = 0;
 }
 
+/* Ramp from -1 to 1 as dt goes from 0 to T */
+static color_num_t ramp(uint32_t dt, uint32_t T)
+{
+#ifdef CONFIG_COLOR_FIXED_POINT
+	return (color_num_t)(((int64_t)dt << (COLOR_NUM_FRAC_BITS + 1)) / T) - COLOR_NUM_ONE;
+#else
+	return 2.0f/T*dt - 1;
+#endif
+}
+
 struct wave_func *wave_func_create(const struct wave_func_conf *config)
 {
 	struct wave_func *wf = k_malloc(sizeof(struct wave_func));
@@ -35,15 +45,15 @@ void wave_func_reset(struct wave_func *wf, const struct wave_func_conf *config)
 	}
 }
 
-float wave_func_process(struct wave_func *wf, uint32_t t)
+color_num_t wave_func_process(struct wave_func *wf, uint32_t t)
 {
-	float y;
+	color_num_t y;
 	uint32_t t1;
 	uint32_t t2;
 	struct wave_func_conf *params;
 	
 	if (wf == NULL) {
-		return 0.0;
+		return 0;
 	}
 
 	params = &(wf->conf);
@@ -60,9 +70,9 @@ float wave_func_process(struct wave_func *wf, uint32_t t)
 	if (t < wf->t0) {
 		y = params->ym - params->yd;
 	} else if (t < t1) {
-		y = params->ym + (2.0f/(params->T)*(t - wf->t0) - 1) * params->yd;
+		y = params->ym + COLOR_NUM_MUL(ramp(t - wf->t0, params->T), params->yd);
 	} else if (t < t2) {
-		y = params->ym - (2.0f/(params->T)*(t - wf->t0 - params->T) - 1) * params->yd;
+		y = params->ym - COLOR_NUM_MUL(ramp(t - wf->t0 - params->T, params->T), params->yd);
 	} else {
 		y = params->ym - params->yd;
 	}
@@ -255,6 +255,20 @@ int rbuf_peek(struct rbuf *buf, uint8_t *data, size_t *len, size_t offset, uint1
 	return RBUF_SUCCESS;
 }
 
+int rbuf_init(struct rbuf *buf, uint8_t *data, uint16_t size, uint16_t flags)
+{
+	const struct rbuf init = RBUF_INITIALIZER(data, size, flags);
+
+	if (buf == NULL || data == NULL || size == 0) {
+		return RBUF_ERR_ARG_INVALID;
+	}
+
+	/* Size and array are const members, so the structure is copied in whole. */
+	memcpy(buf, &init, sizeof(init));
+
+	return rbuf_reset(buf, false);
+}
+
 int rbuf_reset(struct rbuf *buf, bool zero_memory)
 {
 	if (buf == NULL || MAGIC_CHECK(buf)) {
@@ -49,12 +49,31 @@ struct rbuf_sizes {
 	uint16_t used;
 };
 
+/** @brief Macro for initializing a ring buffer, rbuf structure, on top of an existing array. */
+#define RBUF_INITIALIZER(_buf, _size, _flags)                                                      \
+	{ IF_ENABLED(CONFIG_RBUF_MAGIC, (.magic = RBUF_MAGIC,))                                    \
+	  .wi = 0, .ri = 0, .flags = (_flags), .size = (_size), .buf = (_buf) }
+
 /** @brief Macro for defining a ring buffer, rbuf structure. */
 #define RBUF_DEF(_name, _size, _flags)                                                             \
 	static uint8_t CONCAT(_name, _buf)[_size];                                                 \
-	struct rbuf (_name) = { IF_ENABLED(CONFIG_RBUF_MAGIC, (.magic = RBUF_MAGIC,))              \
-				.wi = 0, .ri = 0, .flags = (_flags), .size = (_size),              \
-				.buf = &(CONCAT(_name, _buf)[0]) }
+	struct rbuf (_name) = RBUF_INITIALIZER(&(CONCAT(_name, _buf)[0]), _size, _flags)
+
+/**
+ * @brief Initialize a ring buffer at run time, on top of an existing array.
+ *
+ * Use for ring buffers that are not defined with @ref RBUF_DEF or @ref RBUF_INITIALIZER,
+ * like ring buffers embedded in heap allocated structures.
+ *
+ * @param      buf     Ring buffer.
+ * @param[in]  data    Array holding the ring buffer content.
+ * @param[in]  size    Size of @p data in bytes.
+ * @param[in]  flags   Flags altering the behavior of the ring buffer. Use @c 0 for no flags.
+ *
+ * @retval RBUF_SUCCESS          On success.
+ * @retval RBUF_ERR_ARG_INVALID  If @p buf or @p data is @c NULL or @p size is zero.
+ */
+int rbuf_init(struct rbuf *buf, uint8_t *data, uint16_t size, uint16_t flags);
 
 /**
  * @brief Add data to ring buffer.
@@ -0,0 +1,11 @@
+#include "dither.h"
+
+void dither_frame(const struct rgb16_value *in, struct dither_error *error,
+		  struct rgb_value *out, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		out[i].r = dither_channel(in[i].r, &error[i].r);
+		out[i].g = dither_channel(in[i].g, &error[i].g);
+		out[i].b = dither_channel(in[i].b, &error[i].b);
+	}
+}
@@ -0,0 +1,32 @@
+#include "gamma_lut.h"
+
+#include <math.h>
+
+static void build_channel(uint16_t *table, float gamma, uint32_t scale)
+{
+	for (int i = 0; i < 256; i++) {
+		float y = powf(i / 255.0f, gamma) * scale * 256.0f;
+
+		table[i] = (uint16_t)(y + 0.5f);
+	}
+}
+
+void gamma_lut_build(struct gamma_lut *lut, const struct gamma_config *config)
+{
+	float gamma = (config->gamma > 0.0f) ? config->gamma : 1.0f;
+
+	/* Both scales are [0,255], the product is brought back to [0,255]. */
+	build_channel(lut->r, gamma, config->brightness * config->balance[0] / 255);
+	build_channel(lut->g, gamma, config->brightness * config->balance[1] / 255);
+	build_channel(lut->b, gamma, config->brightness * config->balance[2] / 255);
+}
+
+void gamma_lut_apply_batch(const struct gamma_lut *lut, const struct rgb_value *in,
+			   struct rgb_value *out, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		out[i].r = GAMMA_LUT_TO_U8(lut->r[in[i].r]);
+		out[i].g = GAMMA_LUT_TO_U8(lut->g[in[i].g]);
+		out[i].b = GAMMA_LUT_TO_U8(lut->b[in[i].b]);
+	}
+}
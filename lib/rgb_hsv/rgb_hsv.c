@@ -1,81 +1,118 @@
 #include "rgb_hsv.h"
 
-struct rgb_value hsv2rgb(const struct hsv_value val)
+#include <stdbool.h>
+
+#include <zephyr/sys/util.h>
+
+/* Channel values of a hue sector, see sector_channels */
+enum {
+	CH_V, /* Value */
+	CH_P, /* Value minus chroma */
+	CH_Q, /* Falling from value to value minus chroma over the sector */
+	CH_T, /* Rising from value minus chroma to value over the sector */
+	CH_NUM,
+};
+
+/* Which channel value goes to red, green and blue in each hue sector.
+ * Hue 360 gives sector 6, which continues sector 5.
+ */
+static const uint8_t sector_channels[7][3] = {
+	{CH_V, CH_T, CH_P},
+	{CH_Q, CH_V, CH_P},
+	{CH_P, CH_V, CH_T},
+	{CH_P, CH_Q, CH_V},
+	{CH_T, CH_P, CH_V},
+	{CH_V, CH_P, CH_Q},
+	{CH_V, CH_P, CH_Q},
+};
+
+/* Rounded up 2^16 / i, to divide by 8 bit values with a multiplication */
+#define RECIPROCAL(i, _) (((i) == 0) ? 0 : ((1U << 16) + (i) - 1) / (i))
+
+static const uint32_t reciprocals[256] = {
+	LISTIFY(256, RECIPROCAL, (,))
+};
+
+/* RGB channel value with 8 fractional bits from [0,1] */
+#ifdef CONFIG_COLOR_FIXED_POINT
+#define CHANNEL16(n) ((uint16_t)(((n) * 255) >> (COLOR_NUM_FRAC_BITS - 8)))
+#else
+#define CHANNEL16(n) ((uint16_t)((n) * 255 * 256))
+#endif
+
+/* Get the red, green and blue channels in [0,1] of an HSV value.
+ * Returns false for values out of range, which convert to black.
+ */
+static inline bool hsv_channels(const struct hsv_value *val, color_num_t rgb[3])
 {
-	struct rgb_value out;
+	const uint8_t *map;
 	uint8_t i;
-	float C; float ff;
-	float r; float g; float b;
-	
-
-	if (val.h < 0.0f || 360.0f < val.h ||
-		val.s < 0.0f || 1.0f < val.s ||
-		val.v < 0.0f || 1.0f < val.v) {
-		out.r = 0;
-		out.g = 0;
-		out.b = 0;
-		return out;
+	color_num_t C; color_num_t ff; color_num_t sector;
+	color_num_t ch[CH_NUM];
+
+	if (val->h < 0 || COLOR_NUM(360) < val->h ||
+		val->s < 0 || COLOR_NUM_ONE < val->s ||
+		val->v < 0 || COLOR_NUM_ONE < val->v) {
+		return false;
 	}
 
-	C = val.v * val.s;
-
-	i = (uint8_t)(val.h / 60.0f);
-	ff = (val.h / 60.0f) - (float)i;
-
-	r = val.v;
-	g = val.v;
-	b = val.v;
-
-	switch (i) {
-	case 0:
-		g -= C * (1.0f - ff);
-		b -= C;
-		break;
-
-	case 1:
-		r -= C * ff;
-		b -= C;
-		break;
-
-	case 2:
-		r -= C;
-		b -= C * (1.0f - ff);
-		break;
-
-	case 3:
-		r -= C;
-		g -= C * ff;
-		break;
-
-	case 4:
-		r -= C * (1.0f - ff);
-		g -= C;
-		break;
-
-	case 5:
-	default:
-		g -= C;
-		b -= C * ff;
-		break;
+	C = COLOR_NUM_MUL(val->v, val->s);
+
+	sector = val->h / 60;
+	i = (uint8_t)COLOR_NUM_TO_INT(sector);
+	ff = sector - COLOR_NUM_FROM_INT(i);
+
+	ch[CH_V] = val->v;
+	ch[CH_P] = val->v - C;
+	ch[CH_Q] = val->v - COLOR_NUM_MUL(C, ff);
+	ch[CH_T] = val->v - COLOR_NUM_MUL(C, COLOR_NUM_ONE - ff);
+
+	map = sector_channels[i];
+	rgb[0] = ch[map[0]];
+	rgb[1] = ch[map[1]];
+	rgb[2] = ch[map[2]];
+
+	return true;
+}
+
+static inline struct rgb_value convert_hsv(const struct hsv_value *val)
+{
+	struct rgb_value out = {0, 0, 0};
+	color_num_t rgb[3];
+
+	if (hsv_channels(val, rgb)) {
+		out.r = (uint8_t)COLOR_NUM_TO_INT(rgb[0] * 255);
+		out.g = (uint8_t)COLOR_NUM_TO_INT(rgb[1] * 255);
+		out.b = (uint8_t)COLOR_NUM_TO_INT(rgb[2] * 255);
 	}
 
-	out.r = (uint8_t)(r * 255.0f);
-	out.g = (uint8_t)(g * 255.0f);
-	out.b = (uint8_t)(b * 255.0f);
+	return out;
+}
+
+static inline struct rgb16_value convert_hsv16(const struct hsv_value *val)
+{
+	struct rgb16_value out = {0, 0, 0};
+	color_num_t rgb[3];
+
+	if (hsv_channels(val, rgb)) {
+		out.r = CHANNEL16(rgb[0]);
+		out.g = CHANNEL16(rgb[1]);
+		out.b = CHANNEL16(rgb[2]);
+	}
 
 	return out;
 }
 
-struct hsv_value rgb2hsv(const struct rgb_value val)
+static inline struct hsv_value convert_rgb(const struct rgb_value *val)
 {
 	struct hsv_value out;
 
-	float r; float g; float b;
-	float cmax; float cmin; float diff;
+	color_num_t r; color_num_t g; color_num_t b;
+	color_num_t cmax; color_num_t cmin; color_num_t diff;
 
-	r = val.r/255.0;
-	g = val.g/255.0;
-	b = val.b/255.0;
+	r = COLOR_NUM_FROM_INT(val->r) / 255;
+	g = COLOR_NUM_FROM_INT(val->g) / 255;
+	b = COLOR_NUM_FROM_INT(val->b) / 255;
 
 	if (g > b) {
 		cmax = (r > g) ? r : g;
@@ -89,23 +126,101 @@ struct hsv_value rgb2hsv(const struct rgb_value val)
 	if (diff == 0) {
 		out.h = 0;
 	} else if (cmax == r) {
-		out.h = 60 * ((g - b) / diff);
+		out.h = 60 * COLOR_NUM_DIV(g - b, diff);
 		if (out.h < 0) {
-			out.h = out.h + 360;
+			out.h = out.h + COLOR_NUM(360);
 		}
 	} else if (cmax == g) {
-		out.h = 60 * ((b - r) / diff) + 120.0f;
-	} else if (cmax == b) {
-		out.h = 60 * ((r - g) / diff) + 240.0f;
+		out.h = 60 * COLOR_NUM_DIV(b - r, diff) + COLOR_NUM(120);
+	} else {
+		out.h = 60 * COLOR_NUM_DIV(r - g, diff) + COLOR_NUM(240);
 	}
 
 	if (cmax == 0) {
 		out.s = 0;
 	} else {
-		out.s = (diff / cmax) * 100;
+		out.s = COLOR_NUM_DIV(diff, cmax) * 100;
 	}
 
 	out.v = cmax * 100;
 
 	return out;
 }
+
+struct rgb_value hsv2rgb(const struct hsv_value val)
+{
+	return convert_hsv(&val);
+}
+
+struct rgb16_value hsv2rgb16(const struct hsv_value val)
+{
+	return convert_hsv16(&val);
+}
+
+struct hsv_value rgb2hsv(const struct rgb_value val)
+{
+	return convert_rgb(&val);
+}
+
+void hsv2rgb_batch(const struct hsv_value *in, struct rgb_value *out, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		out[i] = convert_hsv(&in[i]);
+	}
+}
+
+void rgb2hsv_batch(const struct rgb_value *in, struct hsv_value *out, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		out[i] = convert_rgb(&in[i]);
+	}
+}
+
+void hsv2rgb_int_batch(const struct hsv_int_value *in, struct rgb_value *out, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		const uint8_t *map = sector_channels[(in[i].h >> 8) % 6];
+		uint32_t ff = in[i].h & 0xff;
+		uint32_t v = in[i].v;
+		uint32_t C = (v * in[i].s + 255) >> 8;
+		uint8_t ch[CH_NUM];
+
+		ch[CH_V] = v;
+		ch[CH_P] = v - C;
+		ch[CH_Q] = v - ((C * ff) >> 8);
+		ch[CH_T] = v - ((C * (256 - ff)) >> 8);
+
+		out[i].r = ch[map[0]];
+		out[i].g = ch[map[1]];
+		out[i].b = ch[map[2]];
+	}
+}
+
+void rgb2hsv_int_batch(const struct rgb_value *in, struct hsv_int_value *out, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		int32_t r = in[i].r;
+		int32_t g = in[i].g;
+		int32_t b = in[i].b;
+		int32_t cmax = MAX(r, MAX(g, b));
+		int32_t diff = cmax - MIN(r, MIN(g, b));
+		int32_t h;
+
+		if (diff == 0) {
+			h = 0;
+		} else if (cmax == r) {
+			h = ((g - b) * (int32_t)reciprocals[diff]) >> 8;
+			if (h < 0) {
+				h += HSV_INT_HUE_MAX;
+			}
+		} else if (cmax == g) {
+			h = 512 + (((b - r) * (int32_t)reciprocals[diff]) >> 8);
+		} else {
+			h = 1024 + (((r - g) * (int32_t)reciprocals[diff]) >> 8);
+		}
+
+		out[i].h = h;
+		out[i].s = MIN((diff * reciprocals[cmax] * 255) >> 16, 255);
+		out[i].v = cmax;
+	}
+}
@@ -4,21 +4,24 @@
 #include <zephyr/kernel.h>
 
 #include "slab_event.h"
+#include "slab_event_pool.h"
 #include "rgb_hsv.h"
 
 struct slab_event_hsv {
 	enum slab_event_id id;
 	int num_refs;
 
-	float h;
-	float s;
-	float v;
+	color_num_t h;
+	color_num_t s;
+	color_num_t v;
 };
 
 static inline struct slab_event *slab_event_hsv_create(struct hsv_value val)
 {
-	struct slab_event_hsv *new_evt = k_malloc(sizeof(struct slab_event_hsv));
-	__ASSERT(new_evt != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	struct slab_event_hsv *new_evt = slab_event_pool_alloc(SLAB_EVENT_HSV);
+	if (new_evt == NULL) {
+		return NULL;
+	}
 
 	new_evt->h = val.h;
 	new_evt->s = val.s;
@@ -29,7 +32,7 @@ static inline struct slab_event *slab_event_hsv_create(struct hsv_value val)
 
 static inline void slab_event_hsv_destroy(struct slab_event *evt)
 {
-	k_free(evt);
+	slab_event_pool_free(evt);
 }
 
 static inline struct hsv_value slab_event_hsv_get_val(struct slab_event *evt)
@@ -0,0 +1,47 @@
+#ifndef SLAB_EVENT_HSV_FRAME_H__
+#define SLAB_EVENT_HSV_FRAME_H__
+
+#include <zephyr/kernel.h>
+
+#include "slab_event.h"
+#include "slab_event_pool.h"
+#include "rgb_hsv.h"
+
+struct slab_event_hsv_frame {
+	enum slab_event_id id;
+	int num_refs;
+
+	const struct hsv_value *pixels; /* Borrowed, see SLAB_EVENT_HSV_FRAME */
+	uint32_t num_pixels;
+};
+
+static inline struct slab_event *slab_event_hsv_frame_create(const struct hsv_value *pixels,
+							    uint32_t num_pixels)
+{
+	struct slab_event_hsv_frame *new_evt = slab_event_pool_alloc(SLAB_EVENT_HSV_FRAME);
+	if (new_evt == NULL) {
+		return NULL;
+	}
+
+	new_evt->pixels = pixels;
+	new_evt->num_pixels = num_pixels;
+
+	return ((struct slab_event *)new_evt);
+}
+
+static inline void slab_event_hsv_frame_destroy(struct slab_event *evt)
+{
+	slab_event_pool_free(evt);
+}
+
+static inline const struct hsv_value *slab_event_hsv_frame_get_pixels(struct slab_event *evt,
+								    uint32_t *num_pixels)
+{
+	struct slab_event_hsv_frame *frame_evt = (struct slab_event_hsv_frame *)evt;
+
+	*num_pixels = frame_evt->num_pixels;
+
+	return frame_evt->pixels;
+}
+
+#endif /* SLAB_EVENT_HSV_FRAME_H__ */
@@ -0,0 +1,16 @@
+#ifndef SLAB_EVENT_POOL_H__
+#define SLAB_EVENT_POOL_H__
+
+#include "slab_event.h"
+
+/* Take a block from the fixed size pool of the given event type.
+ *
+ * Returns NULL if the pool is exhausted. Allocation never blocks
+ * and never touches the system heap.
+ */
+void *slab_event_pool_alloc(enum slab_event_id event_id);
+
+/* Give the block of an event back to the pool it was taken from. */
+void slab_event_pool_free(struct slab_event *evt);
+
+#endif /* SLAB_EVENT_POOL_H__ */
@@ -4,18 +4,18 @@
 #include <zephyr/kernel.h>
 
 #include "slab_event.h"
+#include "slab_event_pool.h"
 
 static inline struct slab_event *slab_event_reset_create(void)
 {
-	struct slab_event *new_evt = k_malloc(sizeof(struct slab_event));
-	__ASSERT(new_evt != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	struct slab_event *new_evt = slab_event_pool_alloc(SLAB_EVENT_RESET);
 
 	return new_evt;
 }
 
 static inline void slab_event_reset_destroy(struct slab_event *evt)
 {
-	k_free(evt);
+	slab_event_pool_free(evt);
 }
 
 #endif /* SLAB_EVENT_RESET_H__ */
@@ -4,6 +4,7 @@
 #include <zephyr/kernel.h>
 
 #include "slab_event.h"
+#include "slab_event_pool.h"
 #include "rgb_hsv.h"
 
 struct slab_event_rgb {
@@ -13,23 +14,50 @@ struct slab_event_rgb {
 	uint8_t r;
 	uint8_t g;
 	uint8_t b;
+
+	/* Fraction of each channel in 1/256, see slab_event_rgb_get_val16() */
+	uint8_t r_frac;
+	uint8_t g_frac;
+	uint8_t b_frac;
 };
 
 static inline struct slab_event *slab_event_rgb_create(struct rgb_value val)
 {
-	struct slab_event_rgb *new_evt = k_malloc(sizeof(struct slab_event_rgb));
-	__ASSERT(new_evt != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	struct slab_event_rgb *new_evt = slab_event_pool_alloc(SLAB_EVENT_RGB);
+	if (new_evt == NULL) {
+		return NULL;
+	}
 
 	new_evt->r = val.r;
 	new_evt->g = val.g;
 	new_evt->b = val.b;
+	new_evt->r_frac = 0;
+	new_evt->g_frac = 0;
+	new_evt->b_frac = 0;
+
+	return ((struct slab_event *)new_evt);
+}
+
+static inline struct slab_event *slab_event_rgb16_create(struct rgb16_value val)
+{
+	struct slab_event_rgb *new_evt = slab_event_pool_alloc(SLAB_EVENT_RGB);
+	if (new_evt == NULL) {
+		return NULL;
+	}
+
+	new_evt->r = val.r >> 8;
+	new_evt->g = val.g >> 8;
+	new_evt->b = val.b >> 8;
+	new_evt->r_frac = val.r & 0xff;
+	new_evt->g_frac = val.g & 0xff;
+	new_evt->b_frac = val.b & 0xff;
 
 	return ((struct slab_event *)new_evt);
 }
 
 static inline void slab_event_rgb_destroy(struct slab_event *evt)
 {
-	k_free(evt);
+	slab_event_pool_free(evt);
 }
 
 static inline struct rgb_value slab_event_rgb_get_val(struct slab_event *evt)
@@ -44,4 +72,17 @@ static inline struct rgb_value slab_event_rgb_get_val(struct slab_event *evt)
 	return val;
 }
 
+/* Get the value with the fraction kept from slab_event_create_rgb16(). */
+static inline struct rgb16_value slab_event_rgb_get_val16(struct slab_event *evt)
+{
+	struct rgb16_value val;
+	struct slab_event_rgb *rgb_evt = (struct slab_event_rgb *)evt;
+
+	val.r = (rgb_evt->r << 8) | rgb_evt->r_frac;
+	val.g = (rgb_evt->g << 8) | rgb_evt->g_frac;
+	val.b = (rgb_evt->b << 8) | rgb_evt->b_frac;
+
+	return val;
+}
+
 #endif /* SLAB_EVENT_RGB_H__ */
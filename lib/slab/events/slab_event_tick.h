@@ -4,6 +4,7 @@
 #include <zephyr/kernel.h>
 
 #include "slab_event.h"
+#include "slab_event_pool.h"
 
 struct slab_event_tick {
 	enum slab_event_id id;
@@ -14,8 +15,10 @@ struct slab_event_tick {
 
 static inline struct slab_event *slab_event_tick_create(uint32_t time)
 {
-	struct slab_event_tick *new_evt = k_malloc(sizeof(struct slab_event_tick));
-	__ASSERT(new_evt != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	struct slab_event_tick *new_evt = slab_event_pool_alloc(SLAB_EVENT_TICK);
+	if (new_evt == NULL) {
+		return NULL;
+	}
 
 	new_evt->time = time;
 
@@ -24,7 +27,7 @@ static inline struct slab_event *slab_event_tick_create(uint32_t time)
 
 static inline void slab_event_tick_destroy(struct slab_event *evt)
 {
-	k_free(evt);
+	slab_event_pool_free(evt);
 }
 
 static inline uint32_t slab_event_tick_get_time(struct slab_event *evt)
@@ -1,242 +1,284 @@
 #include <stdint.h>
-#include <zephyr/sys/dlist.h>
+#include <string.h>
+#include <zephyr/kernel.h>
 
 #include "slab.h"
 #include "slab_event.h"
+#include "slab_priv.h"
+#include "slab_trace.h"
 
-#include "slabs/slab_led.h"
-#include "slabs/slab_delay.h"
-#include "slabs/slab_ticker.h"
-#include "slabs/slab_glower.h"
-#include "slabs/slab_waver.h"
-#include "slabs/slab_hsv2rgb.h"
-#include "slabs/slab_rgb2hsv.h"
-#include "slabs/slab_notifier.h"
-
-struct slab_child {
-	sys_dnode_t root;
-	struct slab *child;
-};
+/*==============================[Child sets]==================================*/
+static void childs_init(struct slab_childs *childs)
+{
+	childs->list = childs->inline_list;
+	childs->masks = childs->inline_masks;
+	childs->num = 0;
+	childs->cap = CONFIG_SLAB_INLINE_CHILDS;
+}
 
-struct slab *slab_create(enum slab_type type, ...)
+static void childs_free(struct slab_childs *childs)
 {
-	struct slab *new_slab;
-	va_list args;
+	/* The masks share the allocation of the list. */
+	if (childs->list != childs->inline_list) {
+		k_free(childs->list);
+	}
 
-	va_start(args, type);
+	childs_init(childs);
+}
 
-	switch(type) {
-	case SLAB_TYPE_LED: {
-		struct rgb_value *val = va_arg(args, struct rgb_value *);
-		enum led_type led_type = va_arg(args, int);
-		new_slab = slab_led_create(val, led_type);
-		break;
-	}
-	case SLAB_TYPE_DELAY: {
-		uint32_t delay_periods = va_arg(args, uint32_t);
-		new_slab = slab_delay_create(delay_periods);
-		break;
+static int childs_index_of(const struct slab_childs *childs, const struct slab *slab)
+{
+	for (int i = 0; i < childs->num; i++) {
+		if (childs->list[i] == slab) {
+			return i;
+		}
 	}
-	case SLAB_TYPE_TICKER: {
-		k_timeout_t timer_period = va_arg(args, k_timeout_t);
-		new_slab = slab_ticker_create(timer_period);
-		break;
+
+	return -1;
+}
+
+static bool childs_append(struct slab_childs *childs, struct slab *slab, slab_event_mask_t mask)
+{
+	struct slab **grown;
+	slab_event_mask_t *grown_masks;
+
+	if (childs->list == NULL) {
+		childs_init(childs);
 	}
-	case SLAB_TYPE_GLOWER: {
-		struct slab_glower_config *conf = va_arg(args, struct slab_glower_config *);
-		new_slab = slab_glower_create(conf);
-		break;
+
+	if (childs->num == childs->cap) {
+		if (childs->cap > UINT16_MAX / 2) {
+			return false;
+		}
+
+		/* List and masks share one allocation, the masks following the list. */
+		grown = k_malloc((sizeof(struct slab *) + sizeof(slab_event_mask_t)) * childs->cap * 2);
+		if (grown == NULL) {
+			return false;
+		}
+		grown_masks = (slab_event_mask_t *)&grown[childs->cap * 2];
+
+		memcpy(grown, childs->list, sizeof(struct slab *) * childs->num);
+		memcpy(grown_masks, childs->masks, sizeof(slab_event_mask_t) * childs->num);
+		if (childs->list != childs->inline_list) {
+			k_free(childs->list);
+		}
+
+		childs->list = grown;
+		childs->masks = grown_masks;
+		childs->cap *= 2;
 	}
-	case SLAB_TYPE_WAVER: {
-		struct slab_waver_config *conf = va_arg(args, struct slab_waver_config *);
-		new_slab = slab_waver_create(conf);
-		break;
+
+	childs->list[childs->num] = slab;
+	childs->masks[childs->num] = mask;
+	childs->num += 1;
+	return true;
+}
+
+static void childs_remove(struct slab_childs *childs, const struct slab *slab)
+{
+	int i = childs_index_of(childs, slab);
+
+	if (i < 0) {
+		return;
 	}
-	case SLAB_TYPE_HSV2RGB: {
-		new_slab = slab_hsv2rgb_create();
-		break;
+
+	/* Keep connection order, it decides the order childs are stimulated in. */
+	memmove(&childs->list[i], &childs->list[i + 1],
+		sizeof(struct slab *) * (childs->num - i - 1));
+	memmove(&childs->masks[i], &childs->masks[i + 1],
+		sizeof(slab_event_mask_t) * (childs->num - i - 1));
+	childs->num -= 1;
+
+	/* Move back inside the slab once the overflow is no longer needed. */
+	if (childs->list != childs->inline_list && childs->num <= CONFIG_SLAB_INLINE_CHILDS) {
+		memcpy(childs->inline_list, childs->list, sizeof(struct slab *) * childs->num);
+		memcpy(childs->inline_masks, childs->masks, sizeof(slab_event_mask_t) * childs->num);
+		k_free(childs->list);
+		childs->list = childs->inline_list;
+		childs->masks = childs->inline_masks;
+		childs->cap = CONFIG_SLAB_INLINE_CHILDS;
 	}
-	case SLAB_TYPE_RGB2HSV: {
-		new_slab = slab_rgb2hsv_create();
-		break;
+}
+
+/*==============================[Public methods]==============================*/
+static const struct slab_type_api *find_type(enum slab_type type)
+{
+	STRUCT_SECTION_FOREACH(slab_type_api, api) {
+		if (api->type == type) {
+			return api;
+		}
 	}
-	case SLAB_TYPE_NOTIFIER: {
-		slab_notifier_cb subcriber = va_arg(args, slab_notifier_cb);
-		void *context = va_arg(args, void *);
-		new_slab = slab_notifier_create(subcriber, context);
-		break;
+
+	return NULL;
+}
+
+struct slab *slab_create(enum slab_type type, ...)
+{
+	struct slab *new_slab;
+	const struct slab_type_api *api;
+	va_list args;
+
+	api = find_type(type);
+	if (api == NULL) {
+		return NULL;
 	}
-	default:
-		new_slab = NULL;
-		goto clean_exit;
+
+	va_start(args, type);
+	new_slab = api->create(&args);
+	va_end(args);
+
+	if (new_slab == NULL) {
+		return NULL;
 	}
 
 	new_slab->type = type;
-	sys_dlist_init(&new_slab->childs);
+	new_slab->api = api;
+	new_slab->step = NULL;
+	childs_init(&new_slab->childs);
+#ifdef CONFIG_SLAB_STATS
+	memset(&new_slab->stats, 0, sizeof(new_slab->stats));
+#endif
 
-clean_exit:
-	va_end(args);
 	return new_slab;
 }
 
 void slab_destroy(struct slab *slab)
-{	
-	sys_dnode_t *elem;
-	sys_dnode_t *elem_safe;
-	struct slab_child *child_elem;
-
+{
 	if (slab == NULL) {
 		return;
 	}
 
-	/* De-allocate list of child pointers */
-	SYS_DLIST_FOR_EACH_NODE_SAFE(&slab->childs, elem, elem_safe) {
-		sys_dlist_remove(elem);
-		child_elem = CONTAINER_OF(elem, struct slab_child, root);
-		k_free(child_elem);
-	}
-
-	/* De-allocate memory specific for this slab type */
-	switch (slab->type) {
-	case SLAB_TYPE_LED:
-		slab_led_destroy(slab);
-		break;
-
-	case SLAB_TYPE_DELAY:
-		slab_delay_destroy(slab);
-		break;
-
-	case SLAB_TYPE_TICKER:
-		slab_ticker_destroy(slab);
-		break;
-
-	case SLAB_TYPE_GLOWER:
-		slab_glower_destroy(slab);
-		break;
-
-	case SLAB_TYPE_WAVER:
-		slab_waver_destroy(slab);
-		break;
+	__ASSERT(slab->step == NULL, "Release the compiled graph before destroying its slabs");
 
-	case SLAB_TYPE_HSV2RGB:
-		slab_hsv2rgb_destroy(slab);
-		break;
+#ifdef CONFIG_SLAB_STATS
+	slab_stats_remove(slab);
+#endif
 
-	case SLAB_TYPE_RGB2HSV:
-		slab_rgb2hsv_destroy(slab);
-		break;
-
-	case SLAB_TYPE_NOTIFIER:
-		slab_notifier_destroy(slab);
-		break;
+	/* De-allocate list of child pointers */
+	childs_free(&slab->childs);
 
-	default:
-		/* Silently ignore */
-		break;
+	/* De-allocate memory specific for this slab type */
+	if (slab->api != NULL) {
+		slab->api->destroy(slab);
 	}
 }
 
 void slab_connect(struct slab *slab, struct slab *connect_to)
 {
-	sys_dnode_t *elem;
-	struct slab_child *child_elem;
-	struct slab_child *new_child_elem;
+	slab_connect_mask(slab, connect_to, SLAB_EVENT_MASK_ALL);
+}
+
+void slab_connect_mask(struct slab *slab, struct slab *connect_to, slab_event_mask_t mask)
+{
+	int idx;
 
 	if (slab == NULL || slab->type == 0 ||
 		connect_to == NULL || connect_to->type == 0) {
 		return;
 	}
 
-	SYS_DLIST_FOR_EACH_NODE(&connect_to->childs, elem) {
-		child_elem = CONTAINER_OF(elem, struct slab_child, root);
-		if (child_elem->child == slab) {
-			return;
-		}
+	if (slab->step != NULL || connect_to->step != NULL) {
+		__ASSERT(false, "Release the compiled graph before connecting its slabs");
+		return;
 	}
 
-	new_child_elem = k_malloc(sizeof(struct slab_child));
-	__ASSERT(new_child_elem != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	idx = childs_index_of(&connect_to->childs, slab);
+	if (idx >= 0) {
+		connect_to->childs.masks[idx] = mask;
+		return;
+	}
 
-	sys_dnode_init(&new_child_elem->root);
-	new_child_elem->child = slab;
-	sys_dlist_append(&connect_to->childs, &new_child_elem->root);
+	if (!childs_append(&connect_to->childs, slab, mask)) {
+		__ASSERT(false, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	}
 }
 
 void slab_disconnect(struct slab *slab, struct slab *disconnect_from)
 {
-	sys_dnode_t *elem;
-	sys_dnode_t *elem_safe;
-	struct slab_child *child_elem;
-
 	if (slab == NULL || slab->type == 0 ||
 		disconnect_from == NULL || disconnect_from->type == 0) {
 		return;
 	}
 
-	SYS_DLIST_FOR_EACH_NODE_SAFE(&disconnect_from->childs, elem, elem_safe) {
-		child_elem = CONTAINER_OF(elem, struct slab_child, root);
-		if (child_elem->child == slab) {
-			sys_dlist_remove(elem);
-			k_free(child_elem);
-		}
+	if (slab->step != NULL || disconnect_from->step != NULL) {
+		__ASSERT(false, "Release the compiled graph before disconnecting its slabs");
+		return;
 	}
+
+	childs_remove(&disconnect_from->childs, slab);
 }
 
 void slab_stim_childs(struct slab *slab, struct slab_event *evt)
 {
-	sys_dnode_t *elem;
-	struct slab_child *child_elem;
+	struct slab **childs = slab->childs.list;
+	const slab_event_mask_t *masks = slab->childs.masks;
+	slab_event_mask_t evt_mask;
 
-	SYS_DLIST_FOR_EACH_NODE(&slab->childs, elem) {
-		child_elem = CONTAINER_OF(elem, struct slab_child, root);
-		slab_stim(child_elem->child, evt);
+	if (evt == NULL) {
+		return;
 	}
 
-	slab_event_release(evt);
-}
+	slab_count_emitted(slab);
+	slab_trace(SLAB_TRACE_EMIT, slab, evt);
 
-void slab_stim(struct slab *slab, struct slab_event *evt)
-{
-	if (slab == NULL || evt == NULL) {
+	if (slab->step != NULL) {
+		slab_graph_stim_childs(slab->step, evt);
 		return;
 	}
 
-	slab_event_acquire(evt);
+#ifdef CONFIG_SLAB_DISPATCH_QUEUE
+	slab_queue_stim_childs(slab, evt);
+	return;
+#endif
 
-	switch (slab->type) {
-	case SLAB_TYPE_LED:
-		slab_led_stim(slab, evt);
-		break;
+	evt_mask = SLAB_EVENT_MASK(evt->id);
 
-	case SLAB_TYPE_DELAY:
-		slab_delay_stim(slab, evt);
-		break;
+	for (int i = 0; i < slab->childs.num; i++) {
+		if (masks[i] & evt_mask) {
+			slab_stim(childs[i], evt);
+		}
+	}
 
-	case SLAB_TYPE_TICKER:
-		slab_ticker_stim(slab, evt);
-		break;
+	slab_event_release(evt);
+}
 
-	case SLAB_TYPE_GLOWER:
-		slab_glower_stim(slab, evt);
-		break;
+void slab_stim_child(struct slab *slab, uint16_t idx, struct slab_event *evt)
+{
+	if (evt == NULL) {
+		return;
+	}
 
-	case SLAB_TYPE_WAVER:
-		slab_waver_stim(slab, evt);
-		break;
+	if (idx >= slab->childs.num || !(slab->childs.masks[idx] & SLAB_EVENT_MASK(evt->id))) {
+		slab_event_release(evt);
+		return;
+	}
 
-	case SLAB_TYPE_HSV2RGB:
-		slab_hsv2rgb_stim(slab, evt);
-		break;
+	slab_count_emitted(slab);
+	slab_trace(SLAB_TRACE_EMIT, slab, evt);
 
-	case SLAB_TYPE_RGB2HSV:
-		slab_rgb2hsv_stim(slab, evt);
-		break;
+	slab_stim(slab->childs.list[idx], evt);
+	slab_event_release(evt);
+}
+
+void slab_stim(struct slab *slab, struct slab_event *evt)
+{
+	if (slab == NULL || evt == NULL) {
+		return;
+	}
 
-	case SLAB_TYPE_NOTIFIER:
-		slab_notifier_stim(slab, evt);
-		break;
+	slab_event_acquire(evt);
+	slab_trace(SLAB_TRACE_STIM, slab, evt);
 
-	default:
-		k_oops();
+	if (slab->step != NULL) {
+		slab_graph_stim(slab->step, evt);
+		return;
 	}
+
+#ifdef CONFIG_SLAB_DISPATCH_QUEUE
+	slab_queue_stim(slab, evt);
+	return;
+#endif
+
+	slab_dispatch(slab, evt);
 }
@@ -1,29 +1,188 @@
 #include "slab_event.h"
+#include "events/slab_event_tick.h"
+#include "events/slab_event_rgb.h"
+#include "events/slab_event_hsv.h"
+#include "events/slab_event_rgb_frame.h"
+#include "events/slab_event_hsv_frame.h"
 
 #include "slabs/slab_delay.h"
 
+#include <string.h>
 #include <zephyr/kernel.h>
 
-static void reset_queue(struct slab_delay *slab)
+#define ENTRY_EMPTY 0 /* Period without a value, like a failed frame copy */
+
+#define HUE_SCALE 64 /* Steps per degree of hue */
+
+BUILD_ASSERT(sizeof(struct rgb16_value) < SLAB_DELAY_ENTRY_SIZE, "RGB entry too small");
+
+static void reset_line(struct slab_delay *slab)
 {
-	for (int i = 0; i < slab->length; i++) {
-		slab->queue[i] = NULL;
+	rbuf_reset(&slab->line, false);
+}
+
+/* Copy the pixels of a frame event into the next frame buffer.
+ *
+ * Returns the index of the frame buffer, or -ENOMEM if no buffer could be
+ * allocated. Frames larger than the first frame seen by the delay are
+ * truncated.
+ */
+static int copy_frame(struct slab_delay_frames *frames, struct slab_event *evt,
+		      uint32_t *num_pixels)
+{
+	const void *pixels;
+	size_t pixel_size;
+	int frame;
+
+	if (evt->id == SLAB_EVENT_RGB_FRAME) {
+		pixels = slab_event_rgb_frame_get_pixels(evt, num_pixels);
+		pixel_size = sizeof(struct rgb_value);
+	} else {
+		pixels = slab_event_hsv_frame_get_pixels(evt, num_pixels);
+		pixel_size = sizeof(struct hsv_value);
+	}
+
+	if (frames->buf == NULL) {
+		frames->buf = k_malloc((size_t)frames->num_frames * *num_pixels * pixel_size);
+		if (frames->buf == NULL) {
+			return -ENOMEM;
+		}
+
+		frames->frame_size = *num_pixels * pixel_size;
+		frames->idx = 0;
 	}
-	slab->idx = 0;
+
+	*num_pixels = MIN(*num_pixels, frames->frame_size / pixel_size);
+
+	frame = frames->idx;
+	memcpy(&frames->buf[frame * frames->frame_size], pixels, *num_pixels * pixel_size);
+
+	frames->idx += 1;
+	if (frames->idx >= frames->num_frames) {
+		frames->idx = 0;
+	}
+
+	return frame;
 }
 
-static const struct slab_event *process_delay(struct slab_delay *slab, struct slab_event *evt_in)
+static void free_frames(struct slab_delay_frames *frames)
 {
-	const struct slab_event *evt_out = slab->queue[slab->idx];
+	k_free(frames->buf);
+	frames->buf = NULL;
+	frames->frame_size = 0;
+	frames->idx = 0;
+}
 
-	slab->queue[slab->idx] = evt_in;
+/* Pack the value of an event into a delay entry. */
+static void pack_entry(struct slab_delay_frames *frames, struct slab_event *evt, uint8_t *entry)
+{
+	memset(entry, 0, SLAB_DELAY_ENTRY_SIZE);
+	entry[0] = evt->id;
 
-	slab->idx += 1;
-	if (slab->idx >= slab->length) {
-		slab->idx = 0;
+	switch (evt->id) {
+	case SLAB_EVENT_TICK: {
+		uint32_t time = slab_event_tick_get_time(evt);
+
+		memcpy(&entry[1], &time, sizeof(time));
+		break;
 	}
+	case SLAB_EVENT_RGB: {
+		struct rgb16_value rgb = slab_event_rgb_get_val16(evt);
 
-	return (struct slab_event *)evt_out;
+		memcpy(&entry[1], &rgb, sizeof(rgb));
+		break;
+	}
+	case SLAB_EVENT_HSV: {
+		struct hsv_value hsv = slab_event_hsv_get_val(evt);
+		uint16_t h = COLOR_NUM_TO_INT(CLAMP(hsv.h, 0, COLOR_NUM(360)) * HUE_SCALE +
+					      COLOR_NUM(0.5));
+
+		memcpy(&entry[1], &h, sizeof(h));
+		entry[3] = COLOR_NUM_TO_INT(CLAMP(hsv.s, 0, COLOR_NUM_ONE) * UINT8_MAX + COLOR_NUM(0.5));
+		entry[4] = COLOR_NUM_TO_INT(CLAMP(hsv.v, 0, COLOR_NUM_ONE) * UINT8_MAX + COLOR_NUM(0.5));
+		break;
+	}
+	case SLAB_EVENT_RGB_FRAME:
+	case SLAB_EVENT_HSV_FRAME: {
+		uint32_t num_pixels;
+		int frame = copy_frame(frames, evt, &num_pixels);
+		uint16_t packed[2] = {frame, num_pixels};
+
+		if (frame < 0) {
+			/* The period is kept to keep the timing. */
+			entry[0] = ENTRY_EMPTY;
+			break;
+		}
+
+		memcpy(&entry[1], packed, sizeof(packed));
+		break;
+	}
+	default:
+		entry[0] = ENTRY_EMPTY;
+		break;
+	}
+}
+
+/* Create a new event from a delay entry. Returns NULL for empty entries. */
+static struct slab_event *unpack_entry(const struct slab_delay_frames *frames,
+				       const uint8_t *entry)
+{
+	switch (entry[0]) {
+	case SLAB_EVENT_TICK: {
+		uint32_t time;
+
+		memcpy(&time, &entry[1], sizeof(time));
+		return slab_event_create(SLAB_EVENT_TICK, time);
+	}
+	case SLAB_EVENT_RGB: {
+		struct rgb16_value rgb;
+
+		memcpy(&rgb, &entry[1], sizeof(rgb));
+		return slab_event_create_rgb16(rgb);
+	}
+	case SLAB_EVENT_HSV: {
+		struct hsv_value hsv;
+		uint16_t h;
+
+		memcpy(&h, &entry[1], sizeof(h));
+		hsv.h = COLOR_NUM_FROM_INT(h) / HUE_SCALE;
+		hsv.s = COLOR_NUM_FROM_INT(entry[3]) / UINT8_MAX;
+		hsv.v = COLOR_NUM_FROM_INT(entry[4]) / UINT8_MAX;
+		return slab_event_create(SLAB_EVENT_HSV, hsv);
+	}
+	case SLAB_EVENT_RGB_FRAME:
+	case SLAB_EVENT_HSV_FRAME: {
+		uint16_t packed[2];
+
+		memcpy(packed, &entry[1], sizeof(packed));
+		return slab_event_create(entry[0], &frames->buf[packed[0] * frames->frame_size],
+					 (uint32_t)packed[1]);
+	}
+	default:
+		return NULL;
+	}
+}
+
+/* Put an entry into the delay line and take out the entry put in length
+ * periods ago. Returns false while the line is still filling up.
+ */
+static bool process_delay(struct slab_delay *slab, const uint8_t *entry_in, uint8_t *entry_out)
+{
+	struct rbuf_sizes sizes;
+	size_t len = SLAB_DELAY_ENTRY_SIZE;
+	bool full;
+
+	rbuf_sizes_get(&slab->line, &sizes);
+	full = (sizes.free < SLAB_DELAY_ENTRY_SIZE);
+
+	if (full) {
+		rbuf_get(&slab->line, entry_out, &len, 0);
+	}
+
+	len = SLAB_DELAY_ENTRY_SIZE;
+	rbuf_add(&slab->line, entry_in, &len, 0);
+
+	return full;
 }
 
 struct slab *slab_delay_create(uint32_t delay_periods)
@@ -31,12 +190,14 @@ struct slab *slab_delay_create(uint32_t delay_periods)
 	struct slab_delay *new_slab = k_malloc(sizeof(struct slab_delay));
 	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
 
-	new_slab->queue = k_malloc(sizeof(struct slab_event *)*delay_periods);
-	__ASSERT(new_slab->queue != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
-	
-	new_slab->length = delay_periods;
+	uint8_t *line = k_malloc(delay_periods * SLAB_DELAY_ENTRY_SIZE);
+	__ASSERT(line != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	__ASSERT(delay_periods * SLAB_DELAY_ENTRY_SIZE <= UINT16_MAX, "Delay too long");
+
+	rbuf_init(&new_slab->line, line, delay_periods * SLAB_DELAY_ENTRY_SIZE, 0);
 
-	reset_queue(new_slab);
+	new_slab->length = delay_periods;
+	new_slab->frames = (struct slab_delay_frames)SLAB_DELAY_FRAMES_INITIALIZER(delay_periods + 1);
 
 	return ((struct slab *)new_slab);
 }
@@ -45,7 +206,8 @@ void slab_delay_destroy(struct slab *slab)
 {
 	struct slab_delay *delay = (struct slab_delay *)slab;
 
-	k_free(delay->queue);
+	k_free(delay->line.buf);
+	k_free(delay->frames.buf);
 
 	k_free(delay);
 }
@@ -56,15 +218,29 @@ void slab_delay_stim(struct slab *slab, struct slab_event *evt)
 
 	switch (evt->id) {
 	case SLAB_EVENT_RESET:
-		reset_queue(delay_slab);
+		reset_line(delay_slab);
 		slab_stim_childs(slab, evt);
 		break;
 
 	case SLAB_EVENT_RGB:
 	case SLAB_EVENT_HSV:
-	case SLAB_EVENT_TICK: {
-		struct slab_event *evt_to_send = (struct slab_event *)process_delay(delay_slab, evt);
+	case SLAB_EVENT_TICK:
+	case SLAB_EVENT_RGB_FRAME:
+	case SLAB_EVENT_HSV_FRAME: {
+		uint8_t entry_in[SLAB_DELAY_ENTRY_SIZE];
+		uint8_t entry_out[SLAB_DELAY_ENTRY_SIZE];
+		struct slab_event *evt_to_send;
+
+		pack_entry(&delay_slab->frames, evt, entry_in);
+		slab_event_release(evt);
+
+		if (!process_delay(delay_slab, entry_in, entry_out)) {
+			break;
+		}
+
+		evt_to_send = unpack_entry(&delay_slab->frames, entry_out);
 		if (evt_to_send != NULL) {
+			slab_event_acquire(evt_to_send);
 			slab_stim_childs(slab, evt_to_send);
 		}
 		break;
@@ -73,3 +249,160 @@ void slab_delay_stim(struct slab *slab, struct slab_event *evt)
 		slab_stim_childs(slab, evt);
 	}
 }
+
+static void static_deinit(struct slab *slab)
+{
+	struct slab_delay *delay = (struct slab_delay *)slab;
+
+	reset_line(delay);
+	free_frames(&delay->frames);
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	uint32_t delay_periods = va_arg(*args, uint32_t);
+
+	return slab_delay_create(delay_periods);
+}
+
+SLAB_TYPE_DEFINE(slab_type_delay, SLAB_TYPE_DELAY, create_from_args,
+		 slab_delay_destroy, slab_delay_stim, NULL, static_deinit);
+
+/*=============================[Tapped delay]=================================*/
+/* Put an entry into the history, dropping the oldest entry once it holds
+ * depth entries.
+ */
+static void push_history(struct slab_tapped_delay *slab, const uint8_t *entry)
+{
+	struct rbuf_sizes sizes;
+	uint8_t oldest[SLAB_DELAY_ENTRY_SIZE];
+	size_t len = SLAB_DELAY_ENTRY_SIZE;
+
+	rbuf_sizes_get(&slab->history, &sizes);
+	if (sizes.free < SLAB_DELAY_ENTRY_SIZE) {
+		rbuf_get(&slab->history, oldest, &len, 0);
+	}
+
+	len = SLAB_DELAY_ENTRY_SIZE;
+	rbuf_add(&slab->history, entry, &len, 0);
+}
+
+/* Read the entry put into the history tap periods ago.
+ * Returns false while the history is shorter than the tap.
+ */
+static bool read_tap(struct slab_tapped_delay *slab, uint16_t tap, uint8_t *entry)
+{
+	struct rbuf_sizes sizes;
+	size_t len = SLAB_DELAY_ENTRY_SIZE;
+	size_t offset = ((size_t)tap + 1) * SLAB_DELAY_ENTRY_SIZE;
+
+	rbuf_sizes_get(&slab->history, &sizes);
+	if (sizes.used < offset) {
+		return false;
+	}
+
+	return (rbuf_peek(&slab->history, entry, &len, sizes.used - offset,
+			  RBUF_OPT_NO_PARTIAL_READ) == RBUF_SUCCESS);
+}
+
+struct slab *slab_tapped_delay_create(const uint16_t *taps, uint16_t num_taps)
+{
+	struct slab_tapped_delay *new_slab = k_malloc(sizeof(struct slab_tapped_delay));
+	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+
+	uint16_t *new_taps = k_malloc(num_taps * sizeof(uint16_t));
+	__ASSERT(new_taps != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+
+	uint32_t depth = 1;
+
+	for (int i = 0; i < num_taps; i++) {
+		new_taps[i] = taps[i];
+		depth = MAX(depth, (uint32_t)taps[i] + 1);
+	}
+
+	uint8_t *history = k_malloc(depth * SLAB_DELAY_ENTRY_SIZE);
+	__ASSERT(history != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	__ASSERT(depth * SLAB_DELAY_ENTRY_SIZE <= UINT16_MAX, "Tap too long");
+
+	rbuf_init(&new_slab->history, history, depth * SLAB_DELAY_ENTRY_SIZE, 0);
+
+	new_slab->depth = depth;
+	new_slab->taps = new_taps;
+	new_slab->num_taps = num_taps;
+	new_slab->frames = (struct slab_delay_frames)SLAB_DELAY_FRAMES_INITIALIZER(depth + 1);
+
+	return ((struct slab *)new_slab);
+}
+
+void slab_tapped_delay_destroy(struct slab *slab)
+{
+	struct slab_tapped_delay *delay = (struct slab_tapped_delay *)slab;
+
+	k_free(delay->history.buf);
+	k_free((void *)delay->taps);
+	k_free(delay->frames.buf);
+
+	k_free(delay);
+}
+
+void slab_tapped_delay_stim(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_tapped_delay *delay_slab = (struct slab_tapped_delay *)slab;
+
+	switch (evt->id) {
+	case SLAB_EVENT_RESET:
+		rbuf_reset(&delay_slab->history, false);
+		slab_stim_childs(slab, evt);
+		break;
+
+	case SLAB_EVENT_RGB:
+	case SLAB_EVENT_HSV:
+	case SLAB_EVENT_TICK:
+	case SLAB_EVENT_RGB_FRAME:
+	case SLAB_EVENT_HSV_FRAME: {
+		uint8_t entry[SLAB_DELAY_ENTRY_SIZE];
+		uint16_t num_outputs = MIN(delay_slab->num_taps, slab->childs.num);
+
+		pack_entry(&delay_slab->frames, evt, entry);
+		slab_event_release(evt);
+
+		push_history(delay_slab, entry);
+
+		for (uint16_t i = 0; i < num_outputs; i++) {
+			struct slab_event *evt_to_send;
+
+			if (!read_tap(delay_slab, delay_slab->taps[i], entry)) {
+				continue;
+			}
+
+			evt_to_send = unpack_entry(&delay_slab->frames, entry);
+			if (evt_to_send != NULL) {
+				slab_event_acquire(evt_to_send);
+				slab_stim_child(slab, i, evt_to_send);
+			}
+		}
+		break;
+	}
+	default:
+		slab_stim_childs(slab, evt);
+	}
+}
+
+static void tapped_static_deinit(struct slab *slab)
+{
+	struct slab_tapped_delay *delay = (struct slab_tapped_delay *)slab;
+
+	rbuf_reset(&delay->history, false);
+	free_frames(&delay->frames);
+}
+
+static struct slab *tapped_create_from_args(va_list *args)
+{
+	const uint16_t *taps = va_arg(*args, const uint16_t *);
+	uint32_t num_taps = va_arg(*args, uint32_t);
+
+	return slab_tapped_delay_create(taps, num_taps);
+}
+
+SLAB_TYPE_DEFINE(slab_type_tapped_delay, SLAB_TYPE_TAPPED_DELAY, tapped_create_from_args,
+		 slab_tapped_delay_destroy, slab_tapped_delay_stim, NULL, tapped_static_deinit);
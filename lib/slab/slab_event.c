@@ -1,75 +1,270 @@
+#include <zephyr/kernel.h>
+
 #include "slab_event.h"
+#include "events/slab_event_pool.h"
 #include "events/slab_event_reset.h"
 #include "events/slab_event_tick.h"
 #include "events/slab_event_rgb.h"
 #include "events/slab_event_hsv.h"
+#include "events/slab_event_rgb_frame.h"
+#include "events/slab_event_hsv_frame.h"
 
-struct slab_event *slab_event_create(enum slab_event_id event_id, ...)
+/*==============================[Event pool]==================================*/
+K_MEM_SLAB_DEFINE_STATIC(reset_slab, sizeof(struct slab_event),
+			 CONFIG_SLAB_EVENT_POOL_RESET_BLOCKS, sizeof(void *));
+K_MEM_SLAB_DEFINE_STATIC(tick_slab, sizeof(struct slab_event_tick),
+			 CONFIG_SLAB_EVENT_POOL_TICK_BLOCKS, sizeof(void *));
+K_MEM_SLAB_DEFINE_STATIC(rgb_slab, sizeof(struct slab_event_rgb),
+			 CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS, sizeof(void *));
+K_MEM_SLAB_DEFINE_STATIC(hsv_slab, sizeof(struct slab_event_hsv),
+			 CONFIG_SLAB_EVENT_POOL_HSV_BLOCKS, sizeof(void *));
+K_MEM_SLAB_DEFINE_STATIC(rgb_frame_slab, sizeof(struct slab_event_rgb_frame),
+			 CONFIG_SLAB_EVENT_POOL_RGB_FRAME_BLOCKS, sizeof(void *));
+K_MEM_SLAB_DEFINE_STATIC(hsv_frame_slab, sizeof(struct slab_event_hsv_frame),
+			 CONFIG_SLAB_EVENT_POOL_HSV_FRAME_BLOCKS, sizeof(void *));
+
+struct event_pool {
+	struct k_mem_slab *slab;
+	uint32_t num_blocks;
+	uint32_t num_used;
+	uint32_t max_used;
+	uint32_t num_exhausted;
+};
+
+/* One size class per event type, indexed by event id. */
+static struct event_pool pools[] = {
+	[SLAB_EVENT_RESET] = {
+		.slab = &reset_slab, .num_blocks = CONFIG_SLAB_EVENT_POOL_RESET_BLOCKS
+	},
+	[SLAB_EVENT_TICK] = {
+		.slab = &tick_slab, .num_blocks = CONFIG_SLAB_EVENT_POOL_TICK_BLOCKS
+	},
+	[SLAB_EVENT_RGB] = {
+		.slab = &rgb_slab, .num_blocks = CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS
+	},
+	[SLAB_EVENT_HSV] = {
+		.slab = &hsv_slab, .num_blocks = CONFIG_SLAB_EVENT_POOL_HSV_BLOCKS
+	},
+	[SLAB_EVENT_RGB_FRAME] = {
+		.slab = &rgb_frame_slab, .num_blocks = CONFIG_SLAB_EVENT_POOL_RGB_FRAME_BLOCKS
+	},
+	[SLAB_EVENT_HSV_FRAME] = {
+		.slab = &hsv_frame_slab, .num_blocks = CONFIG_SLAB_EVENT_POOL_HSV_FRAME_BLOCKS
+	},
+};
+
+static struct k_spinlock pool_lock;
+
+static inline struct event_pool *get_pool(enum slab_event_id event_id)
 {
-	struct slab_event *new_evt;
-	va_list args;
+	if (event_id < SLAB_EVENT_RESET || event_id >= ARRAY_SIZE(pools)) {
+		return NULL;
+	}
 
-	va_start(args, event_id);
+	return &pools[event_id];
+}
+
+void *slab_event_pool_alloc(enum slab_event_id event_id)
+{
+	void *block;
+	k_spinlock_key_t key;
+	struct event_pool *pool = get_pool(event_id);
 
-	switch (event_id) {
-	case SLAB_EVENT_RESET: {
-		new_evt = slab_event_reset_create();
-		break;
+	if (pool == NULL) {
+		return NULL;
 	}
-	case SLAB_EVENT_TICK: {
-		uint32_t time = va_arg(args, uint32_t);
-		new_evt = slab_event_tick_create(time);
-		break;
+
+	if (k_mem_slab_alloc(pool->slab, &block, K_NO_WAIT) != 0) {
+		key = k_spin_lock(&pool_lock);
+		pool->num_exhausted += 1;
+		k_spin_unlock(&pool_lock, key);
+		return NULL;
 	}
-	case SLAB_EVENT_RGB: {
-		struct rgb_value val = va_arg(args, struct rgb_value);
-		new_evt = slab_event_rgb_create(val);
-		break;
+
+	key = k_spin_lock(&pool_lock);
+	pool->num_used += 1;
+	if (pool->num_used > pool->max_used) {
+		pool->max_used = pool->num_used;
 	}
-	case SLAB_EVENT_HSV: {
-		struct hsv_value val = va_arg(args, struct hsv_value);
-		new_evt = slab_event_hsv_create(val);
-		break;
+	k_spin_unlock(&pool_lock, key);
+
+	return block;
+}
+
+void slab_event_pool_free(struct slab_event *evt)
+{
+	k_spinlock_key_t key;
+	struct event_pool *pool = get_pool(evt->id);
+
+	if (pool == NULL) {
+		k_oops();
 	}
-	default:
-		new_evt = NULL;
-		goto clean_exit;
+
+	k_mem_slab_free(pool->slab, (void *)evt);
+
+	key = k_spin_lock(&pool_lock);
+	pool->num_used -= 1;
+	k_spin_unlock(&pool_lock, key);
+}
+
+int slab_event_pool_stats_get(enum slab_event_id event_id, struct slab_event_pool_stats *stats)
+{
+	k_spinlock_key_t key;
+	struct event_pool *pool = get_pool(event_id);
+
+	if (pool == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&pool_lock);
+	stats->num_blocks = pool->num_blocks;
+	stats->num_used = pool->num_used;
+	stats->max_used = pool->max_used;
+	stats->num_exhausted = pool->num_exhausted;
+	k_spin_unlock(&pool_lock, key);
+
+	return 0;
+}
+
+void slab_event_pool_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+	for (int i = SLAB_EVENT_RESET; i < ARRAY_SIZE(pools); i++) {
+		pools[i].max_used = pools[i].num_used;
+		pools[i].num_exhausted = 0;
+	}
+
+	k_spin_unlock(&pool_lock, key);
+}
+
+/*==============================[Event types]=================================*/
+static struct slab_event *reset_create(va_list *args)
+{
+	ARG_UNUSED(args);
+
+	return slab_event_reset_create();
+}
+
+static struct slab_event *tick_create(va_list *args)
+{
+	uint32_t time = va_arg(*args, uint32_t);
+
+	return slab_event_tick_create(time);
+}
+
+static struct slab_event *rgb_create(va_list *args)
+{
+	struct rgb_value val = va_arg(*args, struct rgb_value);
+
+	return slab_event_rgb_create(val);
+}
+
+static struct slab_event *hsv_create(va_list *args)
+{
+	struct hsv_value val = va_arg(*args, struct hsv_value);
+
+	return slab_event_hsv_create(val);
+}
+
+static struct slab_event *rgb_frame_create(va_list *args)
+{
+	const struct rgb_value *pixels = va_arg(*args, const struct rgb_value *);
+	uint32_t num_pixels = va_arg(*args, uint32_t);
+
+	return slab_event_rgb_frame_create(pixels, num_pixels);
+}
+
+static struct slab_event *hsv_frame_create(va_list *args)
+{
+	const struct hsv_value *pixels = va_arg(*args, const struct hsv_value *);
+	uint32_t num_pixels = va_arg(*args, uint32_t);
+
+	return slab_event_hsv_frame_create(pixels, num_pixels);
+}
+
+struct event_type {
+	struct slab_event *(*create)(va_list *args);
+	void (*destroy)(struct slab_event *evt);
+};
+
+/* Indexed by event id, unused ids are left empty. */
+static const struct event_type event_types[] = {
+	[SLAB_EVENT_RESET] = {.create = reset_create, .destroy = slab_event_reset_destroy},
+	[SLAB_EVENT_TICK] = {.create = tick_create, .destroy = slab_event_tick_destroy},
+	[SLAB_EVENT_RGB] = {.create = rgb_create, .destroy = slab_event_rgb_destroy},
+	[SLAB_EVENT_HSV] = {.create = hsv_create, .destroy = slab_event_hsv_destroy},
+	[SLAB_EVENT_RGB_FRAME] = {
+		.create = rgb_frame_create, .destroy = slab_event_rgb_frame_destroy
+	},
+	[SLAB_EVENT_HSV_FRAME] = {
+		.create = hsv_frame_create, .destroy = slab_event_hsv_frame_destroy
+	},
+};
+
+static inline const struct event_type *get_type(enum slab_event_id event_id)
+{
+	if (event_id < SLAB_EVENT_RESET || event_id >= ARRAY_SIZE(event_types) ||
+	    event_types[event_id].create == NULL) {
+		return NULL;
+	}
+
+	return &event_types[event_id];
+}
+
+/*==============================[Public methods]==============================*/
+struct slab_event *slab_event_create(enum slab_event_id event_id, ...)
+{
+	struct slab_event *new_evt;
+	const struct event_type *type = get_type(event_id);
+	va_list args;
+
+	if (type == NULL) {
+		return NULL;
+	}
+
+	va_start(args, event_id);
+	new_evt = type->create(&args);
+	va_end(args);
+
+	if (new_evt == NULL) {
+		return NULL;
 	}
 
 	new_evt->id = event_id;
 	new_evt->num_refs = 0;
 
-clean_exit:
-	va_end(args);
 	return new_evt;
 }
 
-void slab_event_destroy(struct slab_event *evt)
+struct slab_event *slab_event_create_rgb16(struct rgb16_value val)
 {
-	if (evt == NULL) {
-		return;
+	struct slab_event *new_evt = slab_event_rgb16_create(val);
+
+	if (new_evt == NULL) {
+		return NULL;
 	}
 
-	switch (evt->id) {
-	case SLAB_EVENT_RESET:
-		slab_event_reset_destroy(evt);
-		break;
+	new_evt->id = SLAB_EVENT_RGB;
+	new_evt->num_refs = 0;
 
-	case SLAB_EVENT_TICK:
-		slab_event_tick_destroy(evt);
-		break;
+	return new_evt;
+}
 
-	case SLAB_EVENT_RGB:
-		slab_event_rgb_destroy(evt);
-		break;
+void slab_event_destroy(struct slab_event *evt)
+{
+	const struct event_type *type;
 
-	case SLAB_EVENT_HSV:
-		slab_event_hsv_destroy(evt);
-		break;
+	if (evt == NULL) {
+		return;
+	}
 
-	default:
+	type = get_type(evt->id);
+	if (type == NULL) {
 		k_oops();
 	}
+
+	type->destroy(evt);
 }
 
 void slab_event_acquire(struct slab_event *evt)
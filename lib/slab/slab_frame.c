@@ -0,0 +1,86 @@
+#include <zephyr/kernel.h>
+
+#include "slab_event.h"
+#include "slab_frame.h"
+
+/* A buffer is free once the event sent from it is only held by the buffer. */
+static bool is_free(struct slab_frame_buf *buf)
+{
+	if (buf->evt == NULL) {
+		return true;
+	}
+
+	if (buf->evt->num_refs > 1) {
+		return false;
+	}
+
+	slab_event_release(buf->evt);
+	buf->evt = NULL;
+
+	return true;
+}
+
+/* The buffers only grow, so they settle at the largest strip segment. */
+static bool reserve(struct slab_frame_buf *buf, uint32_t num_pixels)
+{
+	struct rgb_value *grown;
+
+	if (num_pixels <= buf->cap) {
+		return true;
+	}
+
+	grown = k_malloc(sizeof(struct rgb_value) * num_pixels);
+	if (grown == NULL) {
+		return false;
+	}
+
+	k_free(buf->pixels);
+	buf->pixels = grown;
+	buf->cap = num_pixels;
+
+	return true;
+}
+
+struct slab_frame_buf *slab_frame_buf_get(struct slab_frame_bufs *bufs, uint32_t num_pixels)
+{
+	for (int i = 0; i < CONFIG_SLAB_FRAME_BUFFERS; i++) {
+		struct slab_frame_buf *buf = &bufs->bufs[i];
+
+		if (is_free(buf)) {
+			return reserve(buf, num_pixels) ? buf : NULL;
+		}
+	}
+
+	return NULL;
+}
+
+struct slab_event *slab_frame_buf_send(struct slab_frame_buf *buf, uint32_t num_pixels)
+{
+	struct slab_event *evt = slab_event_create(SLAB_EVENT_RGB_FRAME, buf->pixels, num_pixels);
+
+	if (evt == NULL) {
+		return NULL;
+	}
+
+	slab_event_acquire(evt);
+	slab_event_acquire(evt);
+	buf->evt = evt;
+
+	return evt;
+}
+
+void slab_frame_bufs_free(struct slab_frame_bufs *bufs)
+{
+	for (int i = 0; i < CONFIG_SLAB_FRAME_BUFFERS; i++) {
+		struct slab_frame_buf *buf = &bufs->bufs[i];
+
+		if (buf->evt != NULL) {
+			slab_event_release(buf->evt);
+			buf->evt = NULL;
+		}
+
+		k_free(buf->pixels);
+		buf->pixels = NULL;
+		buf->cap = 0;
+	}
+}
@@ -0,0 +1,115 @@
+#include <string.h>
+
+#include "slab_event.h"
+#include "slab_frame.h"
+#include "events/slab_event_rgb.h"
+#include "events/slab_event_rgb_frame.h"
+
+#include "slabs/slab_gamma.h"
+
+static void update_lut(struct slab_gamma *slab)
+{
+	struct gamma_config config;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&slab->lock);
+	if (!slab->config_changed) {
+		k_spin_unlock(&slab->lock, key);
+		return;
+	}
+	config = slab->config;
+	slab->config_changed = false;
+	k_spin_unlock(&slab->lock, key);
+
+	gamma_lut_build(&slab->lut, &config);
+}
+
+struct slab *slab_gamma_create(const struct gamma_config *config)
+{
+	struct slab_gamma *new_slab = k_malloc(sizeof(struct slab_gamma));
+	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+
+	new_slab->lock = (struct k_spinlock){};
+	new_slab->config = *config;
+	new_slab->config_changed = true;
+	memset(&new_slab->frames, 0, sizeof(new_slab->frames));
+
+	return ((struct slab *)new_slab);
+}
+
+void slab_gamma_destroy(struct slab *slab)
+{
+	struct slab_gamma *gamma_slab = (struct slab_gamma *)slab;
+
+	slab_frame_bufs_free(&gamma_slab->frames);
+	k_free(gamma_slab);
+}
+
+void slab_gamma_config_set(struct slab *slab, const struct gamma_config *config)
+{
+	struct slab_gamma *gamma_slab = (struct slab_gamma *)slab;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&gamma_slab->lock);
+	gamma_slab->config = *config;
+	gamma_slab->config_changed = true;
+	k_spin_unlock(&gamma_slab->lock, key);
+}
+
+void slab_gamma_stim(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_gamma *gamma_slab = (struct slab_gamma *)slab;
+
+	switch (evt->id) {
+	case SLAB_EVENT_RGB: {
+		update_lut(gamma_slab);
+
+		struct rgb16_value rgb_val = gamma_lut_apply16(&gamma_slab->lut,
+							       slab_event_rgb_get_val16(evt));
+		slab_event_release(evt);
+
+		struct slab_event *rgb_evt = slab_event_create_rgb16(rgb_val);
+		slab_event_acquire(rgb_evt);
+
+		slab_stim_childs(slab, rgb_evt);
+		break;
+	}
+	case SLAB_EVENT_RGB_FRAME: {
+		uint32_t num_pixels;
+		const struct rgb_value *pixels = slab_event_rgb_frame_get_pixels(evt, &num_pixels);
+		struct slab_frame_buf *buf = slab_frame_buf_get(&gamma_slab->frames, num_pixels);
+
+		if (buf == NULL) {
+			slab_event_release(evt);
+			break;
+		}
+
+		update_lut(gamma_slab);
+		gamma_lut_apply_batch(&gamma_slab->lut, pixels, buf->pixels, num_pixels);
+		slab_event_release(evt);
+
+		slab_stim_childs(slab, slab_frame_buf_send(buf, num_pixels));
+		break;
+	}
+	default:
+		slab_stim_childs(slab, evt);
+		break;
+	}
+}
+
+static void static_deinit(struct slab *slab)
+{
+	struct slab_gamma *gamma_slab = (struct slab_gamma *)slab;
+
+	slab_frame_bufs_free(&gamma_slab->frames);
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	const struct gamma_config *config = va_arg(*args, const struct gamma_config *);
+
+	return slab_gamma_create(config);
+}
+
+SLAB_TYPE_DEFINE(slab_type_gamma, SLAB_TYPE_GAMMA, create_from_args,
+		 slab_gamma_destroy, slab_gamma_stim, NULL, static_deinit);
@@ -8,9 +8,9 @@
 #include "glow_func.h"
 
 
-static inline float random_value()
+static inline color_num_t random_value()
 {
-	return (float)(sys_rand32_get() & 0x03FF) / 1024.0f;
+	return COLOR_NUM_FROM_INT(sys_rand32_get() & 0x03FF) / 1024;
 }
 
 
@@ -22,6 +22,7 @@ struct slab *slab_glower_create(struct slab_glower_config *config)
 	new_slab->data.h = config->hue;
 	new_slab->data.s = config->sat;
 	new_slab->data.v = 0;
+	new_slab->config = NULL;
 
 	new_slab->gen = glow_func_create(&(config->val));
 
@@ -49,7 +50,7 @@ void slab_glower_stim(struct slab *slab, struct slab_event *evt)
 
 	case SLAB_EVENT_TICK: {
 		uint32_t time = slab_event_tick_get_time(evt);
-		float rand_val = random_value();
+		color_num_t rand_val = random_value();
 		glower_slab->data.v = glow_func_process(glower_slab->gen, time, rand_val);
 
 		struct slab_event *hsv_evt = slab_event_create(SLAB_EVENT_HSV, glower_slab->data);
@@ -66,3 +67,24 @@ void slab_glower_stim(struct slab *slab, struct slab_event *evt)
 		break;
 	}
 }
+
+static void static_init(struct slab *slab)
+{
+	struct slab_glower *glower_slab = (struct slab_glower *)slab;
+
+	glower_slab->data.h = glower_slab->config->hue;
+	glower_slab->data.s = glower_slab->config->sat;
+	glower_slab->data.v = 0;
+
+	glow_func_reset(glower_slab->gen, &(glower_slab->config->val));
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	struct slab_glower_config *config = va_arg(*args, struct slab_glower_config *);
+
+	return slab_glower_create(config);
+}
+
+SLAB_TYPE_DEFINE(slab_type_glower, SLAB_TYPE_GLOWER, create_from_args,
+		 slab_glower_destroy, slab_glower_stim, static_init, NULL);
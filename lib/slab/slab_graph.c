@@ -0,0 +1,634 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_graph.h"
+#include "slab_priv.h"
+
+#define NODES_INITIAL_CAPACITY 16
+
+/*==============================[Compilation]=================================*/
+static int index_of(struct slab **nodes, int num_nodes, struct slab *slab)
+{
+	for (int i = 0; i < num_nodes; i++) {
+		if (nodes[i] == slab) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static bool append_node(struct slab ***nodes, int *num_nodes, int *capacity, struct slab *slab)
+{
+	struct slab **grown;
+
+	if (*num_nodes == *capacity) {
+		grown = k_malloc(sizeof(struct slab *) * (*capacity) * 2);
+		if (grown == NULL) {
+			return false;
+		}
+
+		memcpy(grown, *nodes, sizeof(struct slab *) * (*num_nodes));
+		k_free(*nodes);
+		*nodes = grown;
+		*capacity *= 2;
+	}
+
+	(*nodes)[*num_nodes] = slab;
+	*num_nodes += 1;
+	return true;
+}
+
+/* Collect all slabs reachable from root in breadth first order. */
+static int collect_nodes(struct slab *root, struct slab ***nodes_out, int *num_nodes_out,
+			 int *num_edges_out)
+{
+	struct slab *child;
+	struct slab **nodes;
+	int capacity = NODES_INITIAL_CAPACITY;
+	int num_nodes = 0;
+	int num_edges = 0;
+
+	nodes = k_malloc(sizeof(struct slab *) * capacity);
+	if (nodes == NULL) {
+		return -ENOMEM;
+	}
+
+	nodes[num_nodes++] = root;
+
+	for (int i = 0; i < num_nodes; i++) {
+		if (nodes[i]->step != NULL) {
+			k_free(nodes);
+			return -EBUSY;
+		}
+
+		for (int j = 0; j < nodes[i]->childs.num; j++) {
+			child = nodes[i]->childs.list[j];
+			num_edges += 1;
+
+			if (index_of(nodes, num_nodes, child) >= 0) {
+				continue;
+			}
+
+			if (!append_node(&nodes, &num_nodes, &capacity, child)) {
+				k_free(nodes);
+				return -ENOMEM;
+			}
+		}
+	}
+
+	*nodes_out = nodes;
+	*num_nodes_out = num_nodes;
+	*num_edges_out = num_edges;
+	return 0;
+}
+
+/* Order nodes so that every slab comes after all of its parents (Kahn's algorithm).
+ *
+ * On return order[i] holds the node index of step i.
+ */
+static int sort_nodes(struct slab **nodes, int num_nodes, uint16_t *order, uint16_t *in_degree)
+{
+	int num_ordered = 0;
+	int num_ready = 0;
+	int child;
+
+	memset(in_degree, 0, sizeof(uint16_t) * num_nodes);
+
+	for (int i = 0; i < num_nodes; i++) {
+		for (int j = 0; j < nodes[i]->childs.num; j++) {
+			in_degree[index_of(nodes, num_nodes, nodes[i]->childs.list[j])] += 1;
+		}
+	}
+
+	for (int i = 0; i < num_nodes; i++) {
+		if (in_degree[i] == 0) {
+			order[num_ready++] = i;
+		}
+	}
+
+	while (num_ordered < num_ready) {
+		struct slab *slab = nodes[order[num_ordered++]];
+
+		for (int j = 0; j < slab->childs.num; j++) {
+			child = index_of(nodes, num_nodes, slab->childs.list[j]);
+
+			in_degree[child] -= 1;
+			if (in_degree[child] == 0) {
+				order[num_ready++] = child;
+			}
+		}
+	}
+
+	/* Nodes on a cycle never reach an in-degree of zero. */
+	return (num_ordered == num_nodes) ? 0 : -ELOOP;
+}
+
+static void build_schedule(struct slab_graph *graph, struct slab **nodes, int num_nodes,
+			   const uint16_t *order, uint16_t *step_of_node)
+{
+	struct slab_childs *childs;
+	struct slab_graph_step *step;
+	uint16_t edge = 0;
+
+	for (int i = 0; i < num_nodes; i++) {
+		step_of_node[order[i]] = i;
+	}
+
+	for (int i = 0; i < num_nodes; i++) {
+		step = &graph->steps[i];
+
+		step->graph = graph;
+		step->slab = nodes[order[i]];
+		step->first_edge = edge;
+		step->head = 0;
+		step->count = 0;
+
+		childs = &step->slab->childs;
+		for (int j = 0; j < childs->num; j++) {
+			graph->edges[edge] = step_of_node[index_of(nodes, num_nodes, childs->list[j])];
+			graph->edge_masks[edge] = childs->masks[j];
+			edge += 1;
+		}
+
+		step->num_edges = edge - step->first_edge;
+	}
+}
+
+/*==============================[Evaluation]==================================*/
+static void enqueue(struct slab_graph *graph, struct slab_graph_step *step, struct slab_event *evt)
+{
+	uint16_t step_idx = step - graph->steps;
+
+	/* The reference held by the caller is moved into the inbox. */
+	if (step->count >= CONFIG_SLAB_GRAPH_INBOX_SIZE) {
+		graph->num_dropped += 1;
+		slab_event_release(evt);
+		return;
+	}
+
+	step->inbox[(step->head + step->count) % CONFIG_SLAB_GRAPH_INBOX_SIZE] = evt;
+	step->count += 1;
+
+	if (step_idx < graph->next) {
+		graph->next = step_idx;
+	}
+}
+
+static struct slab_event *dequeue(struct slab_graph_step *step)
+{
+	struct slab_event *evt = step->inbox[step->head];
+
+	step->head = (step->head + 1) % CONFIG_SLAB_GRAPH_INBOX_SIZE;
+	step->count -= 1;
+
+	return evt;
+}
+
+static void evaluate(struct slab_graph *graph)
+{
+	struct slab_graph_step *step;
+
+	graph->running = true;
+
+	/* Parents always come before their childs in the schedule, so events
+	 * emitted by a slab are picked up later in the same pass.
+	 */
+	while (graph->next < graph->num_steps) {
+		step = &graph->steps[graph->next];
+
+		if (step->count == 0) {
+			graph->next += 1;
+			continue;
+		}
+
+		slab_dispatch(step->slab, dequeue(step));
+	}
+
+	graph->running = false;
+}
+
+void slab_graph_stim(struct slab_graph_step *step, struct slab_event *evt)
+{
+	struct slab_graph *graph = step->graph;
+
+	k_mutex_lock(&graph->lock, K_FOREVER);
+
+	enqueue(graph, step, evt);
+
+	if (!graph->running) {
+		evaluate(graph);
+	}
+
+	k_mutex_unlock(&graph->lock);
+}
+
+void slab_graph_stim_childs(struct slab_graph_step *step, struct slab_event *evt)
+{
+	struct slab_graph *graph = step->graph;
+	const uint16_t *edges = &graph->edges[step->first_edge];
+	const slab_event_mask_t *masks = &graph->edge_masks[step->first_edge];
+	slab_event_mask_t evt_mask = SLAB_EVENT_MASK(evt->id);
+
+	k_mutex_lock(&graph->lock, K_FOREVER);
+
+	for (int i = 0; i < step->num_edges; i++) {
+		if (!(masks[i] & evt_mask)) {
+			continue;
+		}
+
+		slab_event_acquire(evt);
+		enqueue(graph, &graph->steps[edges[i]], evt);
+	}
+
+	slab_event_release(evt);
+
+	if (!graph->running) {
+		evaluate(graph);
+	}
+
+	k_mutex_unlock(&graph->lock);
+}
+
+/*===============================[Binding]====================================*/
+/* Initialize the evaluation state of a graph whose steps and edges have been
+ * set up, then schedule the nodes and bind them to their steps.
+ */
+static void bind_schedule(struct slab_graph *graph, struct slab **nodes, int num_nodes,
+			  int num_edges, uint16_t *scratch)
+{
+	graph->num_steps = num_nodes;
+	graph->num_edges = num_edges;
+	graph->running = false;
+	graph->next = graph->num_steps;
+	graph->num_dropped = 0;
+	k_mutex_init(&graph->lock);
+
+	build_schedule(graph, nodes, num_nodes, &scratch[0], &scratch[num_nodes]);
+
+	for (int i = 0; i < graph->num_steps; i++) {
+		graph->steps[i].slab->step = &graph->steps[i];
+	}
+}
+
+static void drain_and_unbind(struct slab_graph *graph)
+{
+	struct slab_graph_step *step;
+
+	for (int i = 0; i < graph->num_steps; i++) {
+		step = &graph->steps[i];
+
+		while (step->count > 0) {
+			slab_event_release(dequeue(step));
+		}
+
+		step->slab->step = NULL;
+	}
+}
+
+/*=============================[Static graphs]================================*/
+static int add_static_node(struct slab_static_graph *sg, int *num_nodes, struct slab *slab)
+{
+	if (index_of(sg->nodes, *num_nodes, slab) >= 0) {
+		return 0;
+	}
+
+	if (*num_nodes >= sg->max_nodes) {
+		return -ENOMEM;
+	}
+
+	if (slab->step != NULL || slab->childs.num != 0) {
+		return -EBUSY;
+	}
+
+	sg->nodes[(*num_nodes)++] = slab;
+	return 0;
+}
+
+/* The edges form one connected graph if every node is reached from the
+ * first one, following edges in either direction.
+ */
+static bool is_connected(struct slab_static_graph *sg, int num_nodes, uint16_t *reached)
+{
+	int num_reached = 1;
+	bool grown = true;
+	int parent;
+	int child;
+
+	if (num_nodes == 0) {
+		return true;
+	}
+
+	memset(reached, 0, sizeof(uint16_t) * num_nodes);
+	reached[0] = 1;
+
+	while (grown) {
+		grown = false;
+
+		for (int j = 0; j < sg->num_edges; j++) {
+			parent = index_of(sg->nodes, num_nodes, sg->edges[j].parent);
+			child = index_of(sg->nodes, num_nodes, sg->edges[j].child);
+
+			if (reached[parent] != reached[child]) {
+				reached[parent] = 1;
+				reached[child] = 1;
+				num_reached += 1;
+				grown = true;
+			}
+		}
+	}
+
+	return num_reached == num_nodes;
+}
+
+/* Point the child set of every node at its part of the childs storage and
+ * fill it in edge order. The masks of duplicate edges are merged. Returns
+ * the number of distinct edges.
+ */
+static int connect_static_nodes(struct slab_static_graph *sg, int num_nodes)
+{
+	const struct slab_edge *edge;
+	struct slab_childs *childs;
+	int offset = 0;
+	int num_edges = 0;
+	int idx;
+
+	for (int i = 0; i < num_nodes; i++) {
+		childs = &sg->nodes[i]->childs;
+		childs->list = &sg->childs[offset];
+		childs->masks = &sg->child_masks[offset];
+		childs->num = 0;
+		childs->cap = 0;
+
+		for (int j = 0; j < sg->num_edges; j++) {
+			if (sg->edges[j].parent == sg->nodes[i]) {
+				childs->cap += 1;
+			}
+		}
+
+		offset += childs->cap;
+	}
+
+	for (int j = 0; j < sg->num_edges; j++) {
+		edge = &sg->edges[j];
+		childs = &edge->parent->childs;
+
+		idx = index_of(childs->list, childs->num, edge->child);
+		if (idx >= 0) {
+			childs->masks[idx] |= edge->mask;
+			continue;
+		}
+
+		childs->list[childs->num] = edge->child;
+		childs->masks[childs->num] = edge->mask;
+		childs->num += 1;
+		num_edges += 1;
+	}
+
+	return num_edges;
+}
+
+static void init_static_nodes(struct slab_static_graph *sg)
+{
+	struct slab *slab;
+
+	for (int i = 0; i < sg->graph.num_steps; i++) {
+		slab = sg->graph.steps[i].slab;
+
+		if (slab->api->init != NULL) {
+			slab->api->init(slab);
+		}
+	}
+}
+
+static void deinit_static_nodes(struct slab_static_graph *sg)
+{
+	struct slab *slab;
+
+	for (int i = 0; i < sg->graph.num_steps; i++) {
+		slab = sg->graph.steps[i].slab;
+
+		if (slab->api->deinit != NULL) {
+			slab->api->deinit(slab);
+		}
+	}
+}
+
+static void disconnect_static_nodes(struct slab_static_graph *sg, int num_nodes)
+{
+	for (int i = 0; i < num_nodes; i++) {
+		sg->nodes[i]->childs.list = NULL;
+		sg->nodes[i]->childs.masks = NULL;
+		sg->nodes[i]->childs.num = 0;
+		sg->nodes[i]->childs.cap = 0;
+	}
+}
+
+/*==============================[Public methods]==============================*/
+int slab_graph_compile(struct slab_graph *graph, struct slab *root)
+{
+	int err;
+	struct slab **nodes;
+	uint16_t *scratch;
+	int num_nodes;
+	int num_edges;
+
+	if (graph == NULL || root == NULL) {
+		return -EINVAL;
+	}
+
+	err = collect_nodes(root, &nodes, &num_nodes, &num_edges);
+	if (err) {
+		return err;
+	}
+
+	if (num_nodes > UINT16_MAX || num_edges > UINT16_MAX) {
+		err = -ENOMEM;
+		goto free_nodes;
+	}
+
+	/* Scratch holds the sorted order and the in-degree (later step index) per node. */
+	scratch = k_malloc(sizeof(uint16_t) * num_nodes * 2);
+	if (scratch == NULL) {
+		err = -ENOMEM;
+		goto free_nodes;
+	}
+
+	err = sort_nodes(nodes, num_nodes, &scratch[0], &scratch[num_nodes]);
+	if (err) {
+		goto free_scratch;
+	}
+
+	/* Steps, edges and edge masks share one contiguous allocation. */
+	graph->steps = k_malloc(sizeof(struct slab_graph_step) * num_nodes +
+				(sizeof(uint16_t) + sizeof(slab_event_mask_t)) * num_edges);
+	if (graph->steps == NULL) {
+		err = -ENOMEM;
+		goto free_scratch;
+	}
+
+	graph->edges = (uint16_t *)&graph->steps[num_nodes];
+	graph->edge_masks = (slab_event_mask_t *)&graph->edges[num_edges];
+	bind_schedule(graph, nodes, num_nodes, num_edges, scratch);
+
+free_scratch:
+	k_free(scratch);
+free_nodes:
+	k_free(nodes);
+	return err;
+}
+
+void slab_graph_release(struct slab_graph *graph)
+{
+	if (graph == NULL || graph->steps == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&graph->lock, K_FOREVER);
+
+	drain_and_unbind(graph);
+
+	k_free(graph->steps);
+	graph->steps = NULL;
+	graph->edges = NULL;
+	graph->edge_masks = NULL;
+	graph->num_steps = 0;
+	graph->num_edges = 0;
+	graph->next = 0;
+
+	k_mutex_unlock(&graph->lock);
+}
+
+int slab_graph_start(struct slab_static_graph *sg)
+{
+	int err = 0;
+	int num_nodes = 0;
+	int num_edges;
+
+	if (sg == NULL) {
+		return -EINVAL;
+	}
+
+	if (sg->graph.steps != NULL) {
+		return -EBUSY;
+	}
+
+	for (int i = 0; i < sg->num_edges && !err; i++) {
+		err = add_static_node(sg, &num_nodes, sg->edges[i].parent);
+		if (!err) {
+			err = add_static_node(sg, &num_nodes, sg->edges[i].child);
+		}
+	}
+
+	if (err) {
+		return err;
+	}
+
+	if (!is_connected(sg, num_nodes, sg->scratch)) {
+		return -EINVAL;
+	}
+
+	num_edges = connect_static_nodes(sg, num_nodes);
+
+	err = sort_nodes(sg->nodes, num_nodes, &sg->scratch[0], &sg->scratch[num_nodes]);
+	if (err) {
+		disconnect_static_nodes(sg, num_nodes);
+		return err;
+	}
+
+	sg->graph.steps = sg->steps;
+	sg->graph.edges = sg->step_edges;
+	sg->graph.edge_masks = sg->step_edge_masks;
+	sg->paused = false;
+	bind_schedule(&sg->graph, sg->nodes, num_nodes, num_edges, sg->scratch);
+
+	/* Slabs are only started once bound, so events they emit from their own
+	 * context are evaluated through the schedule.
+	 */
+	init_static_nodes(sg);
+
+	return 0;
+}
+
+void slab_graph_stop(struct slab_static_graph *sg)
+{
+	struct slab_graph *graph;
+	int num_nodes;
+
+	if (sg == NULL || sg->graph.steps == NULL) {
+		return;
+	}
+
+	graph = &sg->graph;
+	num_nodes = graph->num_steps;
+
+	/* Deinit outside of the lock, as it may wait for work that stims the graph.
+	 * Paused graphs have already been deinitialized.
+	 */
+	if (!sg->paused) {
+		deinit_static_nodes(sg);
+	}
+
+	k_mutex_lock(&graph->lock, K_FOREVER);
+
+	drain_and_unbind(graph);
+	disconnect_static_nodes(sg, num_nodes);
+
+	graph->steps = NULL;
+	graph->edges = NULL;
+	graph->edge_masks = NULL;
+	graph->num_steps = 0;
+	graph->num_edges = 0;
+	graph->next = 0;
+
+	k_mutex_unlock(&graph->lock);
+}
+
+int slab_graph_pause(struct slab_static_graph *sg)
+{
+	struct slab_graph_step *step;
+
+	if (sg == NULL || sg->graph.steps == NULL) {
+		return -EINVAL;
+	}
+
+	if (sg->paused) {
+		return -EALREADY;
+	}
+
+	deinit_static_nodes(sg);
+
+	k_mutex_lock(&sg->graph.lock, K_FOREVER);
+
+	for (int i = 0; i < sg->graph.num_steps; i++) {
+		step = &sg->graph.steps[i];
+
+		while (step->count > 0) {
+			slab_event_release(dequeue(step));
+		}
+	}
+	sg->graph.next = sg->graph.num_steps;
+	sg->paused = true;
+
+	k_mutex_unlock(&sg->graph.lock);
+
+	return 0;
+}
+
+int slab_graph_resume(struct slab_static_graph *sg)
+{
+	if (sg == NULL || sg->graph.steps == NULL) {
+		return -EINVAL;
+	}
+
+	if (!sg->paused) {
+		return -EALREADY;
+	}
+
+	sg->paused = false;
+	init_static_nodes(sg);
+
+	return 0;
+}
@@ -1,38 +1,83 @@
+#include <string.h>
+
 #include "slab_event.h"
+#include "slab_frame.h"
 #include "events/slab_event_hsv.h"
+#include "events/slab_event_hsv_frame.h"
 
 #include "slabs/slab_hsv2rgb.h"
 
 struct slab *slab_hsv2rgb_create(void)
 {
-	struct slab *new_slab = k_malloc(sizeof(struct slab));
+	struct slab_hsv2rgb *new_slab = k_malloc(sizeof(struct slab_hsv2rgb));
 	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
 
-	return new_slab;
+	memset(&new_slab->frames, 0, sizeof(new_slab->frames));
+
+	return ((struct slab *)new_slab);
 }
 
 void slab_hsv2rgb_destroy(struct slab *slab)
 {
-	k_free(slab);
+	struct slab_hsv2rgb *hsv2rgb_slab = (struct slab_hsv2rgb *)slab;
+
+	slab_frame_bufs_free(&hsv2rgb_slab->frames);
+	k_free(hsv2rgb_slab);
 }
 
 void slab_hsv2rgb_stim(struct slab *slab, struct slab_event *evt)
 {
+	struct slab_hsv2rgb *hsv2rgb_slab = (struct slab_hsv2rgb *)slab;
+
 	switch (evt->id) {
 	case SLAB_EVENT_HSV: {
 		struct hsv_value hsv_val = slab_event_hsv_get_val(evt);
 		slab_event_release(evt);
 
-		struct rgb_value rgb_val = hsv2rgb(hsv_val);
+		/* The fraction is kept for dithering at the LEDs. */
+		struct rgb16_value rgb_val = hsv2rgb16(hsv_val);
 
-		struct slab_event *rgb_evt = slab_event_create(SLAB_EVENT_RGB, rgb_val);
+		struct slab_event *rgb_evt = slab_event_create_rgb16(rgb_val);
 		slab_event_acquire(rgb_evt);
 
 		slab_stim_childs(slab, rgb_evt);
 		break;
 	}
+	case SLAB_EVENT_HSV_FRAME: {
+		uint32_t num_pixels;
+		const struct hsv_value *hsv_pixels = slab_event_hsv_frame_get_pixels(evt, &num_pixels);
+		struct slab_frame_buf *buf = slab_frame_buf_get(&hsv2rgb_slab->frames, num_pixels);
+
+		if (buf == NULL) {
+			slab_event_release(evt);
+			break;
+		}
+
+		hsv2rgb_batch(hsv_pixels, buf->pixels, num_pixels);
+		slab_event_release(evt);
+
+		slab_stim_childs(slab, slab_frame_buf_send(buf, num_pixels));
+		break;
+	}
 	default:
 		slab_stim_childs(slab, evt);
 		break;
 	}
 }
+
+static void static_deinit(struct slab *slab)
+{
+	struct slab_hsv2rgb *hsv2rgb_slab = (struct slab_hsv2rgb *)slab;
+
+	slab_frame_bufs_free(&hsv2rgb_slab->frames);
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	ARG_UNUSED(args);
+
+	return slab_hsv2rgb_create();
+}
+
+SLAB_TYPE_DEFINE(slab_type_hsv2rgb, SLAB_TYPE_HSV2RGB, create_from_args,
+		 slab_hsv2rgb_destroy, slab_hsv2rgb_stim, NULL, static_deinit);
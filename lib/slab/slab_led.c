@@ -1,8 +1,26 @@
 #include "slab_event.h"
+#include "slab_stats.h"
 #include "events/slab_event_rgb.h"
+#include "events/slab_event_rgb_frame.h"
 
 #include "slabs/slab_led.h"
 
+static slab_led_written_cb written_cb;
+
+void slab_led_written_cb_set(slab_led_written_cb cb)
+{
+	written_cb = cb;
+}
+
+static void led_written(struct slab_led *slab)
+{
+	slab_stats_led_written();
+
+	if (written_cb != NULL) {
+		written_cb(slab->led);
+	}
+}
+
 struct slab *slab_led_create(void *led_buf, enum led_type type)
 {
 	struct slab_led *new_slab = k_malloc(sizeof(struct slab_led));
@@ -10,6 +28,19 @@ struct slab *slab_led_create(void *led_buf, enum led_type type)
 
 	new_slab->led = led_buf;
 	new_slab->led_type = type;
+	new_slab->num_leds = 1;
+	new_slab->first_pixel = 0;
+
+	return ((struct slab *)new_slab);
+}
+
+struct slab *slab_led_strip_create(void *led_buf, uint16_t first_pixel, uint16_t num_leds,
+				   enum led_type type)
+{
+	struct slab_led *new_slab = (struct slab_led *)slab_led_create(led_buf, type);
+
+	new_slab->num_leds = num_leds;
+	new_slab->first_pixel = first_pixel;
 
 	return ((struct slab *)new_slab);
 }
@@ -19,31 +50,67 @@ void slab_led_destroy(struct slab *slab)
 	k_free(slab);
 }
 
-static inline void write_led_buffer(struct slab_led *slab, struct rgb_value *val)
+void slab_led_set_buffer(struct slab *slab, void *led_buf)
+{
+	struct slab_led *led_slab = (struct slab_led *)slab;
+
+	led_slab->led = led_buf;
+}
+
+static inline size_t led_size(enum led_type type)
+{
+	switch (type) {
+	case LED_TYPE_RGB:
+	case LED_TYPE_GRB:
+		return 3;
+	case LED_TYPE_RGB16:
+	case LED_TYPE_GRB16:
+		return 3 * sizeof(uint16_t);
+	default:
+		return 1;
+	}
+}
+
+static inline void write_led_buffer(uint8_t *led, enum led_type type,
+				    const struct rgb16_value *val)
 {
-	switch (slab->led_type) {
+	uint16_t *led16 = (uint16_t *)led;
+
+	switch (type) {
 	case LED_TYPE_RGB:
-		slab->led[0] = val->g;
-		slab->led[1] = val->r;
-		slab->led[2] = val->b;
+		led[0] = val->g >> 8;
+		led[1] = val->r >> 8;
+		led[2] = val->b >> 8;
 		break;
 
 	case LED_TYPE_GRB:
-		slab->led[0] = val->r;
-		slab->led[1] = val->g;
-		slab->led[2] = val->b;
+		led[0] = val->r >> 8;
+		led[1] = val->g >> 8;
+		led[2] = val->b >> 8;
 		break;
 
 	case LED_TYPE_RED:
-		slab->led[0] = val->r;
+		led[0] = val->r >> 8;
 		break;
 
 	case LED_TYPE_GREEN:
-		slab->led[0] = val->g;
+		led[0] = val->g >> 8;
 		break;
 
 	case LED_TYPE_BLUE:
-		slab->led[0] = val->b;
+		led[0] = val->b >> 8;
+		break;
+
+	case LED_TYPE_RGB16:
+		led16[0] = val->g;
+		led16[1] = val->r;
+		led16[2] = val->b;
+		break;
+
+	case LED_TYPE_GRB16:
+		led16[0] = val->r;
+		led16[1] = val->g;
+		led16[2] = val->b;
 		break;
 
 	default:
@@ -51,6 +118,28 @@ static inline void write_led_buffer(struct slab_led *slab, struct rgb_value *val
 	}
 }
 
+static void write_frame(struct slab_led *slab, const struct rgb_value *pixels,
+			uint32_t num_pixels)
+{
+	size_t stride = led_size(slab->led_type);
+	uint32_t num_leds;
+	struct rgb16_value val;
+
+	if (slab->first_pixel >= num_pixels) {
+		return;
+	}
+
+	num_leds = MIN(slab->num_leds, num_pixels - slab->first_pixel);
+	pixels = &pixels[slab->first_pixel];
+
+	for (uint32_t i = 0; i < num_leds; i++) {
+		val.r = pixels[i].r << 8;
+		val.g = pixels[i].g << 8;
+		val.b = pixels[i].b << 8;
+		write_led_buffer(&slab->led[i * stride], slab->led_type, &val);
+	}
+}
+
 void slab_led_stim(struct slab *slab, struct slab_event *evt)
 {
 	struct slab_led *led_slab = (struct slab_led *)slab;
@@ -58,8 +147,24 @@ void slab_led_stim(struct slab *slab, struct slab_event *evt)
 	switch (evt->id) {
 	case SLAB_EVENT_RGB:
 		if (led_slab->led != NULL) {
-			struct rgb_value rgb_val = slab_event_rgb_get_val(evt);
-			write_led_buffer(led_slab, &rgb_val);
+			struct rgb16_value rgb_val = slab_event_rgb_get_val16(evt);
+			size_t stride = led_size(led_slab->led_type);
+
+			for (uint32_t i = 0; i < led_slab->num_leds; i++) {
+				write_led_buffer(&led_slab->led[i * stride], led_slab->led_type,
+						 &rgb_val);
+			}
+			led_written(led_slab);
+		}
+		slab_stim_childs(slab, evt);
+		break;
+
+	case SLAB_EVENT_RGB_FRAME:
+		if (led_slab->led != NULL) {
+			uint32_t num_pixels;
+			const struct rgb_value *pixels = slab_event_rgb_frame_get_pixels(evt, &num_pixels);
+			write_frame(led_slab, pixels, num_pixels);
+			led_written(led_slab);
 		}
 		slab_stim_childs(slab, evt);
 		break;
@@ -69,3 +174,27 @@ void slab_led_stim(struct slab *slab, struct slab_event *evt)
 		break;
 	}
 }
+
+static struct slab *create_from_args(va_list *args)
+{
+	void *led_buf = va_arg(*args, void *);
+	enum led_type type = va_arg(*args, int);
+
+	return slab_led_create(led_buf, type);
+}
+
+SLAB_TYPE_DEFINE(slab_type_led, SLAB_TYPE_LED, create_from_args,
+		 slab_led_destroy, slab_led_stim, NULL, NULL);
+
+static struct slab *strip_create_from_args(va_list *args)
+{
+	void *led_buf = va_arg(*args, void *);
+	uint32_t first_pixel = va_arg(*args, uint32_t);
+	uint32_t num_leds = va_arg(*args, uint32_t);
+	enum led_type type = va_arg(*args, int);
+
+	return slab_led_strip_create(led_buf, first_pixel, num_leds, type);
+}
+
+SLAB_TYPE_DEFINE(slab_type_led_strip, SLAB_TYPE_LED_STRIP, strip_create_from_args,
+		 slab_led_destroy, slab_led_stim, NULL, NULL);
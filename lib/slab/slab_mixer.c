@@ -0,0 +1,226 @@
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "slab_event.h"
+#include "events/slab_event_rgb.h"
+#include "events/slab_event_hsv.h"
+
+#include "slabs/slab_mixer.h"
+#include "slab_priv.h"
+
+/* x / 255 rounded, for x up to 255 * 255 */
+static inline uint32_t div255(uint32_t x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+static inline uint8_t mix_channel(enum slab_mixer_mode mode, uint8_t a, uint8_t b, uint8_t alpha)
+{
+	switch (mode) {
+	case SLAB_MIXER_ADD:
+		return MIN(a + b, 255);
+	case SLAB_MIXER_MULTIPLY:
+		return div255(a * b);
+	case SLAB_MIXER_MAX:
+		return MAX(a, b);
+	case SLAB_MIXER_CROSSFADE:
+		return div255(a * (255 - alpha) + b * alpha);
+	default:
+		return a;
+	}
+}
+
+/* Combine the ports holding a value, false if none does. */
+static bool mix(const struct slab_mixer *mixer, struct rgb_value *out)
+{
+	bool has_val = false;
+
+	for (uint16_t i = 0; i < mixer->num_ports; i++) {
+		const struct slab_mixer_port *port = &mixer->ports[i];
+
+		if (!port->has_val) {
+			continue;
+		}
+
+		if (!has_val) {
+			*out = port->val;
+			if (mixer->mode == SLAB_MIXER_CROSSFADE) {
+				/* The first port covers black. */
+				out->r = div255(out->r * port->alpha);
+				out->g = div255(out->g * port->alpha);
+				out->b = div255(out->b * port->alpha);
+			}
+			has_val = true;
+			continue;
+		}
+
+		out->r = mix_channel(mixer->mode, out->r, port->val.r, port->alpha);
+		out->g = mix_channel(mixer->mode, out->g, port->val.g, port->alpha);
+		out->b = mix_channel(mixer->mode, out->b, port->val.b, port->alpha);
+	}
+
+	return has_val;
+}
+
+static void clear_ports(struct slab_mixer *mixer)
+{
+	for (uint16_t i = 0; i < mixer->num_ports; i++) {
+		mixer->ports[i].has_val = false;
+	}
+}
+
+struct slab *slab_mixer_create(enum slab_mixer_mode mode, uint16_t num_ports)
+{
+	struct slab_mixer *new_slab = k_malloc(sizeof(struct slab_mixer) +
+					       sizeof(struct slab_mixer_port) * num_ports);
+	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+
+	new_slab->mode = mode;
+	new_slab->num_ports = num_ports;
+	new_slab->ports = (struct slab_mixer_port *)(new_slab + 1);
+
+	/* Set up front, as the ports are connected to the mixer below. */
+	new_slab->type = SLAB_TYPE_MIXER;
+	new_slab->api = &slab_type_mixer;
+	new_slab->step = NULL;
+
+	/* A zeroed port has no childs, see struct slab_childs. */
+	memset(new_slab->ports, 0, sizeof(struct slab_mixer_port) * num_ports);
+	for (uint16_t i = 0; i < num_ports; i++) {
+		new_slab->ports[i].type = SLAB_TYPE_MIXER_PORT;
+		new_slab->ports[i].api = &slab_type_mixer_port;
+		new_slab->ports[i].mixer = new_slab;
+		new_slab->ports[i].alpha = 255;
+
+		/* Passes no events, but orders the port before the mixer in a
+		 * compiled graph, so the mixer sees the values of the same tick.
+		 */
+		slab_connect_mask((struct slab *)new_slab, SLAB_OF(new_slab->ports[i]), 0);
+	}
+
+	return ((struct slab *)new_slab);
+}
+
+void slab_mixer_destroy(struct slab *slab)
+{
+#ifdef CONFIG_SLAB_STATS
+	struct slab_mixer *mixer = (struct slab_mixer *)slab;
+
+	/* The ports are freed with the mixer. */
+	for (uint16_t i = 0; i < mixer->num_ports; i++) {
+		slab_stats_remove((struct slab *)&mixer->ports[i]);
+	}
+#endif
+
+	k_free(slab);
+}
+
+struct slab *slab_mixer_port(struct slab *slab, uint16_t idx)
+{
+	struct slab_mixer *mixer = (struct slab_mixer *)slab;
+
+	if (idx >= mixer->num_ports) {
+		return NULL;
+	}
+
+	return SLAB_OF(mixer->ports[idx]);
+}
+
+void slab_mixer_alpha_set(struct slab *slab, uint16_t idx, uint8_t alpha)
+{
+	struct slab_mixer *mixer = (struct slab_mixer *)slab;
+
+	if (idx < mixer->num_ports) {
+		mixer->ports[idx].alpha = alpha;
+	}
+}
+
+void slab_mixer_stim(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_mixer *mixer = (struct slab_mixer *)slab;
+
+	switch (evt->id) {
+	case SLAB_EVENT_RESET:
+		clear_ports(mixer);
+
+		slab_stim_childs(slab, evt);
+		break;
+
+	case SLAB_EVENT_TICK: {
+		struct rgb_value rgb_val;
+
+		slab_event_release(evt);
+
+		if (!mix(mixer, &rgb_val)) {
+			break;
+		}
+
+		struct slab_event *rgb_evt = slab_event_create(SLAB_EVENT_RGB, rgb_val);
+		slab_event_acquire(rgb_evt);
+
+		slab_stim_childs(slab, rgb_evt);
+		break;
+	}
+
+	default:
+		slab_event_release(evt);
+		break;
+	}
+}
+
+static void port_stim(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_mixer_port *port = (struct slab_mixer_port *)slab;
+
+	switch (evt->id) {
+	case SLAB_EVENT_RESET:
+		port->has_val = false;
+		break;
+	case SLAB_EVENT_RGB:
+		port->val = slab_event_rgb_get_val(evt);
+		port->has_val = true;
+		break;
+	case SLAB_EVENT_HSV:
+		port->val = hsv2rgb(slab_event_hsv_get_val(evt));
+		port->has_val = true;
+		break;
+	default:
+		break;
+	}
+
+	slab_event_release(evt);
+}
+
+static void static_deinit(struct slab *slab)
+{
+	clear_ports((struct slab_mixer *)slab);
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	enum slab_mixer_mode mode = va_arg(*args, int);
+	uint32_t num_ports = va_arg(*args, uint32_t);
+
+	return slab_mixer_create(mode, num_ports);
+}
+
+/* Ports only exist as part of a mixer. */
+static struct slab *create_port(va_list *args)
+{
+	ARG_UNUSED(args);
+
+	return NULL;
+}
+
+static void destroy_port(struct slab *slab)
+{
+	ARG_UNUSED(slab);
+}
+
+SLAB_TYPE_DEFINE(slab_type_mixer, SLAB_TYPE_MIXER, create_from_args,
+		 slab_mixer_destroy, slab_mixer_stim, NULL, static_deinit);
+
+SLAB_TYPE_DEFINE(slab_type_mixer_port, SLAB_TYPE_MIXER_PORT, create_port,
+		 destroy_port, port_stim, NULL, NULL);
@@ -28,3 +28,14 @@ void slab_notifier_stim(struct slab *slab, struct slab_event *evt)
 
 	slab_stim_childs(slab, evt);
 }
+
+static struct slab *create_from_args(va_list *args)
+{
+	slab_notifier_cb subscriber = va_arg(*args, slab_notifier_cb);
+	void *context = va_arg(*args, void *);
+
+	return slab_notifier_create(subscriber, context);
+}
+
+SLAB_TYPE_DEFINE(slab_type_notifier, SLAB_TYPE_NOTIFIER, create_from_args,
+		 slab_notifier_destroy, slab_notifier_stim, NULL, NULL);
@@ -0,0 +1,115 @@
+#ifndef SLAB_PRIV_H__
+#define SLAB_PRIV_H__
+
+#include <zephyr/kernel.h>
+
+#include "slab.h"
+#include "slab_event.h"
+
+/* Internal interfaces shared between the slab core modules. */
+
+#if defined(CONFIG_SLAB_STATS) || defined(CONFIG_SLAB_DISPATCH_QUEUE)
+struct slab_work_list;
+
+/* State of a thread while it is inside its outermost dispatch, found by
+ * nested calls through the custom data of the thread.
+ */
+struct slab_thread_state {
+#ifdef CONFIG_SLAB_DISPATCH_QUEUE
+	/* Work list processed by the thread, NULL if there is none */
+	struct slab_work_list *work_list;
+#endif
+#ifdef CONFIG_SLAB_STATS
+	/* Cycles spent in childs stimulated recursively by the slab being dispatched */
+	uint32_t nested_cycles;
+#endif
+};
+
+/* Get the state of the current thread, setting up the zeroed state given
+ * by the caller if the thread has none yet.
+ */
+static inline struct slab_thread_state *slab_thread_state_enter(struct slab_thread_state *outermost)
+{
+	struct slab_thread_state *state = k_thread_custom_data_get();
+
+	if (state == NULL) {
+		state = outermost;
+		k_thread_custom_data_set(state);
+	}
+
+	return state;
+}
+
+/* Drop the state of the current thread if it was set up by the caller. */
+static inline void slab_thread_state_exit(struct slab_thread_state *state,
+					  struct slab_thread_state *outermost)
+{
+	if (state == outermost) {
+		k_thread_custom_data_set(NULL);
+	}
+}
+#endif
+
+#ifdef CONFIG_SLAB_STATS
+/* Let a slab process an event and update its counters. */
+void slab_stats_dispatch(struct slab *slab, struct slab_event *evt);
+
+/* Stop listing a slab that is about to be destroyed. */
+void slab_stats_remove(struct slab *slab);
+#endif
+
+/* Let a slab process an event without any graph handling.
+ *
+ * The caller must hold a reference to the event. The reference is
+ * handed over to the slab, which releases or forwards it.
+ */
+static inline void slab_dispatch(struct slab *slab, struct slab_event *evt)
+{
+#ifdef CONFIG_SLAB_STATS
+	slab_stats_dispatch(slab, evt);
+#else
+	slab->api->stim(slab, evt);
+#endif
+}
+
+/* Count an event sent by a slab to its childs. */
+static inline void slab_count_emitted(struct slab *slab)
+{
+#ifdef CONFIG_SLAB_STATS
+	slab->stats.num_emitted += 1;
+#endif
+}
+
+#ifdef CONFIG_SLAB_DISPATCH_QUEUE
+/* Put an event for a slab on the work list of the current thread, and
+ * process the list unless the thread is already processing it, see
+ * slab_queue.h.
+ *
+ * The caller must hold a reference to the event, it is handed over.
+ */
+void slab_queue_stim(struct slab *slab, struct slab_event *evt);
+
+/* Put an event on the work list of the current thread for every child
+ * of a slab that takes it, and process the list unless the thread is
+ * already processing it.
+ *
+ * The reference held by the caller is released.
+ */
+void slab_queue_stim_childs(struct slab *slab, struct slab_event *evt);
+#endif
+
+/* Queue an event on a slab that is part of a compiled graph and
+ * evaluate the graph unless an evaluation is already in progress.
+ *
+ * The caller must hold a reference to the event, it is handed over.
+ */
+void slab_graph_stim(struct slab_graph_step *step, struct slab_event *evt);
+
+/* Queue an event on all childs of a slab that is part of a compiled
+ * graph and evaluate the graph unless an evaluation is already in progress.
+ *
+ * The reference held by the caller is released.
+ */
+void slab_graph_stim_childs(struct slab_graph_step *step, struct slab_event *evt);
+
+#endif /* SLAB_PRIV_H__ */
@@ -0,0 +1,201 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_priv.h"
+#include "slab_queue.h"
+
+/* Events waiting to be processed by a slab. A thread has a work list while
+ * it is inside its outermost slab_stim() or slab_stim_childs() call, found
+ * by nested calls through the state of the thread.
+ */
+struct work_item {
+	struct slab *slab;
+	struct slab_event *evt;
+};
+
+struct slab_work_list {
+	struct work_item items[CONFIG_SLAB_DISPATCH_QUEUE_SIZE];
+	uint16_t head;
+	uint16_t count;
+};
+
+static struct k_spinlock stats_lock;
+static struct slab_queue_stats queue_stats;
+
+/*================================[Work list]=================================*/
+static void push(struct slab_work_list *list, struct slab *slab, struct slab_event *evt)
+{
+	k_spinlock_key_t key;
+	struct work_item *item;
+
+	if (list->count == CONFIG_SLAB_DISPATCH_QUEUE_SIZE) {
+		key = k_spin_lock(&stats_lock);
+		queue_stats.num_dropped += 1;
+		k_spin_unlock(&stats_lock, key);
+
+		slab_event_release(evt);
+		return;
+	}
+
+#ifdef CONFIG_SLAB_DISPATCH_BREADTH_FIRST
+	item = &list->items[(list->head + list->count) % CONFIG_SLAB_DISPATCH_QUEUE_SIZE];
+#else
+	item = &list->items[list->count];
+#endif
+	item->slab = slab;
+	item->evt = evt;
+	list->count += 1;
+
+	if (list->count > queue_stats.max_queued) {
+		key = k_spin_lock(&stats_lock);
+		queue_stats.max_queued = MAX(queue_stats.max_queued, list->count);
+		k_spin_unlock(&stats_lock, key);
+	}
+}
+
+static struct work_item pop(struct slab_work_list *list)
+{
+	struct work_item item;
+
+#ifdef CONFIG_SLAB_DISPATCH_BREADTH_FIRST
+	item = list->items[list->head];
+	list->head = (list->head + 1) % CONFIG_SLAB_DISPATCH_QUEUE_SIZE;
+#else
+	item = list->items[list->count - 1];
+#endif
+	list->count -= 1;
+
+	return item;
+}
+
+#ifdef CONFIG_SLAB_DISPATCH_DEPTH_FIRST
+/* Reverse the items pushed since the list held base items, so the first
+ * one pushed is processed first, like with recursive dispatch.
+ */
+static void reverse_from(struct slab_work_list *list, uint16_t base)
+{
+	struct work_item tmp;
+
+	for (int i = base, j = list->count - 1; i < j; i++, j--) {
+		tmp = list->items[i];
+		list->items[i] = list->items[j];
+		list->items[j] = tmp;
+	}
+}
+#endif
+
+static void push_childs(struct slab *slab, struct slab_event *evt)
+{
+	const struct slab_childs *childs = &slab->childs;
+	slab_event_mask_t evt_mask = SLAB_EVENT_MASK(evt->id);
+
+	for (int i = 0; i < childs->num; i++) {
+		if (childs->masks[i] & evt_mask) {
+			slab_stim(childs->list[i], evt);
+		}
+	}
+
+	slab_event_release(evt);
+}
+
+/* Give the current thread a work list, queue the first event(s) and process
+ * everything that follows from them. Kept out of line, so only the
+ * outermost call takes stack space for the list.
+ */
+static __noinline void run(struct slab *slab, struct slab_event *evt, bool to_childs)
+{
+	struct slab_thread_state outermost = {0};
+	struct slab_thread_state *state;
+	struct slab_work_list list;
+	struct work_item item;
+	uint32_t num_dispatched = 0;
+#ifdef CONFIG_SLAB_DISPATCH_DEPTH_FIRST
+	uint16_t base;
+#endif
+	k_spinlock_key_t key;
+
+	list.head = 0;
+	list.count = 0;
+	state = slab_thread_state_enter(&outermost);
+	state->work_list = &list;
+
+	if (to_childs) {
+		push_childs(slab, evt);
+	} else {
+		push(&list, slab, evt);
+	}
+
+#ifdef CONFIG_SLAB_DISPATCH_DEPTH_FIRST
+	reverse_from(&list, 0);
+#endif
+
+	while (list.count > 0) {
+		item = pop(&list);
+#ifdef CONFIG_SLAB_DISPATCH_DEPTH_FIRST
+		base = list.count;
+		slab_dispatch(item.slab, item.evt);
+		reverse_from(&list, base);
+#else
+		slab_dispatch(item.slab, item.evt);
+#endif
+		num_dispatched += 1;
+	}
+
+	state->work_list = NULL;
+	slab_thread_state_exit(state, &outermost);
+
+	key = k_spin_lock(&stats_lock);
+	queue_stats.num_dispatched += num_dispatched;
+	k_spin_unlock(&stats_lock, key);
+}
+
+static struct slab_work_list *current_work_list(void)
+{
+	struct slab_thread_state *state = k_thread_custom_data_get();
+
+	return state != NULL ? state->work_list : NULL;
+}
+
+/*=============================[Private methods]==============================*/
+void slab_queue_stim(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_work_list *list = current_work_list();
+
+	if (list != NULL) {
+		push(list, slab, evt);
+		return;
+	}
+
+	run(slab, evt, false);
+}
+
+void slab_queue_stim_childs(struct slab *slab, struct slab_event *evt)
+{
+	if (current_work_list() != NULL) {
+		push_childs(slab, evt);
+		return;
+	}
+
+	run(slab, evt, true);
+}
+
+/*==============================[Public methods]==============================*/
+void slab_queue_stats_get(struct slab_queue_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*stats = queue_stats;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void slab_queue_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(&queue_stats, 0, sizeof(queue_stats));
+
+	k_spin_unlock(&stats_lock, key);
+}
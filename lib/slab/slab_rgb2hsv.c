@@ -36,3 +36,13 @@ void slab_rgb2hsv_stim(struct slab *slab, struct slab_event *evt)
 		break;
 	}
 }
+
+static struct slab *create_from_args(va_list *args)
+{
+	ARG_UNUSED(args);
+
+	return slab_rgb2hsv_create();
+}
+
+SLAB_TYPE_DEFINE(slab_type_rgb2hsv, SLAB_TYPE_RGB2HSV, create_from_args,
+		 slab_rgb2hsv_destroy, slab_rgb2hsv_stim, NULL, NULL);
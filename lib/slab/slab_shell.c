@@ -0,0 +1,146 @@
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include "slab.h"
+#include "slab_queue.h"
+#include "slab_stats.h"
+#include "slab_trace.h"
+#include "slabs/slab_ticker.h"
+
+/*==============================[Statistics]==================================*/
+#ifdef CONFIG_SLAB_STATS
+static bool print_slab(const struct slab_stats_snapshot *snapshot, void *user_data)
+{
+	const struct shell *sh = user_data;
+
+	shell_print(sh, "%-10p %5d %10u %10u %12llu", (void *)snapshot->slab, snapshot->type,
+		    snapshot->num_stims, snapshot->num_emitted, (unsigned long long)snapshot->cycles);
+
+	return true;
+}
+
+static int cmd_slab_stats_show(const struct shell *sh, size_t argc, char **argv)
+{
+	shell_print(sh, "%-10s %5s %10s %10s %12s", "slab", "type", "stims", "emitted", "cycles");
+
+	slab_stats_foreach(print_slab, (void *)sh);
+
+	return 0;
+}
+
+static int cmd_slab_stats_latency(const struct shell *sh, size_t argc, char **argv)
+{
+	struct slab_latency_stats latency;
+
+	slab_stats_latency_get(&latency);
+
+	shell_print(sh, "ticks: %u, max: %u us", latency.num_ticks, latency.max_us);
+
+	for (int i = 0; i < CONFIG_SLAB_STATS_LATENCY_BUCKETS; i++) {
+		if (i == CONFIG_SLAB_STATS_LATENCY_BUCKETS - 1) {
+			shell_print(sh, ">= %8u us: %u", 1U << i, latency.buckets[i]);
+		} else {
+			shell_print(sh, "<  %8u us: %u", 2U << i, latency.buckets[i]);
+		}
+	}
+
+	return 0;
+}
+
+static int cmd_slab_stats_ticks(const struct shell *sh, size_t argc, char **argv)
+{
+	struct slab_ticker_stats stats;
+
+	slab_ticker_stats_get(&stats);
+
+	shell_print(sh, "clock period: %u ms, longest: %u us", CONFIG_SLAB_CLOCK_PERIOD_MS,
+		    k_cyc_to_us_floor32(stats.max_cycles));
+	shell_print(sh, "periods: %u, overruns: %u, missed periods: %u", stats.num_periods,
+		    stats.num_overruns, stats.num_missed_periods);
+	shell_print(sh, "ticks late: %u, dropped: %u", stats.num_late, stats.num_dropped);
+
+	return 0;
+}
+
+#ifdef CONFIG_SLAB_DISPATCH_QUEUE
+static int cmd_slab_stats_queue(const struct shell *sh, size_t argc, char **argv)
+{
+	struct slab_queue_stats stats;
+
+	slab_queue_stats_get(&stats);
+
+	shell_print(sh, "dispatched: %u, dropped: %u, max queued: %u", stats.num_dispatched,
+		    stats.num_dropped, stats.max_queued);
+
+	return 0;
+}
+#endif /* CONFIG_SLAB_DISPATCH_QUEUE */
+
+static int cmd_slab_stats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	slab_stats_reset();
+	slab_ticker_stats_reset();
+#ifdef CONFIG_SLAB_DISPATCH_QUEUE
+	slab_queue_stats_reset();
+#endif
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_slab_stats,
+	SHELL_CMD(show, NULL, "Show event and cycle counters of all slabs", cmd_slab_stats_show),
+	SHELL_CMD(latency, NULL, "Show tick to LED latency histogram", cmd_slab_stats_latency),
+	SHELL_CMD(ticks, NULL, "Show ticker overrun counters", cmd_slab_stats_ticks),
+	SHELL_COND_CMD(CONFIG_SLAB_DISPATCH_QUEUE, queue, NULL, "Show work list counters",
+		       cmd_slab_stats_queue),
+	SHELL_CMD(reset, NULL, "Clear all counters", cmd_slab_stats_reset),
+	SHELL_SUBCMD_SET_END
+);
+#endif /* CONFIG_SLAB_STATS */
+
+/*================================[Tracer]====================================*/
+#ifdef CONFIG_SLAB_TRACE
+/* One record per line, as expected by scripts/slab_trace_decode.py */
+static int cmd_slab_trace_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	struct slab_trace_record record;
+	const uint8_t *bytes = (const uint8_t *)&record;
+	char line[2 * sizeof(record) + 1];
+
+	slab_trace_enable(false);
+
+	while (slab_trace_drain(&record, 1) == 1) {
+		for (int i = 0; i < sizeof(record); i++) {
+			snprintk(&line[2 * i], 3, "%02x", bytes[i]);
+		}
+		shell_print(sh, "%s", line);
+	}
+
+	shell_print(sh, "lost: %u", slab_trace_num_lost());
+
+	slab_trace_enable(true);
+
+	return 0;
+}
+
+static int cmd_slab_trace_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	slab_trace_clear();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_slab_trace,
+	SHELL_CMD(dump, NULL, "Print and drain all trace records as hex", cmd_slab_trace_dump),
+	SHELL_CMD(clear, NULL, "Drop all trace records", cmd_slab_trace_clear),
+	SHELL_SUBCMD_SET_END
+);
+#endif /* CONFIG_SLAB_TRACE */
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_slab,
+	SHELL_COND_CMD(CONFIG_SLAB_STATS, stats, &sub_slab_stats, "Slab runtime statistics", NULL),
+	SHELL_COND_CMD(CONFIG_SLAB_TRACE, trace, &sub_slab_trace, "Slab event trace", NULL),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(slab, &sub_slab, "Smart LED animation blocks", NULL);
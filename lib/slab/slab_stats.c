@@ -0,0 +1,204 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+
+#include "slab.h"
+#include "slab_stats.h"
+#include "slab_priv.h"
+
+/* Slabs that processed at least one event */
+static sys_dlist_t slabs = SYS_DLIST_STATIC_INIT(&slabs);
+static K_MUTEX_DEFINE(slabs_lock);
+
+static struct k_spinlock latency_lock;
+static struct slab_latency_stats latency;
+static uint32_t tick_start;
+static uint32_t last_led_write;
+static bool led_written;
+
+struct snapshot_ctx {
+	struct slab_stats_snapshot *snapshots;
+	int max_snapshots;
+	int num_slabs;
+};
+
+/*==============================[Slab counters]===============================*/
+static void add_slab(struct slab *slab)
+{
+	k_mutex_lock(&slabs_lock, K_FOREVER);
+
+	if (!sys_dnode_is_linked(&slab->stats.node)) {
+		sys_dlist_append(&slabs, &slab->stats.node);
+	}
+
+	k_mutex_unlock(&slabs_lock);
+}
+
+void slab_stats_dispatch(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_thread_state outermost = {0};
+	struct slab_thread_state *state;
+	uint32_t outer_nested_cycles;
+	uint32_t start;
+	uint32_t elapsed;
+
+	if (!sys_dnode_is_linked(&slab->stats.node)) {
+		add_slab(slab);
+	}
+
+	state = slab_thread_state_enter(&outermost);
+	outer_nested_cycles = state->nested_cycles;
+	state->nested_cycles = 0;
+	start = k_cycle_get_32();
+
+	slab->api->stim(slab, evt);
+
+	elapsed = k_cycle_get_32() - start;
+
+	slab->stats.num_stims += 1;
+	slab->stats.cycles += elapsed - MIN(state->nested_cycles, elapsed);
+
+	/* The time of this slab counts as child time of the slab that stimulated it. */
+	state->nested_cycles = outer_nested_cycles + elapsed;
+
+	slab_thread_state_exit(state, &outermost);
+}
+
+void slab_stats_remove(struct slab *slab)
+{
+	k_mutex_lock(&slabs_lock, K_FOREVER);
+
+	if (sys_dnode_is_linked(&slab->stats.node)) {
+		sys_dlist_remove(&slab->stats.node);
+	}
+
+	k_mutex_unlock(&slabs_lock);
+}
+
+void slab_stats_get(const struct slab *slab, struct slab_stats_snapshot *snapshot)
+{
+	snapshot->slab = slab;
+	snapshot->type = slab->type;
+	snapshot->num_stims = slab->stats.num_stims;
+	snapshot->num_emitted = slab->stats.num_emitted;
+	snapshot->cycles = slab->stats.cycles;
+}
+
+void slab_stats_foreach(slab_stats_cb cb, void *user_data)
+{
+	struct slab_stats_snapshot snapshot;
+	sys_dnode_t *node;
+
+	k_mutex_lock(&slabs_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_NODE(&slabs, node) {
+		slab_stats_get(CONTAINER_OF(node, struct slab, stats.node), &snapshot);
+
+		if (!cb(&snapshot, user_data)) {
+			break;
+		}
+	}
+
+	k_mutex_unlock(&slabs_lock);
+}
+
+static bool copy_snapshot(const struct slab_stats_snapshot *snapshot, void *user_data)
+{
+	struct snapshot_ctx *ctx = user_data;
+
+	if (ctx->num_slabs < ctx->max_snapshots) {
+		ctx->snapshots[ctx->num_slabs] = *snapshot;
+	}
+
+	ctx->num_slabs += 1;
+	return true;
+}
+
+int slab_stats_snapshot(struct slab_stats_snapshot *snapshots, int max_snapshots)
+{
+	struct snapshot_ctx ctx = {
+		.snapshots = snapshots,
+		.max_snapshots = max_snapshots,
+		.num_slabs = 0,
+	};
+
+	slab_stats_foreach(copy_snapshot, &ctx);
+
+	return ctx.num_slabs;
+}
+
+void slab_stats_reset(void)
+{
+	struct slab *slab;
+	sys_dnode_t *node;
+	k_spinlock_key_t key;
+
+	k_mutex_lock(&slabs_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_NODE(&slabs, node) {
+		slab = CONTAINER_OF(node, struct slab, stats.node);
+
+		slab->stats.num_stims = 0;
+		slab->stats.num_emitted = 0;
+		slab->stats.cycles = 0;
+	}
+
+	k_mutex_unlock(&slabs_lock);
+
+	key = k_spin_lock(&latency_lock);
+	memset(&latency, 0, sizeof(latency));
+	led_written = false;
+	k_spin_unlock(&latency_lock, key);
+}
+
+/*==============================[Tick latency]================================*/
+void slab_stats_tick_begin(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	tick_start = k_cycle_get_32();
+	led_written = false;
+
+	k_spin_unlock(&latency_lock, key);
+}
+
+void slab_stats_led_written(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	last_led_write = k_cycle_get_32();
+	led_written = true;
+
+	k_spin_unlock(&latency_lock, key);
+}
+
+void slab_stats_tick_end(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+	uint32_t us;
+	int bucket;
+
+	if (led_written) {
+		us = k_cyc_to_us_floor32(last_led_write - tick_start);
+
+		bucket = (us < 2) ? 0 : (31 - __builtin_clz(us));
+		bucket = MIN(bucket, CONFIG_SLAB_STATS_LATENCY_BUCKETS - 1);
+
+		latency.buckets[bucket] += 1;
+		latency.num_ticks += 1;
+		latency.max_us = MAX(latency.max_us, us);
+
+		led_written = false;
+	}
+
+	k_spin_unlock(&latency_lock, key);
+}
+
+void slab_stats_latency_get(struct slab_latency_stats *latency_out)
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	*latency_out = latency;
+
+	k_spin_unlock(&latency_lock, key);
+}
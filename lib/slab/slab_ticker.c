@@ -1,6 +1,10 @@
+#include <string.h>
+
 #include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
 
 #include "slab_event.h"
+#include "slab_stats.h"
 #include "events/slab_event_tick.h"
 
 #include "slabs/slab_ticker.h"
@@ -9,30 +13,291 @@ K_THREAD_STACK_DEFINE(ticker_workqueue_stack, TICKER_WORKQUEUE_STACK_SIZE);
 static struct k_work_q ticker_work_q;
 static bool work_q_initialized = false;
 
+/* The clock shared by all tickers. It runs while any ticker is running
+ * and not idle. While all tickers are idle, the timer only fires once
+ * at the end of the earliest idle time, if any.
+ *
+ * clock_lock is never held while ticks are sent. Slabs stimulated through
+ * a compiled graph run with the graph locked and may take clock_lock, so
+ * the due ticks are collected under clock_lock and sent after it is
+ * released. send_lock is held while sending and while tickers are added
+ * or removed, so no ticker goes away while its tick is sent. It is always
+ * taken before clock_lock.
+ */
+static K_MUTEX_DEFINE(send_lock);
+static K_MUTEX_DEFINE(clock_lock);
+static sys_dlist_t clock_tickers = SYS_DLIST_STATIC_INIT(&clock_tickers);
+static struct k_timer clock_timer;
+static struct k_work clock_work;
+static uint32_t clock_start_ms;
+static uint32_t clock_count; /* Clock periods since the clock started */
+static bool clock_running;   /* The timer expires every clock period */
+static bool clock_sleeping;  /* The timer expires once, to end an idle time */
+static struct slab_ticker_stats clock_stats;
 
-static void timer_expired(struct k_timer *timer)
+static uint32_t to_clock_periods(uint32_t ms)
 {
-	struct slab_ticker *ticker = CONTAINER_OF(timer, struct slab_ticker, tick_timer);
+	return (ms + CONFIG_SLAB_CLOCK_PERIOD_MS / 2) / CONFIG_SLAB_CLOCK_PERIOD_MS;
+}
 
-	k_work_submit_to_queue(&ticker_work_q, &ticker->tick_work);
+static inline bool is_due(uint32_t count, uint32_t tick)
+{
+	return (int32_t)(count - tick) >= 0;
 }
 
-static void work_tick(struct k_work *work)
+static inline uint32_t period_time(uint32_t count)
+{
+	return clock_start_ms + count * CONFIG_SLAB_CLOCK_PERIOD_MS;
+}
+
+/* The clock follows the uptime and is driven by clock_timer, unless it is
+ * advanced manually with slab_clock_advance().
+ */
+static inline uint32_t clock_now(void)
+{
+#ifdef CONFIG_SLAB_CLOCK_MANUAL
+	return period_time(clock_count);
+#else
+	return k_uptime_get_32();
+#endif
+}
+
+static void clock_timer_start(k_timeout_t duration, k_timeout_t period)
+{
+#ifndef CONFIG_SLAB_CLOCK_MANUAL
+	k_timer_start(&clock_timer, duration, period);
+#endif
+}
+
+static void clock_timer_stop(void)
+{
+#ifndef CONFIG_SLAB_CLOCK_MANUAL
+	k_timer_stop(&clock_timer);
+	k_timer_status_get(&clock_timer);
+#endif
+}
+
+/* Set the next tick to the first clock period after now that is in phase. */
+static void align_next_tick(struct slab_ticker *ticker)
+{
+	uint32_t offset = (clock_count + ticker->divider - ticker->phase) % ticker->divider;
+
+	ticker->next_tick = clock_count + ticker->divider - offset;
+}
+
+static void wake_ticker(struct slab_ticker *ticker)
 {
-	struct slab_ticker *ticker = CONTAINER_OF(work, struct slab_ticker, tick_work);
-	struct slab *slab = (struct slab *)ticker;
+	ticker->is_idle = false;
+	align_next_tick(ticker);
+}
+
+/* Restart the periodic timer after the clock stopped for idle tickers.
+ * The clock periods that passed are counted as if the clock had run.
+ */
+static void resume_clock(void)
+{
+	uint32_t now;
+
+	if (clock_running) {
+		return;
+	}
+
+	now = clock_now();
+	clock_count = (now - clock_start_ms) / CONFIG_SLAB_CLOCK_PERIOD_MS;
+
+	clock_timer_stop();
+	clock_timer_start(K_MSEC(period_time(clock_count + 1) - now),
+			  K_MSEC(CONFIG_SLAB_CLOCK_PERIOD_MS));
+
+	clock_running = true;
+	clock_sleeping = false;
+}
+
+/* Stop the periodic timer if all tickers are idle, and wake the clock
+ * at the end of the earliest idle time instead.
+ */
+static void update_clock(void)
+{
+	sys_dnode_t *node;
+	struct slab_ticker *earliest = NULL;
+	uint32_t now;
+	uint32_t wake_time;
+
+	SYS_DLIST_FOR_EACH_NODE(&clock_tickers, node) {
+		struct slab_ticker *ticker = CONTAINER_OF(node, struct slab_ticker, node);
+
+		if (!ticker->is_idle) {
+			resume_clock();
+			return;
+		}
+
+		if (ticker->idle_forever) {
+			continue;
+		}
+
+		if (earliest == NULL || is_due(earliest->idle_until, ticker->idle_until)) {
+			earliest = ticker;
+		}
+	}
+
+	clock_timer_stop();
+	clock_running = false;
+	clock_sleeping = false;
 
-	uint32_t current_time = k_uptime_get_32();
-	struct slab_event *tick_evt = slab_event_create(SLAB_EVENT_TICK, current_time);
+	if (earliest == NULL) {
+		return;
+	}
+
+	now = clock_now();
+	wake_time = period_time(earliest->idle_until);
+	clock_timer_start(K_MSEC(is_due(now, wake_time) ? 0 : wake_time - now), K_NO_WAIT);
+	clock_sleeping = true;
+}
+
+static void send_tick(struct slab_ticker *ticker, uint32_t time)
+{
+	struct slab_event *tick_evt = slab_event_create(SLAB_EVENT_TICK, time);
 
 	slab_event_acquire(tick_evt);
-	slab_stim_childs(slab, tick_evt);
+	slab_stim_childs((struct slab *)ticker, tick_evt);
 }
 
-struct slab *slab_ticker_create(k_timeout_t tick_period)
+/* Mark the tick of a ticker to be sent if it has one due, and account for
+ * the ticks that were due in clock periods that passed without processing.
+ */
+static void process_ticker(struct slab_ticker *ticker)
 {
-	struct slab_ticker *new_slab = k_malloc(sizeof(struct slab_ticker));
-	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+	uint32_t num_due;
+	uint32_t last_due;
+
+	if (ticker->is_idle) {
+		if (ticker->idle_forever || !is_due(clock_count, ticker->idle_until)) {
+			return;
+		}
+		wake_ticker(ticker);
+	}
+
+	if (!is_due(clock_count, ticker->next_tick)) {
+		return;
+	}
+
+	num_due = (clock_count - ticker->next_tick) / ticker->divider + 1;
+	last_due = ticker->next_tick + (num_due - 1) * ticker->divider;
+	ticker->next_tick = last_due + ticker->divider;
+
+	if (last_due == clock_count) {
+		clock_stats.num_dropped += num_due - 1;
+		ticker->tick_due = true;
+		return;
+	}
+
+#ifdef CONFIG_SLAB_TICKER_OVERRUN_SKIP
+	clock_stats.num_dropped += num_due;
+#else
+	clock_stats.num_dropped += num_due - 1;
+	clock_stats.num_late += 1;
+	ticker->tick_due = true;
+#endif
+}
+
+/* Mark the ticks that are due in the current clock period. Call with
+ * send_lock and clock_lock held.
+ */
+static void process_tickers(void)
+{
+	sys_dnode_t *node;
+
+	SYS_DLIST_FOR_EACH_NODE(&clock_tickers, node) {
+		process_ticker(CONTAINER_OF(node, struct slab_ticker, node));
+	}
+}
+
+/* Send the ticks marked by process_tickers(). Call with send_lock held
+ * and clock_lock released.
+ */
+static void send_ticks(uint32_t time)
+{
+	sys_dnode_t *node;
+	sys_dnode_t *next;
+
+	slab_stats_tick_begin();
+
+	/* A slab may stop its own ticker from the tick. */
+	SYS_DLIST_FOR_EACH_NODE_SAFE(&clock_tickers, node, next) {
+		struct slab_ticker *ticker = CONTAINER_OF(node, struct slab_ticker, node);
+
+		if (ticker->tick_due) {
+			ticker->tick_due = false;
+			send_tick(ticker, time);
+		}
+	}
+
+	slab_stats_tick_end();
+}
+
+static void clock_expired(struct k_timer *timer)
+{
+	k_work_submit_to_queue(&ticker_work_q, &clock_work);
+}
+
+/* Send the ticks of all tickers that are due, once per clock expiry.
+ * Clock periods that expired while the work queue was busy are handled
+ * in one go, see process_ticker().
+ */
+static void work_tick(struct k_work *work)
+{
+	uint32_t num_expired;
+	uint32_t time;
+	uint32_t start = k_cycle_get_32();
+
+	k_mutex_lock(&send_lock, K_FOREVER);
+	k_mutex_lock(&clock_lock, K_FOREVER);
+
+	/* Zero if an earlier run already took this expiry. */
+	num_expired = k_timer_status_get(&clock_timer);
+	if (num_expired == 0) {
+		k_mutex_unlock(&clock_lock);
+		k_mutex_unlock(&send_lock);
+		return;
+	}
+
+	if (clock_sleeping) {
+		/* The end of an idle time, not a clock period. */
+		resume_clock();
+	} else {
+		clock_count += num_expired;
+		clock_stats.num_periods += 1;
+		if (num_expired > 1) {
+			clock_stats.num_overruns += 1;
+			clock_stats.num_missed_periods += num_expired - 1;
+		}
+	}
+
+	process_tickers();
+	time = period_time(clock_count);
+
+	update_clock();
+
+	k_mutex_unlock(&clock_lock);
+
+	send_ticks(time);
+
+	k_mutex_lock(&clock_lock, K_FOREVER);
+	clock_stats.max_cycles = MAX(clock_stats.max_cycles, k_cycle_get_32() - start);
+	k_mutex_unlock(&clock_lock);
+
+	k_mutex_unlock(&send_lock);
+}
+
+static void start_ticking(struct slab_ticker *ticker, uint32_t period_ms, uint32_t phase_ms)
+{
+	ticker->is_idle = false;
+	ticker->tick_due = false;
+	ticker->divider = MAX(to_clock_periods(period_ms), 1);
+	ticker->phase = to_clock_periods(phase_ms) % ticker->divider;
+
+	k_mutex_lock(&send_lock, K_FOREVER);
+	k_mutex_lock(&clock_lock, K_FOREVER);
 
 	if (!work_q_initialized) {
 		k_work_queue_init(&ticker_work_q);
@@ -40,49 +305,189 @@ struct slab *slab_ticker_create(k_timeout_t tick_period)
 						   K_THREAD_STACK_SIZEOF(ticker_workqueue_stack),
 						   TICKER_WORKQUEUE_THREAD_PRIO, NULL);
 
+		k_work_init(&clock_work, work_tick);
+		k_timer_init(&clock_timer, clock_expired, NULL);
+
 		work_q_initialized = true;
 	}
 
-	new_slab->period = tick_period;
+	if (sys_dlist_is_empty(&clock_tickers)) {
+		clock_start_ms = clock_now();
+		clock_count = 0;
+		clock_running = true;
+		clock_sleeping = false;
+		clock_timer_start(K_MSEC(CONFIG_SLAB_CLOCK_PERIOD_MS),
+				  K_MSEC(CONFIG_SLAB_CLOCK_PERIOD_MS));
+	} else {
+		resume_clock();
+	}
+
+	align_next_tick(ticker);
+
+	sys_dlist_append(&clock_tickers, &ticker->node);
+
+	k_mutex_unlock(&clock_lock);
+	k_mutex_unlock(&send_lock);
+}
+
+static void stop_ticking(struct slab_ticker *ticker)
+{
+	k_mutex_lock(&send_lock, K_FOREVER);
+	k_mutex_lock(&clock_lock, K_FOREVER);
+
+	sys_dlist_remove(&ticker->node);
+
+	if (sys_dlist_is_empty(&clock_tickers)) {
+		clock_timer_stop();
+		k_work_cancel(&clock_work);
+		clock_running = false;
+		clock_sleeping = false;
+	} else {
+		update_clock();
+	}
+
+	k_mutex_unlock(&clock_lock);
+	k_mutex_unlock(&send_lock);
+}
+
+#ifdef CONFIG_SLAB_CLOCK_MANUAL
+void slab_clock_advance(uint32_t num_periods)
+{
+	uint32_t time;
+
+	k_mutex_lock(&send_lock, K_FOREVER);
+
+	for (uint32_t i = 0; i < num_periods; i++) {
+		k_mutex_lock(&clock_lock, K_FOREVER);
+		clock_count += 1;
+		clock_stats.num_periods += 1;
+
+		process_tickers();
+		time = period_time(clock_count);
+		k_mutex_unlock(&clock_lock);
+
+		send_ticks(time);
+	}
+
+	k_mutex_unlock(&send_lock);
+}
+#endif
 
-	k_work_init(&new_slab->tick_work, work_tick);
-	k_timer_init(&new_slab->tick_timer, timer_expired, NULL);
-	k_timer_start(&new_slab->tick_timer, new_slab->period, new_slab->period);
+void slab_ticker_stats_get(struct slab_ticker_stats *stats)
+{
+	k_mutex_lock(&clock_lock, K_FOREVER);
+	*stats = clock_stats;
+	k_mutex_unlock(&clock_lock);
+}
+
+void slab_ticker_stats_reset(void)
+{
+	k_mutex_lock(&clock_lock, K_FOREVER);
+	memset(&clock_stats, 0, sizeof(clock_stats));
+	k_mutex_unlock(&clock_lock);
+}
+
+struct slab *slab_ticker_create(k_timeout_t tick_period)
+{
+	struct slab_ticker *new_slab = k_malloc(sizeof(struct slab_ticker));
+	__ASSERT(new_slab != NULL, "System heap too small. Increase CONFIG_HEAP_MEM_POOL_SIZE");
+
+	new_slab->period_ms = 0;
+	new_slab->phase_ms = 0;
+
+	start_ticking(new_slab, k_ticks_to_ms_floor32(tick_period.ticks), 0);
 
 	return ((struct slab *)new_slab);
 }
 
 void slab_ticker_destroy(struct slab *slab)
 {
-	struct slab_ticker *ticker = (struct slab_ticker *)slab;
-	
-	k_timer_stop(&ticker->tick_timer);
-	k_work_cancel(&ticker->tick_work);
+	stop_ticking((struct slab_ticker *)slab);
 
 	k_free(slab);
 }
 
+void slab_ticker_idle_until(struct slab *slab, uint32_t until_ms)
+{
+	struct slab_ticker *ticker = (struct slab_ticker *)slab;
+	int32_t remaining_ms;
+
+	k_mutex_lock(&clock_lock, K_FOREVER);
+
+	ticker->is_idle = true;
+	ticker->idle_forever = (until_ms == SLAB_TICKER_IDLE_FOREVER);
+
+	/* First clock period at or after until_ms. */
+	remaining_ms = (int32_t)(until_ms - clock_start_ms);
+	ticker->idle_until = (remaining_ms > 0) ?
+		DIV_ROUND_UP((uint32_t)remaining_ms, CONFIG_SLAB_CLOCK_PERIOD_MS) : 0;
+
+	update_clock();
+
+	k_mutex_unlock(&clock_lock);
+}
+
+void slab_ticker_wake(struct slab *slab)
+{
+	struct slab_ticker *ticker = (struct slab_ticker *)slab;
+
+	k_mutex_lock(&clock_lock, K_FOREVER);
+
+	if (ticker->is_idle) {
+		resume_clock();
+		wake_ticker(ticker);
+	}
+
+	k_mutex_unlock(&clock_lock);
+}
+
 void slab_ticker_stim(struct slab *slab, struct slab_event *evt)
 {
 	struct slab_ticker *ticker = (struct slab_ticker *)slab;
 
+	/* Events other than ticks wake an idle ticker. */
+	if (evt->id != SLAB_EVENT_TICK) {
+		slab_ticker_wake(slab);
+	}
+
 	switch (evt->id) {
 	case SLAB_EVENT_RESET:
-		k_timer_stop(&ticker->tick_timer);
-		k_work_cancel(&ticker->tick_work);
+		k_mutex_lock(&clock_lock, K_FOREVER);
+		ticker->next_tick = clock_count + ticker->divider;
+		k_mutex_unlock(&clock_lock);
 
 		slab_stim_childs(slab, evt);
-
-		k_timer_start(&ticker->tick_timer, ticker->period, ticker->period);
 		break;
 
 	case SLAB_EVENT_TICK:
 		/* Stop propagation */
 		slab_event_release(evt);
 		break;
-	
+
 	default:
 		slab_stim_childs(slab, evt);
 		break;
 	}
-}
\ No newline at end of file
+}
+
+static void static_init(struct slab *slab)
+{
+	struct slab_ticker *ticker = (struct slab_ticker *)slab;
+
+	start_ticking(ticker, ticker->period_ms, ticker->phase_ms);
+}
+
+static void static_deinit(struct slab *slab)
+{
+	stop_ticking((struct slab_ticker *)slab);
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	k_timeout_t tick_period = va_arg(*args, k_timeout_t);
+
+	return slab_ticker_create(tick_period);
+}
+
+SLAB_TYPE_DEFINE(slab_type_ticker, SLAB_TYPE_TICKER, create_from_args,
+		 slab_ticker_destroy, slab_ticker_stim, static_init, static_deinit);
@@ -0,0 +1,86 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <rbuf.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_trace.h"
+
+#define TRACE_BUFFER_SIZE (CONFIG_SLAB_TRACE_RECORDS * sizeof(struct slab_trace_record))
+
+/* Records are always added and read whole and the buffer holds a whole
+ * number of records, so overwriting drops whole records only.
+ */
+RBUF_DEF(slab_trace_rbuf, TRACE_BUFFER_SIZE, RBUF_FLAG_ALLOW_OVERWRITE);
+
+static struct k_spinlock trace_lock;
+static uint32_t num_lost;
+static bool trace_enabled = true;
+
+void slab_trace(enum slab_trace_kind kind, const struct slab *slab, const struct slab_event *evt)
+{
+	struct slab_trace_record record;
+	struct rbuf_sizes sizes;
+	size_t len = sizeof(record);
+	k_spinlock_key_t key;
+
+	if (!trace_enabled) {
+		return;
+	}
+
+	record.timestamp = sys_cpu_to_le32(k_cycle_get_32());
+	record.slab = sys_cpu_to_le32((uint32_t)(uintptr_t)slab);
+	record.slab_type = sys_cpu_to_le16((uint16_t)slab->type);
+	record.num_refs = sys_cpu_to_le16((uint16_t)evt->num_refs);
+	record.event_id = (uint8_t)evt->id;
+	record.kind = (uint8_t)kind;
+	record.reserved = 0;
+
+	key = k_spin_lock(&trace_lock);
+
+	rbuf_sizes_get(&slab_trace_rbuf, &sizes);
+	if (sizes.free < sizeof(record)) {
+		num_lost += 1;
+	}
+
+	rbuf_add(&slab_trace_rbuf, (const uint8_t *)&record, &len, RBUF_OPT_OVERWRITE);
+
+	k_spin_unlock(&trace_lock, key);
+}
+
+size_t slab_trace_drain(struct slab_trace_record *records, size_t max_records)
+{
+	size_t len = MIN(max_records, CONFIG_SLAB_TRACE_RECORDS) * sizeof(struct slab_trace_record);
+	k_spinlock_key_t key;
+
+	if (records == NULL || len == 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&trace_lock);
+	rbuf_get(&slab_trace_rbuf, (uint8_t *)records, &len, 0);
+	k_spin_unlock(&trace_lock, key);
+
+	return len / sizeof(struct slab_trace_record);
+}
+
+void slab_trace_clear(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+	rbuf_reset(&slab_trace_rbuf, false);
+	num_lost = 0;
+
+	k_spin_unlock(&trace_lock, key);
+}
+
+uint32_t slab_trace_num_lost(void)
+{
+	return num_lost;
+}
+
+void slab_trace_enable(bool enable)
+{
+	trace_enabled = enable;
+}
@@ -14,6 +14,7 @@ struct slab *slab_waver_create(struct slab_waver_config *config)
 	new_slab->data.h = config->hue;
 	new_slab->data.s = config->sat;
 	new_slab->data.v = 0;
+	new_slab->config = NULL;
 
 	new_slab->gen = wave_func_create(&(config->val));
 
@@ -57,3 +58,24 @@ void slab_waver_stim(struct slab *slab, struct slab_event *evt)
 		break;
 	}
 }
+
+static void static_init(struct slab *slab)
+{
+	struct slab_waver *waver_slab = (struct slab_waver *)slab;
+
+	waver_slab->data.h = waver_slab->config->hue;
+	waver_slab->data.s = waver_slab->config->sat;
+	waver_slab->data.v = 0;
+
+	wave_func_reset(waver_slab->gen, &(waver_slab->config->val));
+}
+
+static struct slab *create_from_args(va_list *args)
+{
+	struct slab_waver_config *config = va_arg(*args, struct slab_waver_config *);
+
+	return slab_waver_create(config);
+}
+
+SLAB_TYPE_DEFINE(slab_type_waver, SLAB_TYPE_WAVER, create_from_args,
+		 slab_waver_destroy, slab_waver_stim, static_init, NULL);
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Compare two runs of the slab benchmarks.
+
+Reads the console output of two runs of tests/slab_bench, usually on the
+same board before and after a change, and prints the change of every
+result. Results that got worse by more than --threshold percent are marked,
+and the script exits with 1 if there are any.
+
+Examples:
+    slab_bench_compare.py before.log after.log
+    slab_bench_compare.py --threshold 2 --metric cycles_per_stim before.log after.log
+"""
+
+import argparse
+import json
+import sys
+
+BENCH_PREFIX = "BENCH "
+
+# Results where a larger value is worse
+METRICS = ["cycles_per_stim", "allocs_per_tick", "peak_heap"]
+
+
+def read_results(path):
+    results = {}
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            start = line.find(BENCH_PREFIX)
+            if start < 0:
+                continue
+            result = json.loads(line[start + len(BENCH_PREFIX):])
+            results[result["name"]] = result
+
+    if not results:
+        sys.exit("%s: no benchmark results found" % path)
+
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("before", help="log of the reference run")
+    parser.add_argument("after", help="log of the run to check")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="largest allowed growth of a result, in percent")
+    parser.add_argument("--metric", action="append", choices=METRICS,
+                        help="result to compare, may be repeated (default: all)")
+    args = parser.parse_args()
+
+    old_results = read_results(args.before)
+    new_results = read_results(args.after)
+    metrics = args.metric or METRICS
+    num_regressions = 0
+
+    for name, new in new_results.items():
+        old = old_results.get(name)
+        if old is None:
+            print("%-16s new" % name)
+            continue
+        if old["board"] != new["board"]:
+            sys.exit("%s: run on %s before and %s after" % (name, old["board"], new["board"]))
+
+        for metric in metrics:
+            old_value = old[metric]
+            new_value = new[metric]
+            change = 100.0 * (new_value - old_value) / old_value if old_value else 0.0
+            worse = new_value > old_value and (old_value == 0 or change > args.threshold)
+            print("%-16s %-16s %12g -> %12g  %+6.1f%%%s" % (
+                name, metric, old_value, new_value, change, "  REGRESSION" if worse else ""))
+            num_regressions += worse
+
+    sys.exit(1 if num_regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Compare two captures of the slab_sim application.
+
+Reads the console output of two runs of applications/slab_sim, usually one
+from before and one from after a change, and reports:
+
+- the first frames where an LED value differs by more than --tolerance
+- per simulated second counters of the summary that grew by more than
+  --threshold percent
+- ticks dropped or event pools exhausted that were not before
+
+Exits with 1 if any of these are found, so it can be used in scripts.
+
+Examples:
+    slab_sim_compare.py before.csv after.csv
+    slab_sim_compare.py --tolerance 2 --threshold 10 before.csv after.csv
+"""
+
+import argparse
+import re
+import sys
+
+PER_SECOND_LINE = re.compile(r"^# per simulated second: (.*)$")
+COUNTER = re.compile(r"(\d+) ([A-Za-z][A-Za-z ]*)")
+DROPPED_LINE = re.compile(r"^# ticks dropped: (\d+)$")
+POOL_LINE = re.compile(r"^# event pool (\w+): .* (\d+) exhausted$")
+
+MAX_REPORTED_FRAMES = 10
+
+
+def read_capture(path):
+    header = None
+    frames = []
+    per_second = {}
+    failures = {}
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("frame,"):
+                header = line.split(",")
+            elif line[:1].isdigit() and header:
+                frames.append([int(value) for value in line.split(",")])
+            elif line.startswith("#"):
+                match = PER_SECOND_LINE.match(line)
+                if match:
+                    for value, name in COUNTER.findall(match.group(1)):
+                        per_second[name.strip()] = int(value)
+                match = DROPPED_LINE.match(line)
+                if match:
+                    failures["ticks dropped"] = int(match.group(1))
+                match = POOL_LINE.match(line)
+                if match:
+                    failures["%s events exhausted" % match.group(1)] = int(match.group(2))
+
+    if header is None:
+        sys.exit("%s: no slab_sim output found" % path)
+
+    return header, frames, per_second, failures
+
+
+def compare_frames(header, old_frames, new_frames, tolerance):
+    num_regressions = 0
+
+    if len(old_frames) != len(new_frames):
+        print("frames: %d before, %d after" % (len(old_frames), len(new_frames)))
+        num_regressions += 1
+
+    for old, new in zip(old_frames, new_frames):
+        # Skip the frame number and time.
+        diffs = [(header[i], old[i], new[i]) for i in range(2, min(len(old), len(new)))
+                 if abs(old[i] - new[i]) > tolerance]
+        if not diffs:
+            continue
+
+        num_regressions += 1
+        if num_regressions <= MAX_REPORTED_FRAMES:
+            print("frame %d (%d ms): %s" % (new[0], new[1], ", ".join(
+                "%s %d -> %d" % diff for diff in diffs[:4])))
+
+    if num_regressions > MAX_REPORTED_FRAMES:
+        print("... %d frames differ" % num_regressions)
+
+    return num_regressions
+
+
+def compare_counters(old, new, threshold):
+    num_regressions = 0
+
+    for name, new_value in new.items():
+        old_value = old.get(name)
+        if old_value is None:
+            continue
+
+        change = 100.0 * (new_value - old_value) / old_value if old_value else 0.0
+        grew = new_value > old_value and (old_value == 0 or change > threshold)
+        print("%-12s %8d -> %8d  %+6.1f%%%s" % (name, old_value, new_value, change,
+                                                "  REGRESSION" if grew else ""))
+        num_regressions += grew
+
+    return num_regressions
+
+
+def compare_failures(old, new):
+    num_regressions = 0
+
+    for name, new_value in new.items():
+        if new_value > old.get(name, 0):
+            print("%s: %d -> %d  REGRESSION" % (name, old.get(name, 0), new_value))
+            num_regressions += 1
+
+    return num_regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("before", help="capture of the reference run")
+    parser.add_argument("after", help="capture of the run to check")
+    parser.add_argument("--tolerance", type=int, default=0,
+                        help="largest allowed difference of one LED value")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="largest allowed growth of a counter, in percent")
+    args = parser.parse_args()
+
+    old_header, old_frames, old_per_second, old_failures = read_capture(args.before)
+    new_header, new_frames, new_per_second, new_failures = read_capture(args.after)
+
+    if old_header != new_header:
+        sys.exit("captures have different LEDs")
+
+    num_regressions = compare_frames(new_header, old_frames, new_frames, args.tolerance)
+    num_regressions += compare_counters(old_per_second, new_per_second, args.threshold)
+    num_regressions += compare_failures(old_failures, new_failures)
+
+    sys.exit(1 if num_regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Decode slab event trace records.
+
+Reads records written by the slab tracer (CONFIG_SLAB_TRACE), either as a
+raw binary file of records drained with slab_trace_drain(), or as the text
+output of the "slab trace dump" shell command, and prints one line per
+record.
+
+Examples:
+    slab_trace_decode.py trace.bin
+    slab_trace_decode.py --hex uart.log --cycles-per-us 64
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+# Layout of struct slab_trace_record, see include/slab_trace.h
+RECORD = struct.Struct("<IIHHBBH")
+
+KINDS = {
+    1: "stim",
+    2: "emit",
+}
+
+# enum slab_event_id, see include/slab_event.h
+EVENTS = {
+    1: "RESET",
+    2: "TICK",
+    3: "RGB",
+    4: "HSV",
+    5: "RGB_FRAME",
+    6: "HSV_FRAME",
+}
+
+# enum slab_type, see include/slab.h
+SLAB_TYPES = {
+    1: "LED",
+    2: "DELAY",
+    3: "TICKER",
+    4: "GLOWER",
+    5: "WAVER",
+    6: "HSV2RGB",
+    7: "RGB2HSV",
+    8: "NOTIFIER",
+    9: "LED_STRIP",
+    10: "TAPPED_DELAY",
+    11: "GAMMA",
+    12: "MIXER",
+    13: "MIXER_PORT",
+}
+
+HEX_LINE = re.compile(r"\b([0-9a-fA-F]{%d})\b" % (2 * RECORD.size))
+
+
+def read_binary(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) % RECORD.size:
+        print("warning: ignoring %d trailing bytes" % (len(data) % RECORD.size), file=sys.stderr)
+
+    for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        yield RECORD.unpack_from(data, offset)
+
+
+def read_hex(path):
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            match = HEX_LINE.search(line)
+            if match:
+                yield RECORD.unpack(bytes.fromhex(match.group(1)))
+
+
+def name_of(names, value, fmt):
+    return names.get(value, fmt % value)
+
+
+def decode(records, cycles_per_us):
+    first = None
+
+    for timestamp, slab, slab_type, num_refs, event_id, kind, _ in records:
+        if first is None:
+            first = timestamp
+
+        # Timestamps are 32 bit cycle counts and may wrap.
+        elapsed = (timestamp - first) & 0xFFFFFFFF
+        if cycles_per_us:
+            when = "%12.1f us" % (elapsed / cycles_per_us)
+        else:
+            when = "%12d cyc" % elapsed
+
+        yield "%s  %-4s  slab 0x%08x %-9s  event %-9s  refs %d" % (
+            when,
+            name_of(KINDS, kind, "kind%d"),
+            slab,
+            name_of(SLAB_TYPES, slab_type, "type%d"),
+            name_of(EVENTS, event_id, "id%d"),
+            num_refs,
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="trace file")
+    parser.add_argument("--hex", action="store_true",
+                        help="input is the text output of 'slab trace dump'")
+    parser.add_argument("--cycles-per-us", type=float, default=0,
+                        help="print times in microseconds instead of cycles")
+    args = parser.parse_args()
+
+    records = read_hex(args.input) if args.hex else read_binary(args.input)
+
+    for line in decode(records, args.cycles_per_us):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -1300,3 +1300,41 @@ ZTEST(rbuf_suite, test_rbuf_suspended_get_arg_invalid_magic)
 	ztest_test_skip();
 #endif
 }
+
+ZTEST(rbuf_suite, test_rbuf_init)
+{
+	int err;
+	struct rbuf rb;
+	uint8_t data[4];
+	uint8_t out[4];
+	size_t len;
+	struct rbuf_sizes sizes;
+
+	err = rbuf_init(&rb, data, sizeof(data), RBUF_FLAG_ALLOW_OVERWRITE);
+	zassert_equal(err, RBUF_SUCCESS);
+
+	err = rbuf_sizes_get(&rb, &sizes);
+	zassert_equal(err, RBUF_SUCCESS);
+	zassert_equal(sizes.max, sizeof(data));
+	zassert_equal(sizes.used, 0);
+
+	len = 6;
+	err = rbuf_add(&rb, data100, &len, RBUF_OPT_OVERWRITE);
+	zassert_equal(err, RBUF_SUCCESS);
+
+	len = sizeof(out);
+	err = rbuf_get(&rb, out, &len, 0);
+	zassert_equal(err, RBUF_SUCCESS);
+	zassert_equal(len, sizeof(out));
+	zassert_mem_equal(out, &data100[2], sizeof(out));
+}
+
+ZTEST(rbuf_suite, test_rbuf_init_arg_invalid)
+{
+	struct rbuf rb;
+	uint8_t data[4];
+
+	zassert_equal(rbuf_init(NULL, data, sizeof(data), 0), RBUF_ERR_ARG_INVALID);
+	zassert_equal(rbuf_init(&rb, NULL, sizeof(data), 0), RBUF_ERR_ARG_INVALID);
+	zassert_equal(rbuf_init(&rb, data, 0, 0), RBUF_ERR_ARG_INVALID);
+}
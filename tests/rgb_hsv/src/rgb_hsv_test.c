@@ -0,0 +1,437 @@
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "rgb_hsv.h"
+#include "dither.h"
+#include "gamma_lut.h"
+#include "glow_func.h"
+#include "wave_func.h"
+
+#define NUM_BENCH_PIXELS 256
+
+/* Float reference of hsv2rgb(), as in lib/rgb_hsv without fixed point */
+static struct rgb_value reference_hsv2rgb(float h, float s, float v)
+{
+	struct rgb_value out;
+	float C = v * s;
+	uint8_t i = (uint8_t)(h / 60.0f);
+	float ff = (h / 60.0f) - (float)i;
+	float r = v;
+	float g = v;
+	float b = v;
+
+	switch (i) {
+	case 0:
+		g -= C * (1.0f - ff);
+		b -= C;
+		break;
+	case 1:
+		r -= C * ff;
+		b -= C;
+		break;
+	case 2:
+		r -= C;
+		b -= C * (1.0f - ff);
+		break;
+	case 3:
+		r -= C;
+		g -= C * ff;
+		break;
+	case 4:
+		r -= C * (1.0f - ff);
+		g -= C;
+		break;
+	default:
+		g -= C;
+		b -= C * ff;
+		break;
+	}
+
+	out.r = (uint8_t)(r * 255.0f);
+	out.g = (uint8_t)(g * 255.0f);
+	out.b = (uint8_t)(b * 255.0f);
+
+	return out;
+}
+
+ZTEST_SUITE(rgb_hsv_suite, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(rgb_hsv_suite, test_color_num_conversions)
+{
+	zassert_equal(COLOR_NUM_TO_INT(COLOR_NUM(360)), 360);
+	zassert_equal(COLOR_NUM_TO_INT(COLOR_NUM_FROM_INT(255)), 255);
+	zassert_within(COLOR_NUM_TO_FLOAT(COLOR_NUM(0.3)), 0.3f, 1.0f / 65536);
+	zassert_within(COLOR_NUM_TO_FLOAT(COLOR_NUM_MUL(COLOR_NUM(0.5), COLOR_NUM(0.3))), 0.15f,
+		       2.0f / 65536);
+	zassert_within(COLOR_NUM_TO_FLOAT(COLOR_NUM_DIV(COLOR_NUM(0.3), COLOR_NUM(0.5))), 0.6f,
+		       2.0f / 65536);
+}
+
+ZTEST(rgb_hsv_suite, test_hsv2rgb_matches_float_reference)
+{
+	for (int h = 0; h < 360 * 4; h++) {
+		for (int s = 0; s <= 16; s++) {
+			for (int v = 0; v <= 16; v++) {
+				float hf = h / 4.0f;
+				float sf = s / 16.0f;
+				float vf = v / 16.0f;
+				struct hsv_value in = {
+					.h = COLOR_NUM_FROM_FLOAT(hf),
+					.s = COLOR_NUM_FROM_FLOAT(sf),
+					.v = COLOR_NUM_FROM_FLOAT(vf),
+				};
+				struct rgb_value out = hsv2rgb(in);
+				struct rgb_value ref = reference_hsv2rgb(hf, sf, vf);
+
+				zassert_true(abs(out.r - ref.r) <= 1, "h %d s %d v %d", h, s, v);
+				zassert_true(abs(out.g - ref.g) <= 1, "h %d s %d v %d", h, s, v);
+				zassert_true(abs(out.b - ref.b) <= 1, "h %d s %d v %d", h, s, v);
+			}
+		}
+	}
+}
+
+ZTEST(rgb_hsv_suite, test_hsv2rgb16_keeps_fraction)
+{
+	struct hsv_value hsv = {.h = COLOR_NUM(130), .s = COLOR_NUM(0.9), .v = 0};
+	struct rgb_value rgb;
+	struct rgb16_value rgb16;
+	bool has_fraction = false;
+
+	for (int i = 0; i <= 1000; i++) {
+		hsv.v = COLOR_NUM_FROM_INT(i) / 1000;
+		rgb = hsv2rgb(hsv);
+		rgb16 = hsv2rgb16(hsv);
+
+		/* The integer part is the 8 bit conversion. */
+		zassert_equal(rgb16.r >> 8, rgb.r);
+		zassert_equal(rgb16.g >> 8, rgb.g);
+		zassert_equal(rgb16.b >> 8, rgb.b);
+
+		has_fraction |= (rgb16.g & 0xff) != 0;
+	}
+
+	zassert_true(has_fraction);
+
+	hsv.v = COLOR_NUM_ONE;
+	hsv.s = 0;
+	rgb16 = hsv2rgb16(hsv);
+	zassert_equal(rgb16.r, 255 << 8);
+
+	hsv.v = COLOR_NUM(1.5);
+	rgb16 = hsv2rgb16(hsv);
+	zassert_equal(rgb16.r, 0);
+}
+
+ZTEST(rgb_hsv_suite, test_hsv2rgb_rejects_out_of_range)
+{
+	struct hsv_value in = {.h = COLOR_NUM(361), .s = COLOR_NUM(0.5), .v = COLOR_NUM(0.5)};
+	struct rgb_value out = hsv2rgb(in);
+
+	zassert_equal(out.r + out.g + out.b, 0);
+}
+
+ZTEST(rgb_hsv_suite, test_rgb2hsv_primaries)
+{
+	struct rgb_value green = {.r = 0, .g = 255, .b = 0};
+	struct hsv_value out = rgb2hsv(green);
+
+	zassert_within(COLOR_NUM_TO_FLOAT(out.h), 120.0f, 0.01f);
+	zassert_within(COLOR_NUM_TO_FLOAT(out.s), 100.0f, 0.01f);
+	zassert_within(COLOR_NUM_TO_FLOAT(out.v), 100.0f, 0.01f);
+}
+
+ZTEST(rgb_hsv_suite, test_wave_func_matches_float_reference)
+{
+	struct wave_func_conf conf = {.T = 1000, .ym = COLOR_NUM(0.5), .yd = COLOR_NUM(0.2)};
+	struct wave_func *wf = wave_func_create(&conf);
+
+	wave_func_process(wf, 1);
+
+	for (uint32_t t = 1; t < 2000; t += 25) {
+		float y = COLOR_NUM_TO_FLOAT(wave_func_process(wf, t));
+		float ref;
+
+		if (t < 1001) {
+			ref = 0.5f + (2.0f / 1000 * (t - 1) - 1) * 0.2f;
+		} else {
+			ref = 0.5f - (2.0f / 1000 * (t - 1001) - 1) * 0.2f;
+		}
+
+		zassert_within(y, ref, 0.0005f, "t %u", t);
+	}
+
+	wave_func_destroy(wf);
+}
+
+ZTEST(rgb_hsv_suite, test_glow_func_matches_float_reference)
+{
+	struct glow_func_conf conf = {
+		.a = COLOR_NUM(0.25), .b = COLOR_NUM(0.25), .ym = COLOR_NUM(0.3), .yd = COLOR_NUM(4.0)
+	};
+	struct glow_func *gf = glow_func_create(&conf);
+	float ref = 0.3f;
+
+	glow_func_process(gf, 1, COLOR_NUM(0.5));
+
+	for (uint32_t t = 26; t < 5000; t += 25) {
+		float w = (t % 7) / 7.0f;
+		float y = COLOR_NUM_TO_FLOAT(glow_func_process(gf, t, COLOR_NUM_FROM_FLOAT(w)));
+
+		ref = ref + 0.025f * 0.5f * (0.3f - ref) + 0.025f * 0.25f * 4.0f * (w - 0.5f);
+
+		zassert_within(y, ref, 0.005f, "t %u", t);
+	}
+
+	glow_func_destroy(gf);
+}
+
+ZTEST(rgb_hsv_suite, test_batch_matches_single_conversions)
+{
+	struct hsv_value hsv[64];
+	struct rgb_value rgb[64];
+	struct hsv_value hsv_back[64];
+
+	for (int i = 0; i < ARRAY_SIZE(hsv); i++) {
+		hsv[i].h = COLOR_NUM_FROM_INT(i * 6);
+		hsv[i].s = COLOR_NUM_FROM_INT(i % 8) / 7;
+		hsv[i].v = COLOR_NUM_FROM_INT(i) / 63;
+	}
+
+	hsv2rgb_batch(hsv, rgb, ARRAY_SIZE(hsv));
+	rgb2hsv_batch(rgb, hsv_back, ARRAY_SIZE(rgb));
+
+	for (int i = 0; i < ARRAY_SIZE(hsv); i++) {
+		struct rgb_value single = hsv2rgb(hsv[i]);
+		struct hsv_value single_back = rgb2hsv(rgb[i]);
+
+		zassert_mem_equal(&rgb[i], &single, sizeof(single));
+		zassert_mem_equal(&hsv_back[i], &single_back, sizeof(single_back));
+	}
+}
+
+ZTEST(rgb_hsv_suite, test_hsv2rgb_int_matches_hsv2rgb)
+{
+	struct hsv_int_value in;
+	struct rgb_value out;
+
+	for (int h = 0; h < HSV_INT_HUE_MAX; h += 3) {
+		for (int s = 0; s <= 255; s += 15) {
+			for (int v = 0; v <= 255; v += 15) {
+				struct hsv_value ref_in = {
+					.h = COLOR_NUM_FROM_INT(h) * 15 / 64,
+					.s = COLOR_NUM_FROM_INT(s) / 255,
+					.v = COLOR_NUM_FROM_INT(v) / 255,
+				};
+				struct rgb_value ref = hsv2rgb(ref_in);
+
+				in.h = h;
+				in.s = s;
+				in.v = v;
+				hsv2rgb_int_batch(&in, &out, 1);
+
+				zassert_true(abs(out.r - ref.r) <= 2, "h %d s %d v %d", h, s, v);
+				zassert_true(abs(out.g - ref.g) <= 2, "h %d s %d v %d", h, s, v);
+				zassert_true(abs(out.b - ref.b) <= 2, "h %d s %d v %d", h, s, v);
+			}
+		}
+	}
+
+	/* Hue wraps around */
+	in.h = HSV_INT_HUE_MAX + 256;
+	hsv2rgb_int_batch(&in, &out, 1);
+	zassert_equal(out.g, in.v);
+}
+
+ZTEST(rgb_hsv_suite, test_rgb2hsv_int_round_trip)
+{
+	struct rgb_value in;
+	struct hsv_int_value hsv;
+	struct rgb_value out;
+
+	for (int r = 0; r <= 255; r += 5) {
+		for (int g = 0; g <= 255; g += 5) {
+			for (int b = 0; b <= 255; b += 5) {
+				in.r = r;
+				in.g = g;
+				in.b = b;
+
+				rgb2hsv_int_batch(&in, &hsv, 1);
+				zassert_true(hsv.h < HSV_INT_HUE_MAX);
+
+				hsv2rgb_int_batch(&hsv, &out, 1);
+				zassert_true(abs(out.r - r) <= 2, "rgb %d %d %d", r, g, b);
+				zassert_true(abs(out.g - g) <= 2, "rgb %d %d %d", r, g, b);
+				zassert_true(abs(out.b - b) <= 2, "rgb %d %d %d", r, g, b);
+			}
+		}
+	}
+}
+
+ZTEST(rgb_hsv_suite, test_gamma_lut)
+{
+	struct gamma_config config = GAMMA_CONFIG_LINEAR;
+	struct gamma_lut lut;
+	struct rgb_value pixels[2] = {{.r = 255, .g = 128, .b = 0}, {.r = 10, .g = 20, .b = 30}};
+
+	gamma_lut_build(&lut, &config);
+	for (int i = 0; i < 256; i++) {
+		zassert_equal(lut.r[i], i << 8);
+		zassert_equal(lut.g[i], i << 8);
+		zassert_equal(lut.b[i], i << 8);
+	}
+
+	/* Gamma keeps both ends and darkens the middle, per channel scales apply. */
+	config.gamma = 2.2f;
+	config.balance[2] = 128;
+	gamma_lut_build(&lut, &config);
+	zassert_equal(lut.r[0], 0);
+	zassert_equal(lut.r[255], 255 << 8);
+	zassert_equal(GAMMA_LUT_TO_U8(lut.r[128]), 56);
+	zassert_equal(lut.b[255], 128 << 8);
+	/* The low end keeps its fraction instead of rounding to 0 or 1. */
+	zassert_true(lut.r[10] > 0 && lut.r[10] < 0x80);
+	for (int i = 1; i < 256; i++) {
+		zassert_true(lut.r[i] >= lut.r[i - 1]);
+	}
+
+	/* Fractions are interpolated between the entries around them. */
+	zassert_equal(gamma_lut_lookup16(lut.r, 10 << 8), lut.r[10]);
+	zassert_equal(gamma_lut_lookup16(lut.r, (10 << 8) + 0x80), (lut.r[10] + lut.r[11]) / 2);
+	zassert_equal(gamma_lut_lookup16(lut.r, 255 << 8), lut.r[255]);
+
+	gamma_lut_apply_batch(&lut, pixels, pixels, ARRAY_SIZE(pixels));
+	zassert_equal(pixels[0].r, 255);
+	zassert_equal(pixels[0].g, 56);
+	zassert_equal(pixels[0].b, 0);
+	zassert_equal(pixels[1].r, GAMMA_LUT_TO_U8(lut.r[10]));
+}
+
+ZTEST(rgb_hsv_suite, test_dither)
+{
+	struct rgb16_value frame[2] = {
+		{.r = 0x0140, .g = 0x0080, .b = 0x0200},
+		{.r = 0xff00, .g = 0x0000, .b = 0x0001},
+	};
+	struct dither_error error[2] = {0};
+	struct rgb_value out[2];
+	uint32_t sums[2][3] = {0};
+
+	/* Over 256 frames every channel shows its exact average. */
+	for (int i = 0; i < 256; i++) {
+		dither_frame(frame, error, out, ARRAY_SIZE(frame));
+		for (int j = 0; j < 2; j++) {
+			sums[j][0] += out[j].r;
+			sums[j][1] += out[j].g;
+			sums[j][2] += out[j].b;
+		}
+
+		/* Whole values never flicker, fractions only step by one. */
+		zassert_equal(out[0].b, 2);
+		zassert_equal(out[1].r, 255);
+		zassert_equal(out[1].g, 0);
+		zassert_true(out[0].r == 1 || out[0].r == 2);
+	}
+
+	zassert_equal(sums[0][0], 0x140);
+	zassert_equal(sums[0][1], 0x080);
+	zassert_equal(sums[0][2], 0x200);
+	zassert_equal(sums[1][0], 0xff00);
+	zassert_equal(sums[1][1], 0);
+	zassert_equal(sums[1][2], 1);
+}
+
+ZTEST(rgb_hsv_suite, test_slow_fade_near_black_dithers)
+{
+	struct hsv_value hsv = {.h = COLOR_NUM(130), .s = COLOR_NUM(0.9), .v = 0};
+	struct rgb16_value frame;
+	struct dither_error error = {0};
+	struct rgb_value out;
+	uint8_t first_level = 0;
+	uint8_t last_truncated = 0;
+	uint8_t last_dithered = 0;
+	int num_truncated_steps = 0;
+	int num_dithered_steps = 0;
+	uint32_t sum16 = 0;
+	uint32_t sum = 0;
+
+	/* Green fades from 2 to 3 over 200 frames, like a glow near black. */
+	for (int i = 0; i < 200; i++) {
+		hsv.v = COLOR_NUM_FROM_FLOAT((2.0f + i / 200.0f) / 255 + 0.00001f);
+
+		frame = hsv2rgb16(hsv);
+		dither_frame(&frame, &error, &out, 1);
+
+		if (i == 0) {
+			first_level = hsv2rgb(hsv).g;
+			last_truncated = first_level;
+			last_dithered = out.g;
+		}
+
+		num_truncated_steps += (hsv2rgb(hsv).g != last_truncated);
+		num_dithered_steps += (out.g != last_dithered);
+		last_truncated = hsv2rgb(hsv).g;
+		last_dithered = out.g;
+
+		/* Only the two levels around the value are shown. */
+		zassert_true(out.g == first_level || out.g == first_level + 1);
+
+		sum16 += frame.g;
+		sum += out.g;
+	}
+
+	/* Truncated to 8 bit the fade holds one level, dithered it alternates
+	 * between both levels, averaging to the 16 bit value.
+	 */
+	zassert_equal(first_level, 2);
+	zassert_equal(num_truncated_steps, 0);
+	zassert_true(num_dithered_steps > 20);
+	zassert_within(sum, sum16 >> 8, 1);
+}
+
+/* Not a check, prints conversion cost for comparing number types and cores. */
+ZTEST(rgb_hsv_suite, test_hsv2rgb_benchmark)
+{
+	static struct hsv_value pixels[NUM_BENCH_PIXELS];
+	static struct hsv_int_value int_pixels[NUM_BENCH_PIXELS];
+	static struct rgb_value out[NUM_BENCH_PIXELS];
+	uint32_t sum = 0;
+	uint32_t start;
+	uint32_t single;
+	uint32_t batch;
+	uint32_t int_batch;
+
+	for (int i = 0; i < NUM_BENCH_PIXELS; i++) {
+		pixels[i].h = COLOR_NUM_FROM_INT(i * 360 / NUM_BENCH_PIXELS);
+		pixels[i].s = COLOR_NUM(0.8);
+		pixels[i].v = COLOR_NUM_FROM_INT(i) / NUM_BENCH_PIXELS;
+
+		int_pixels[i].h = i * HSV_INT_HUE_MAX / NUM_BENCH_PIXELS;
+		int_pixels[i].s = 204;
+		int_pixels[i].v = i;
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < NUM_BENCH_PIXELS; i++) {
+		out[i] = hsv2rgb(pixels[i]);
+	}
+	single = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	hsv2rgb_batch(pixels, out, NUM_BENCH_PIXELS);
+	batch = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	hsv2rgb_int_batch(int_pixels, out, NUM_BENCH_PIXELS);
+	int_batch = k_cycle_get_32() - start;
+
+	for (int i = 0; i < NUM_BENCH_PIXELS; i++) {
+		sum += out[i].r + out[i].g + out[i].b;
+	}
+	zassert_true(sum > 0);
+
+	TC_PRINT("hsv2rgb (%s), cycles per pixel: single %u, batch %u, integer batch %u\n",
+		 IS_ENABLED(CONFIG_COLOR_FIXED_POINT) ? "fixed point" : "float",
+		 single / NUM_BENCH_PIXELS, batch / NUM_BENCH_PIXELS, int_batch / NUM_BENCH_PIXELS);
+}
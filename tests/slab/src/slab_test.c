@@ -1,36 +1,81 @@
 #include <unity.h>
+#include <stdarg.h>
+#include <string.h>
 
 #include "slab.h"
 #include "cmock_slab_event.h"
-#include "cmock_slab_led.h"
-#include "cmock_slab_delay.h"
-#include "cmock_slab_glower.h"
-#include "cmock_slab_hsv2rgb.h"
-#include "cmock_slab_rgb2hsv.h"
-#include "cmock_dlist.h"
+#include "slabs/slab_delay.h"
+#include "slabs/slab_glower.h"
+#include "slabs/slab_hsv2rgb.h"
+#include "slabs/slab_led.h"
+#include "slabs/slab_rgb2hsv.h"
 
 extern int unity_main(void);
 
+/*===============================[Mock type]==================================*/
+/* Slab type registered by the test, so slab.c can be tested without
+ * depending on the behaviour of the library slab types. The library types
+ * call their own functions through their type api, which can not be mocked.
+ */
+#define SLAB_TYPE_MOCK SLAB_TYPE_CUSTOM
+#define NUM_MOCK_SLABS (2 * CONFIG_SLAB_INLINE_CHILDS + 2)
+
+static struct slab mock_slabs[NUM_MOCK_SLABS];
+static int num_mock_created;
+static int mock_arg;
+static bool mock_fail_create;
+
+static struct slab *mock_destroyed;
+static int num_mock_destroyed;
+
+static struct slab *mock_stimmed[NUM_MOCK_SLABS];
+static struct slab_event *mock_stimmed_evts[NUM_MOCK_SLABS];
+static int num_mock_stimmed;
+
+static struct slab *mock_create(va_list *args)
+{
+	mock_arg = va_arg(*args, int);
+
+	if (mock_fail_create || num_mock_created == NUM_MOCK_SLABS) {
+		return NULL;
+	}
+
+	return &mock_slabs[num_mock_created++];
+}
+
+static void mock_destroy(struct slab *slab)
+{
+	mock_destroyed = slab;
+	num_mock_destroyed += 1;
+}
+
+/* Keeps the reference to the event, its release is not part of the tests. */
+static void mock_stim(struct slab *slab, struct slab_event *evt)
+{
+	TEST_ASSERT_LESS_THAN(NUM_MOCK_SLABS, num_mock_stimmed);
+	mock_stimmed[num_mock_stimmed] = slab;
+	mock_stimmed_evts[num_mock_stimmed] = evt;
+	num_mock_stimmed += 1;
+}
+
+SLAB_TYPE_DEFINE(slab_type_mock, SLAB_TYPE_MOCK, mock_create, mock_destroy, mock_stim, NULL, NULL);
+
 void setUp(void)
 {
 	cmock_slab_event_Init();
-	cmock_slab_led_Init();
-	cmock_slab_delay_Init();
-	cmock_slab_glower_Init();
-	cmock_slab_hsv2rgb_Init();
-	cmock_slab_rgb2hsv_Init();
-	cmock_dlist_Init();
+
+	memset(mock_slabs, 0, sizeof(mock_slabs));
+	num_mock_created = 0;
+	mock_arg = 0;
+	mock_fail_create = false;
+	mock_destroyed = NULL;
+	num_mock_destroyed = 0;
+	num_mock_stimmed = 0;
 }
 
 void tearDown(void)
 {
 	cmock_slab_event_Verify();
-	cmock_slab_led_Verify();
-	cmock_slab_delay_Verify();
-	cmock_slab_glower_Verify();
-	cmock_slab_hsv2rgb_Verify();
-	cmock_slab_rgb2hsv_Verify();
-	cmock_dlist_Verify();
 }
 
 /* Suite teardown shall finalize with mandatory call to generic_suiteTearDown. */
@@ -42,163 +87,100 @@ int test_suiteTearDown(int num_failures)
 }
 
 /*==============================[Helpers]=====================================*/
-/* Defined in slab.c. Need definition also here for pointer comparison. */
-struct slab_child {
-	sys_dnode_t root;
-	struct slab *child;
-};
-
 static bool is_child_of(struct slab* slab, struct slab* parent, int num_in_list)
 {
-	int count = 0;
-	sys_dlist_t *list;
-	struct slab_child *child_node;
+	struct slab_childs *childs = &parent->childs;
 
-	list = &parent->childs;
-	TEST_ASSERT_NOT_NULL(list);
-	child_node = (struct slab_child *)(list->head);
+	TEST_ASSERT_NOT_NULL(childs->list);
 
-	/* Last element points back to the list so we use this as stop condition. */
-	while ((sys_dnode_t *)child_node != list) {
+	for (int i = 0; i < childs->num; i++) {
 		/* Negative num_in_list means we don't care for
 		 * the slab's position, only that it exists in the list.
 		 */
-		if (num_in_list < 0 || count == num_in_list) {
-			if (child_node->child == slab) {
+		if (num_in_list < 0 || i == num_in_list) {
+			if (childs->list[i] == slab) {
 				return true;
 			}
 		}
-		count++;
-		child_node = (struct slab_child *)(child_node->root.next);
 	}
 	return false;
 }
 
 static bool no_childs(struct slab *s)
 {
-	if (&s->childs == s->childs.head &&
-		&s->childs == s->childs.tail) {
-		return true;
-	}
-
-	return false;
+	return (s->childs.num == 0);
 }
 
 /*==============================[Tests]=======================================*/
-void test_slab_create_and_destroy_led(void)
+void test_slab_create_and_destroy(void)
 {
-	uint8_t v[3];
 	struct slab *s;
-	struct slab_led *sl;
-	struct slab *dummy_slab;
-	struct slab_led dummy_led_slab;
 
-	/* Populate led specific values of dummy slab */
-	dummy_led_slab.led = v;
-	dummy_led_slab.led_type = LED_TYPE_RGB;
-	dummy_slab = (struct slab *)&dummy_led_slab;
-
-	/* Test slab_create with type led */
-	__cmock_slab_led_create_ExpectAndReturn(v, LED_TYPE_RGB, dummy_slab);
-	s = slab_create(SLAB_TYPE_LED, v, LED_TYPE_RGB);
+	/* Test slab_create with the registered mock type */
+	s = slab_create(SLAB_TYPE_MOCK, 42);
+	TEST_ASSERT_EQUAL_PTR(&mock_slabs[0], s);
+	TEST_ASSERT_EQUAL(42, mock_arg);
+	TEST_ASSERT_EQUAL(SLAB_TYPE_MOCK, s->type);
+	TEST_ASSERT_EQUAL_PTR(&slab_type_mock, s->api);
+	TEST_ASSERT_NULL(s->step);
 	TEST_ASSERT_TRUE(no_childs(s));
-	TEST_ASSERT_EQUAL(SLAB_TYPE_LED, s->type);
-	sl = (struct slab_led *)s;
-	TEST_ASSERT_EQUAL(LED_TYPE_RGB, sl->led_type);
-	TEST_ASSERT_EQUAL_PTR(v, sl->led);
 
-	/* Test slab_destroy on the dummy slab */
-	__cmock_slab_led_destroy_Expect(s);
+	/* Test slab_destroy hands the slab to its type */
 	slab_destroy(s);
-	TEST_ASSERT_TRUE(no_childs(dummy_slab));
+	TEST_ASSERT_EQUAL(1, num_mock_destroyed);
+	TEST_ASSERT_EQUAL_PTR(s, mock_destroyed);
 }
 
-void test_slab_create_and_destroy_delay(void)
+void test_slab_create_fails_in_type(void)
 {
-	uint32_t delay_periods = 20;
-	struct slab *s;
-	struct slab_delay *sd;
-	struct slab *dummy_slab;
-	struct slab_delay dummy_delay_slab;
-
-	/* Populate delay specific values of dummy slab */
-	dummy_delay_slab.length = delay_periods;
-	dummy_slab = (struct slab *)&dummy_delay_slab;
+	mock_fail_create = true;
 
-	/* Test slab_create with type delay */
-	__cmock_slab_delay_create_ExpectAndReturn(delay_periods, dummy_slab);
-	s = slab_create(SLAB_TYPE_DELAY, delay_periods);
-	TEST_ASSERT_TRUE(no_childs(s));
-	TEST_ASSERT_EQUAL(SLAB_TYPE_DELAY, s->type);
-	sd = (struct slab_delay *)s;
-	TEST_ASSERT_EQUAL(delay_periods, sd->length);
-
-	/* Test slab_destroy on the dummy slab */
-	__cmock_slab_delay_destroy_Expect(s);
-	slab_destroy(s);
-	TEST_ASSERT_TRUE(no_childs(dummy_slab));
+	TEST_ASSERT_NULL(slab_create(SLAB_TYPE_MOCK, 0));
 }
 
-void test_slab_create_and_destroy_glower(void)
+void test_slab_create_and_destroy_library_types(void)
 {
+	uint8_t v[3];
 	struct slab_glower_config glow_conf = {
 		.hue = 123.4, .sat = 0.5, .val = {.a = 1, .b = 2, .ym = 3, .yd = 4}
 	};
 	struct slab *s;
-	struct slab_glower *sg;
-	struct slab *dummy_slab;
-	struct slab_glower dummy_glower_slab;
-
-	/* Populate glower specific values of dummy slab */
-	dummy_glower_slab.gen = (void *)0xBEEFCAFE;
-	dummy_slab = (struct slab *)&dummy_glower_slab;
+	struct slab_led *sl;
 
-	/* Test slab_create with type glower */
-	__cmock_slab_glower_create_ExpectAndReturn(&glow_conf, dummy_slab);
-	s = slab_create(SLAB_TYPE_GLOWER, &glow_conf);
+	/* Each library type is found through its registration */
+	s = slab_create(SLAB_TYPE_LED, v, LED_TYPE_RGB);
+	TEST_ASSERT_NOT_NULL(s);
+	TEST_ASSERT_EQUAL(SLAB_TYPE_LED, s->type);
+	TEST_ASSERT_EQUAL_PTR(&slab_type_led, s->api);
 	TEST_ASSERT_TRUE(no_childs(s));
-	TEST_ASSERT_EQUAL(SLAB_TYPE_GLOWER, s->type);
-	sg = (struct slab_glower *)s;
-	TEST_ASSERT_EQUAL_PTR((void *)0xBEEFCAFE, sg->gen);
+	sl = (struct slab_led *)s;
+	TEST_ASSERT_EQUAL(LED_TYPE_RGB, sl->led_type);
+	TEST_ASSERT_EQUAL_PTR(v, sl->led);
+	slab_destroy(s);
 
-	/* Test slab_destroy on the dummy slab */
-	__cmock_slab_glower_destroy_Expect(s);
+	s = slab_create(SLAB_TYPE_DELAY, 20);
+	TEST_ASSERT_NOT_NULL(s);
+	TEST_ASSERT_EQUAL(SLAB_TYPE_DELAY, s->type);
+	TEST_ASSERT_EQUAL_PTR(&slab_type_delay, s->api);
 	slab_destroy(s);
-	TEST_ASSERT_TRUE(no_childs(dummy_slab));
-}
 
-void test_slab_create_and_destroy_hsv2rgb(void)
-{
-	struct slab *s;
-	struct slab dummy_slab;
+	s = slab_create(SLAB_TYPE_GLOWER, &glow_conf);
+	TEST_ASSERT_NOT_NULL(s);
+	TEST_ASSERT_EQUAL(SLAB_TYPE_GLOWER, s->type);
+	TEST_ASSERT_EQUAL_PTR(&slab_type_glower, s->api);
+	slab_destroy(s);
 
-	/* Test slab_create with type hsv2rgb */
-	__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab);
 	s = slab_create(SLAB_TYPE_HSV2RGB);
-	TEST_ASSERT_TRUE(no_childs(s));
+	TEST_ASSERT_NOT_NULL(s);
 	TEST_ASSERT_EQUAL(SLAB_TYPE_HSV2RGB, s->type);
-
-	/* Test slab_destroy on the dummy slab */
-	__cmock_slab_hsv2rgb_destroy_Expect(s);
+	TEST_ASSERT_EQUAL_PTR(&slab_type_hsv2rgb, s->api);
 	slab_destroy(s);
-	TEST_ASSERT_TRUE(no_childs(&dummy_slab));
-}
-
-void test_slab_create_and_destroy_rgb2hsv(void)
-{
-	struct slab *s;
-	struct slab dummy_slab;
 
-	/* Test slab_create with type rgb2hsv */
-	__cmock_slab_rgb2hsv_create_ExpectAndReturn(&dummy_slab);
 	s = slab_create(SLAB_TYPE_RGB2HSV);
-	TEST_ASSERT_TRUE(no_childs(s));
+	TEST_ASSERT_NOT_NULL(s);
 	TEST_ASSERT_EQUAL(SLAB_TYPE_RGB2HSV, s->type);
-
-	/* Test slab_destroy on the dummy slab */
-	__cmock_slab_rgb2hsv_destroy_Expect(s);
+	TEST_ASSERT_EQUAL_PTR(&slab_type_rgb2hsv, s->api);
 	slab_destroy(s);
-	TEST_ASSERT_TRUE(no_childs(&dummy_slab));
 }
 
 void test_slab_create_and_destroy_invalid_type(void)
@@ -207,6 +189,7 @@ void test_slab_create_and_destroy_invalid_type(void)
 	uint8_t dummy_slab[sizeof(struct slab)];
 	int slab_type_invalid = -1;
 
+	memset(dummy_slab, 0, sizeof(dummy_slab));
 	s = (struct slab *)dummy_slab;
 	s->type = -1;
 
@@ -225,12 +208,10 @@ void test_slab_connect_and_disconnect(void)
 {
 	const int num_slabs = 2;
 	struct slab *s[num_slabs];
-	struct slab dummy_slab[num_slabs];
 
 	/* Create generic slabs */
 	for (int i = 0; i < num_slabs; i++) {
-		__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab[i]);
-		s[i] = slab_create(SLAB_TYPE_HSV2RGB);
+		s[i] = slab_create(SLAB_TYPE_MOCK, i);
 		TEST_ASSERT_TRUE(no_childs(s[i]));
 	}
 	
@@ -249,12 +230,10 @@ void test_slab_connect_and_disconnect_many(void)
 {
 	const int num_slabs = 5;
 	struct slab *s[num_slabs];
-	struct slab dummy_slab[num_slabs];
 
 	/* Create generic slabs */
 	for (int i = 0; i < num_slabs; i++) {
-		__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab[i]);
-		s[i] = slab_create(SLAB_TYPE_HSV2RGB);
+		s[i] = slab_create(SLAB_TYPE_MOCK, i);
 		TEST_ASSERT_TRUE(no_childs(s[i]));
 	}
 
@@ -287,16 +266,55 @@ void test_slab_connect_and_disconnect_many(void)
 	TEST_ASSERT_TRUE(no_childs(s[4]));
 }
 
+void test_slab_connect_beyond_inline_childs(void)
+{
+	const int num_slabs = 2 * CONFIG_SLAB_INLINE_CHILDS + 2;
+	struct slab *s[num_slabs];
+
+	/* Create generic slabs */
+	for (int i = 0; i < num_slabs; i++) {
+		s[i] = slab_create(SLAB_TYPE_MOCK, i);
+		TEST_ASSERT_TRUE(no_childs(s[i]));
+	}
+
+	/* Fan out from slab 0 until the childs no longer fit inside the slab */
+	for (int i = 1; i < num_slabs; i++) {
+		slab_connect(s[i], s[0]);
+	}
+	TEST_ASSERT_EQUAL(num_slabs - 1, s[0]->childs.num);
+	TEST_ASSERT_TRUE(s[0]->childs.list != s[0]->childs.inline_list);
+	for (int i = 1; i < num_slabs; i++) {
+		TEST_ASSERT_TRUE(is_child_of(s[i], s[0], i - 1));
+	}
+
+	/* Disconnecting keeps the order of the remaining childs */
+	slab_disconnect(s[1], s[0]);
+	for (int i = 2; i < num_slabs; i++) {
+		TEST_ASSERT_TRUE(is_child_of(s[i], s[0], i - 2));
+	}
+
+	/* The childs move back inside the slab when they fit again */
+	for (int i = 2; i < num_slabs - CONFIG_SLAB_INLINE_CHILDS; i++) {
+		slab_disconnect(s[i], s[0]);
+	}
+	TEST_ASSERT_EQUAL(CONFIG_SLAB_INLINE_CHILDS, s[0]->childs.num);
+	TEST_ASSERT_TRUE(s[0]->childs.list == s[0]->childs.inline_list);
+	TEST_ASSERT_TRUE(is_child_of(s[num_slabs - 1], s[0], CONFIG_SLAB_INLINE_CHILDS - 1));
+
+	for (int i = num_slabs - CONFIG_SLAB_INLINE_CHILDS; i < num_slabs; i++) {
+		slab_disconnect(s[i], s[0]);
+	}
+	TEST_ASSERT_TRUE(no_childs(s[0]));
+}
+
 void test_slab_connect_and_disconnect_invalid_slab(void)
 {
 	const int num_slabs = 3;
 	struct slab *s[num_slabs];
-	struct slab dummy_slab[num_slabs];
 
 	/* Create generic slabs */
 	for (int i = 0; i < num_slabs; i++) {
-		__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab[i]);
-		s[i] = slab_create(SLAB_TYPE_HSV2RGB);
+		s[i] = slab_create(SLAB_TYPE_MOCK, i);
 		TEST_ASSERT_TRUE(no_childs(s[i]));
 	}
 
@@ -341,7 +359,6 @@ void test_slab_connect_and_disconnect_invalid_slab(void)
 void test_slab_stim(void)
 {
 	struct slab *s;
-	struct slab dummy_slab;
 	struct slab_event *evt;
 	struct slab_event dummy_evt;
 
@@ -351,21 +368,21 @@ void test_slab_stim(void)
 	evt = &dummy_evt;
 
 	/* Create generic slab */
-	__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab);
-	s = slab_create(SLAB_TYPE_HSV2RGB);
+	s = slab_create(SLAB_TYPE_MOCK, 0);
 	TEST_ASSERT_TRUE(no_childs(s));
 
 	/* Give an event to the slab */
 	__cmock_slab_event_acquire_Expect(evt);
-	__cmock_slab_hsv2rgb_stim_Expect(s, evt);
 	slab_stim(s, evt);
+	TEST_ASSERT_EQUAL(1, num_mock_stimmed);
+	TEST_ASSERT_EQUAL_PTR(s, mock_stimmed[0]);
+	TEST_ASSERT_EQUAL_PTR(evt, mock_stimmed_evts[0]);
 }
 
 void test_slab_stim_childs(void)
 {
 	const int num_slabs = 2;
 	struct slab *s[num_slabs];
-	struct slab dummy_slab[num_slabs];
 
 	struct slab_event *evt;
 	struct slab_event dummy_evt;
@@ -377,23 +394,23 @@ void test_slab_stim_childs(void)
 
 	/* Create generic slabs */
 	for (int i = 0; i < num_slabs; i++) {
-		__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab[i]);
-		s[i] = slab_create(SLAB_TYPE_HSV2RGB);
+		s[i] = slab_create(SLAB_TYPE_MOCK, i);
 	}
 
 	slab_connect(s[1], s[0]);
 
 	__cmock_slab_event_acquire_Expect(evt);
-	__cmock_slab_hsv2rgb_stim_Expect(s[1], evt);
 	__cmock_slab_event_release_Expect(evt);
 	slab_stim_childs(s[0], evt);
+	TEST_ASSERT_EQUAL(1, num_mock_stimmed);
+	TEST_ASSERT_EQUAL_PTR(s[1], mock_stimmed[0]);
+	TEST_ASSERT_EQUAL_PTR(evt, mock_stimmed_evts[0]);
 }
 
 void test_slab_stim_childs_many(void)
 {
 	const int num_slabs = 5;
 	struct slab *s[num_slabs];
-	struct slab dummy_slab[num_slabs];
 
 	struct slab_event *evt;
 	struct slab_event dummy_evt;
@@ -405,8 +422,7 @@ void test_slab_stim_childs_many(void)
 
 	/* Create generic slabs */
 	for (int i = 0; i < num_slabs; i++) {
-		__cmock_slab_hsv2rgb_create_ExpectAndReturn(&dummy_slab[i]);
-		s[i] = slab_create(SLAB_TYPE_HSV2RGB);
+		s[i] = slab_create(SLAB_TYPE_MOCK, i);
 	}
 
 	slab_connect(s[1], s[0]);
@@ -415,19 +431,22 @@ void test_slab_stim_childs_many(void)
 	slab_connect(s[3], s[2]);
 	slab_connect(s[4], s[2]);
 
+	/* The mock type does not pass events on, so only direct childs get it */
 	__cmock_slab_event_acquire_Expect(evt);
-	__cmock_slab_hsv2rgb_stim_Expect(s[1], evt);
 	__cmock_slab_event_acquire_Expect(evt);
-	__cmock_slab_hsv2rgb_stim_Expect(s[2], evt);
 	__cmock_slab_event_release_Expect(evt);
 	slab_stim_childs(s[0], evt);
+	TEST_ASSERT_EQUAL(2, num_mock_stimmed);
+	TEST_ASSERT_EQUAL_PTR(s[1], mock_stimmed[0]);
+	TEST_ASSERT_EQUAL_PTR(s[2], mock_stimmed[1]);
 
 	__cmock_slab_event_acquire_Expect(evt);
-	__cmock_slab_hsv2rgb_stim_Expect(s[3], evt);
 	__cmock_slab_event_acquire_Expect(evt);
-	__cmock_slab_hsv2rgb_stim_Expect(s[4], evt);
 	__cmock_slab_event_release_Expect(evt);
 	slab_stim_childs(s[2], evt);
+	TEST_ASSERT_EQUAL(4, num_mock_stimmed);
+	TEST_ASSERT_EQUAL_PTR(s[3], mock_stimmed[2]);
+	TEST_ASSERT_EQUAL_PTR(s[4], mock_stimmed[3]);
 }
 
 /*============================================================================*/
@@ -0,0 +1,431 @@
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include "heap_count.h"
+#include "hikari_light.h"
+#include "light_resource.h"
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_stats.h"
+#include "rgb_hsv.h"
+#include "slabs/slab_delay.h"
+#include "slabs/slab_gamma.h"
+#include "slabs/slab_glower.h"
+#include "slabs/slab_led.h"
+#include "slabs/slab_mixer.h"
+#include "slabs/slab_notifier.h"
+#include "slabs/slab_ticker.h"
+#include "slabs/slab_waver.h"
+
+/* Benchmarks of the slab types and of the wave and glow graphs.
+ *
+ * Each benchmark prints one line with a JSON object, prefixed with BENCH:
+ *
+ *	BENCH {"name":"hsv2rgb","board":"qemu_cortex_m3","ticks":1000,...}
+ *
+ * ticks           Iterations, one event per slab type or one ticker period per graph
+ * stims           Events processed by slabs, 0 for graphs without CONFIG_SLAB_STATS
+ * cycles          Cycles of all iterations, including the childs of the slab
+ * cycles_per_stim cycles / stims, cycles per tick for graphs without stims
+ * events_per_s    stims per second of cycles
+ * allocs_per_tick Heap allocations per iteration
+ * peak_heap       Most heap bytes in use, from creating the slabs on
+ *
+ * On native_sim the cycle counter follows simulated time, which does not
+ * pass while the benchmarks run, so only counts and heap use are printed
+ * there. Use qemu_cortex_m3 for cycles. Compare two runs with
+ * scripts/slab_bench_compare.py.
+ */
+
+#define NUM_TICKS       1000
+#define NUM_GRAPH_TICKS 400
+#define NUM_PIXELS      32
+#define GRAPH_PERIOD_MS 25 /* Ticker period of the light modes */
+
+extern struct k_heap _system_heap;
+
+/*================================[Measuring]=================================*/
+struct bench {
+	const char *name;
+	uint32_t num_ticks;
+	uint32_t num_stims;
+	uint32_t cycles;
+	uint32_t num_allocs;
+	size_t heap_base;
+	uint32_t allocs_base;
+	uint32_t frees_base;
+	uint32_t start;
+};
+
+static struct bench bench;
+
+/* Start a benchmark, before its slabs are created. */
+static void bench_setup(const char *name)
+{
+	struct sys_memory_stats heap_stats;
+
+	memset(&bench, 0, sizeof(bench));
+	bench.name = name;
+
+	sys_heap_runtime_stats_reset_max(&_system_heap.heap);
+	sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats);
+	bench.heap_base = heap_stats.allocated_bytes;
+	bench.allocs_base = heap_count_allocs();
+	bench.frees_base = heap_count_frees();
+}
+
+static void bench_begin(void)
+{
+	bench.num_allocs = heap_count_allocs();
+	bench.start = k_cycle_get_32();
+}
+
+static void bench_end(uint32_t num_ticks, uint32_t num_stims)
+{
+	bench.cycles = k_cycle_get_32() - bench.start;
+	bench.num_allocs = heap_count_allocs() - bench.num_allocs;
+	bench.num_ticks = num_ticks;
+	bench.num_stims = num_stims;
+}
+
+/* Print the results, after the slabs are destroyed. */
+static void bench_report(void)
+{
+	struct sys_memory_stats heap_stats;
+	uint32_t per = bench.num_stims ? bench.num_stims : bench.num_ticks;
+	uint64_t events_per_s = 0;
+
+	sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats);
+
+	if (bench.cycles > 0) {
+		events_per_s = (uint64_t)bench.num_stims * sys_clock_hw_cycles_per_sec() /
+			       bench.cycles;
+	}
+
+	printk("BENCH {\"name\":\"%s\",\"board\":\"%s\",\"ticks\":%u,\"stims\":%u,"
+	       "\"cycles\":%u,\"cycles_per_stim\":%.1f,\"events_per_s\":%llu,"
+	       "\"allocs_per_tick\":%.3f,\"peak_heap\":%u}\n",
+	       bench.name, CONFIG_BOARD, bench.num_ticks, bench.num_stims, bench.cycles,
+	       (double)bench.cycles / per, (unsigned long long)events_per_s,
+	       (double)bench.num_allocs / bench.num_ticks,
+	       (uint32_t)(heap_stats.max_allocated_bytes - bench.heap_base));
+
+	/* Everything taken from the heap since bench_setup() is given back. */
+	zassert_equal(heap_count_allocs() - bench.allocs_base, heap_count_frees() - bench.frees_base,
+		      "%s leaks heap memory", bench.name);
+}
+
+/*============================[Slab type benches]=============================*/
+static struct rgb_value rgb_pixels[NUM_PIXELS];
+static struct hsv_value hsv_pixels[NUM_PIXELS];
+static uint8_t leds[NUM_PIXELS * 3];
+static uint32_t num_sunk;
+
+static void sink_callback(struct slab_event *evt, void *ctx)
+{
+	num_sunk += 1;
+}
+
+typedef struct slab_event *(*bench_event_fn)(uint32_t tick);
+
+static struct slab_event *tick_event(uint32_t tick)
+{
+	return slab_event_create(SLAB_EVENT_TICK, tick * GRAPH_PERIOD_MS);
+}
+
+static struct slab_event *rgb_event(uint32_t tick)
+{
+	struct rgb_value val = {.r = tick, .g = tick >> 1, .b = tick >> 2};
+
+	return slab_event_create(SLAB_EVENT_RGB, val);
+}
+
+static struct slab_event *hsv_event(uint32_t tick)
+{
+	struct hsv_value val = {.h = COLOR_NUM_FROM_INT(tick % 360), .s = COLOR_NUM(0.7),
+				.v = COLOR_NUM(0.5)};
+
+	return slab_event_create(SLAB_EVENT_HSV, val);
+}
+
+static struct slab_event *rgb_frame_event(uint32_t tick)
+{
+	return slab_event_create(SLAB_EVENT_RGB_FRAME, rgb_pixels, NUM_PIXELS);
+}
+
+static struct slab_event *hsv_frame_event(uint32_t tick)
+{
+	return slab_event_create(SLAB_EVENT_HSV_FRAME, hsv_pixels, NUM_PIXELS);
+}
+
+/* Give the slab one event per tick, with a notifier as its only child. */
+static void bench_slab(struct slab *slab, bench_event_fn next_event)
+{
+	struct slab *sink = slab_create(SLAB_TYPE_NOTIFIER, sink_callback, NULL);
+
+	zassert_not_null(slab);
+	zassert_not_null(sink);
+	slab_connect(sink, slab);
+
+	bench_begin();
+	for (uint32_t tick = 0; tick < NUM_TICKS; tick++) {
+		slab_stim(slab, next_event(tick));
+	}
+	bench_end(NUM_TICKS, NUM_TICKS);
+
+	slab_disconnect(sink, slab);
+	slab_destroy(sink);
+	slab_destroy(slab);
+
+	bench_report();
+}
+
+static void slab_bench_suite_before(void *fixture)
+{
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		rgb_pixels[i] = (struct rgb_value){.r = i * 8, .g = 255 - i * 8, .b = 128};
+		hsv_pixels[i] = (struct hsv_value){.h = COLOR_NUM_FROM_INT(i * 11),
+						   .s = COLOR_NUM(0.9), .v = COLOR_NUM(0.6)};
+	}
+
+	num_sunk = 0;
+}
+
+static void slab_bench_suite_after(void *fixture)
+{
+	struct slab_event_pool_stats stats;
+
+	for (int id = SLAB_EVENT_RESET; id <= SLAB_EVENT_HSV_FRAME; id++) {
+		slab_event_pool_stats_get(id, &stats);
+		zassert_equal(stats.num_used, 0);
+		zassert_equal(stats.num_exhausted, 0);
+	}
+}
+
+ZTEST_SUITE(slab_bench_suite, NULL, NULL, slab_bench_suite_before, slab_bench_suite_after, NULL);
+
+ZTEST(slab_bench_suite, test_led)
+{
+	bench_setup("led");
+	bench_slab(slab_create(SLAB_TYPE_LED, leds, LED_TYPE_GRB), rgb_event);
+}
+
+ZTEST(slab_bench_suite, test_led_strip)
+{
+	bench_setup("led_strip");
+	bench_slab(slab_create(SLAB_TYPE_LED_STRIP, leds, 0, NUM_PIXELS, LED_TYPE_GRB),
+		   rgb_frame_event);
+}
+
+ZTEST(slab_bench_suite, test_delay)
+{
+	bench_setup("delay");
+	bench_slab(slab_create(SLAB_TYPE_DELAY, 20), rgb_event);
+	zassert_equal(num_sunk, NUM_TICKS - 20);
+}
+
+ZTEST(slab_bench_suite, test_delay_frame)
+{
+	bench_setup("delay_frame");
+	bench_slab(slab_create(SLAB_TYPE_DELAY, 20), rgb_frame_event);
+}
+
+ZTEST(slab_bench_suite, test_tapped_delay)
+{
+	static const uint16_t taps[] = {100, 80, 20, 60, 100, 20, 40, 60, 80, 100, 20, 40, 20, 20};
+
+	bench_setup("tapped_delay");
+	bench_slab(slab_create(SLAB_TYPE_TAPPED_DELAY, taps, ARRAY_SIZE(taps)), rgb_event);
+}
+
+ZTEST(slab_bench_suite, test_glower)
+{
+	struct slab_glower_config config = {
+		.hue = COLOR_NUM(130), .sat = COLOR_NUM(0.9),
+		.val = {.a = COLOR_NUM(0.25), .b = COLOR_NUM(0.25),
+			.ym = COLOR_NUM(0.3), .yd = COLOR_NUM(4.0)}
+	};
+
+	bench_setup("glower");
+	bench_slab(slab_create(SLAB_TYPE_GLOWER, &config), tick_event);
+}
+
+ZTEST(slab_bench_suite, test_waver)
+{
+	struct slab_waver_config config = {
+		.hue = COLOR_NUM(120.0), .sat = COLOR_NUM(0.7),
+		.val = {.T = 1000, .ym = COLOR_NUM(0.3), .yd = COLOR_NUM(0.2)}
+	};
+
+	bench_setup("waver");
+	bench_slab(slab_create(SLAB_TYPE_WAVER, &config), tick_event);
+}
+
+ZTEST(slab_bench_suite, test_hsv2rgb)
+{
+	bench_setup("hsv2rgb");
+	bench_slab(slab_create(SLAB_TYPE_HSV2RGB), hsv_event);
+}
+
+ZTEST(slab_bench_suite, test_hsv2rgb_frame)
+{
+	bench_setup("hsv2rgb_frame");
+	bench_slab(slab_create(SLAB_TYPE_HSV2RGB), hsv_frame_event);
+}
+
+ZTEST(slab_bench_suite, test_rgb2hsv)
+{
+	bench_setup("rgb2hsv");
+	bench_slab(slab_create(SLAB_TYPE_RGB2HSV), rgb_event);
+}
+
+ZTEST(slab_bench_suite, test_gamma)
+{
+	struct gamma_config config = {.gamma = 2.2f, .brightness = 200, .balance = {255, 230, 210}};
+
+	bench_setup("gamma");
+	bench_slab(slab_create(SLAB_TYPE_GAMMA, &config), rgb_event);
+}
+
+ZTEST(slab_bench_suite, test_gamma_frame)
+{
+	struct gamma_config config = {.gamma = 2.2f, .brightness = 200, .balance = {255, 230, 210}};
+
+	bench_setup("gamma_frame");
+	bench_slab(slab_create(SLAB_TYPE_GAMMA, &config), rgb_frame_event);
+}
+
+ZTEST(slab_bench_suite, test_notifier)
+{
+	bench_setup("notifier");
+	bench_slab(slab_create(SLAB_TYPE_NOTIFIER, sink_callback, NULL), rgb_event);
+}
+
+ZTEST(slab_bench_suite, test_mixer)
+{
+	struct slab *mixer;
+	struct slab *ports[2];
+	struct slab *sink;
+
+	bench_setup("mixer");
+
+	mixer = slab_create(SLAB_TYPE_MIXER, SLAB_MIXER_CROSSFADE, ARRAY_SIZE(ports));
+	sink = slab_create(SLAB_TYPE_NOTIFIER, sink_callback, NULL);
+	zassert_not_null(mixer);
+	zassert_not_null(sink);
+	slab_connect(sink, mixer);
+	slab_mixer_alpha_set(mixer, 1, 128);
+
+	for (int i = 0; i < ARRAY_SIZE(ports); i++) {
+		ports[i] = slab_mixer_port(mixer, i);
+	}
+
+	/* One value per port and the tick that mixes them */
+	bench_begin();
+	for (uint32_t tick = 0; tick < NUM_TICKS; tick++) {
+		slab_stim(ports[0], rgb_event(tick));
+		slab_stim(ports[1], hsv_event(tick));
+		slab_stim(mixer, tick_event(tick));
+	}
+	bench_end(NUM_TICKS, 3 * NUM_TICKS);
+
+	slab_disconnect(sink, mixer);
+	slab_destroy(sink);
+	slab_destroy(mixer);
+
+	bench_report();
+	zassert_equal(num_sunk, NUM_TICKS);
+}
+
+ZTEST(slab_bench_suite, test_ticker)
+{
+	struct slab *ticker;
+	struct slab *sink;
+
+	bench_setup("ticker");
+
+	ticker = slab_create(SLAB_TYPE_TICKER, K_MSEC(CONFIG_SLAB_CLOCK_PERIOD_MS));
+	sink = slab_create(SLAB_TYPE_NOTIFIER, sink_callback, NULL);
+	zassert_not_null(ticker);
+	zassert_not_null(sink);
+	slab_connect(sink, ticker);
+
+	/* One clock period per tick, measured with the processing of the clock */
+	bench_begin();
+	slab_clock_advance(NUM_TICKS);
+	bench_end(NUM_TICKS, NUM_TICKS);
+
+	slab_disconnect(sink, ticker);
+	slab_destroy(sink);
+	slab_destroy(ticker);
+
+	bench_report();
+	zassert_equal(num_sunk, NUM_TICKS);
+}
+
+/*==============================[Graph benches]===============================*/
+#ifdef CONFIG_SLAB_STATS
+static bool sum_stims(const struct slab_stats_snapshot *snapshot, void *user_data)
+{
+	*(uint32_t *)user_data += snapshot->num_stims;
+
+	return true;
+}
+#endif
+
+static uint32_t graph_stims(void)
+{
+	uint32_t num_stims = 0;
+
+#ifdef CONFIG_SLAB_STATS
+	slab_stats_foreach(sum_stims, &num_stims);
+#endif
+	return num_stims;
+}
+
+/* Run a light mode of the sword for NUM_GRAPH_TICKS ticks of its ticker. */
+static void bench_mode(const char *name, enum hikari_light_mode mode)
+{
+	const struct hikari_light_mode_api *api = NULL;
+	uint32_t num_stims;
+
+	STRUCT_SECTION_FOREACH(hikari_light_mode_entry, entry) {
+		if (entry->mode == mode) {
+			api = entry->api;
+		}
+	}
+	zassert_not_null(api);
+
+	light_resource_init();
+
+	bench_setup(name);
+	api->constructor();
+
+	/* Let the first tick of the mode pass, it starts the animation. */
+	slab_clock_advance(GRAPH_PERIOD_MS / CONFIG_SLAB_CLOCK_PERIOD_MS);
+#ifdef CONFIG_SLAB_STATS
+	slab_stats_reset();
+#endif
+
+	bench_begin();
+	slab_clock_advance(NUM_GRAPH_TICKS * GRAPH_PERIOD_MS / CONFIG_SLAB_CLOCK_PERIOD_MS);
+	num_stims = graph_stims();
+	bench_end(NUM_GRAPH_TICKS, num_stims);
+
+	api->destructor();
+
+	bench_report();
+}
+
+ZTEST(slab_bench_suite, test_graph_wave)
+{
+	bench_mode("graph_wave", HIKARI_LIGHT_MODE_WAVE);
+}
+
+ZTEST(slab_bench_suite, test_graph_glow)
+{
+	bench_mode("graph_glow", HIKARI_LIGHT_MODE_GLOW);
+}
@@ -0,0 +1,221 @@
+#include <unity.h>
+
+#include "slabs/slab_delay.h"
+#include "../lib/slab/events/slab_event_tick.h"
+#include "../lib/slab/events/slab_event_rgb.h"
+#include "../lib/slab/events/slab_event_hsv.h"
+#include "cmock_slab.h"
+#include "cmock_slab_event.h"
+
+extern int unity_main(void);
+
+void setUp(void)
+{
+	cmock_slab_Init();
+	cmock_slab_event_Init();
+}
+
+void tearDown(void)
+{
+	cmock_slab_Verify();
+	cmock_slab_event_Verify();
+}
+
+/* Suite teardown shall finalize with mandatory call to generic_suiteTearDown. */
+extern int generic_suiteTearDown(int num_failures);
+
+int test_suiteTearDown(int num_failures)
+{
+	return generic_suiteTearDown(num_failures);
+}
+
+/*==============================[Helpers]=====================================*/
+static size_t line_used(struct slab_delay *sd)
+{
+	struct rbuf_sizes sizes;
+
+	rbuf_sizes_get(&sd->line, &sizes);
+	return sizes.used;
+}
+
+/* Stim a delay with an event and expect the event to be released. */
+static void stim_and_release(struct slab *s, struct slab_event *evt)
+{
+	__cmock_slab_event_release_Expect(evt);
+	slab_delay_stim(s, evt);
+}
+
+/* Expect the delay to send a new event of the given type to its childs. */
+static void expect_sent(struct slab *s, enum slab_event_id id, struct slab_event *evt_out)
+{
+	if (id == SLAB_EVENT_RGB) {
+		__cmock_slab_event_create_rgb16_ExpectAnyArgsAndReturn(evt_out);
+	} else {
+		__cmock_slab_event_create_ExpectAndReturn(id, evt_out);
+	}
+	__cmock_slab_event_acquire_Expect(evt_out);
+	__cmock_slab_stim_childs_Expect(s, evt_out);
+}
+
+/*==============================[Tests]=======================================*/
+void test_slab_delay_create(void)
+{
+	const uint32_t delay_periods = 50;
+	struct slab *s;
+	struct slab_delay *sd;
+	struct rbuf_sizes sizes;
+
+	s = slab_delay_create(delay_periods);
+	sd = (struct slab_delay *)s;
+	TEST_ASSERT_EQUAL(delay_periods, sd->length);
+
+	rbuf_sizes_get(&sd->line, &sizes);
+	TEST_ASSERT_EQUAL(delay_periods * SLAB_DELAY_ENTRY_SIZE, sizes.max);
+	TEST_ASSERT_EQUAL(0, sizes.used);
+
+	slab_delay_destroy(s);
+}
+
+void test_slab_delay_stim_rgb(void)
+{
+	const uint32_t delay_periods = 2;
+	struct slab *s;
+	struct slab_delay *sd;
+	struct slab_event_rgb evt[3];
+	struct slab_event_rgb evt_out;
+
+	for (int i = 0; i < ARRAY_SIZE(evt); i++) {
+		evt[i].id = SLAB_EVENT_RGB;
+		evt[i].num_refs = 1;
+	}
+
+	s = slab_delay_create(delay_periods);
+	sd = (struct slab_delay *)s;
+
+	/* The first two events fill the delay line. Their values are stored,
+	 * the events themselves are released right away.
+	 */
+	stim_and_release(s, (struct slab_event *)&evt[0]);
+	TEST_ASSERT_EQUAL(SLAB_DELAY_ENTRY_SIZE, line_used(sd));
+
+	stim_and_release(s, (struct slab_event *)&evt[1]);
+	TEST_ASSERT_EQUAL(2 * SLAB_DELAY_ENTRY_SIZE, line_used(sd));
+
+	/* The third event pushes out the value of the first one as a new event. */
+	expect_sent(s, SLAB_EVENT_RGB, (struct slab_event *)&evt_out);
+	stim_and_release(s, (struct slab_event *)&evt[2]);
+	TEST_ASSERT_EQUAL(2 * SLAB_DELAY_ENTRY_SIZE, line_used(sd));
+
+	/* No references are held, so nothing is released on destroy. */
+	slab_delay_destroy(s);
+}
+
+void test_slab_delay_stim_hsv(void)
+{
+	const uint32_t delay_periods = 1;
+	struct slab *s;
+	struct slab_event_hsv evt[2];
+	struct slab_event_hsv evt_out;
+
+	for (int i = 0; i < ARRAY_SIZE(evt); i++) {
+		evt[i].id = SLAB_EVENT_HSV;
+		evt[i].num_refs = 1;
+		evt[i].h = 120.0f;
+		evt[i].s = 0.5f;
+		evt[i].v = 1.0f;
+	}
+
+	s = slab_delay_create(delay_periods);
+
+	stim_and_release(s, (struct slab_event *)&evt[0]);
+
+	expect_sent(s, SLAB_EVENT_HSV, (struct slab_event *)&evt_out);
+	stim_and_release(s, (struct slab_event *)&evt[1]);
+
+	slab_delay_destroy(s);
+}
+
+void test_slab_delay_stim_tick(void)
+{
+	const uint32_t delay_periods = 1;
+	struct slab *s;
+	struct slab_event_tick evt[2];
+	struct slab_event_tick evt_out;
+
+	for (int i = 0; i < ARRAY_SIZE(evt); i++) {
+		evt[i].id = SLAB_EVENT_TICK;
+		evt[i].num_refs = 1;
+		evt[i].time = 25 * i;
+	}
+
+	s = slab_delay_create(delay_periods);
+
+	stim_and_release(s, (struct slab_event *)&evt[0]);
+
+	expect_sent(s, SLAB_EVENT_TICK, (struct slab_event *)&evt_out);
+	stim_and_release(s, (struct slab_event *)&evt[1]);
+
+	slab_delay_destroy(s);
+}
+
+void test_slab_delay_stim_reset(void)
+{
+	const uint32_t delay_periods = 2;
+	struct slab *s;
+	struct slab_delay *sd;
+	struct slab_event_rgb evt[3];
+	struct slab_event_rgb evt_out;
+	struct slab_event reset_evt = {.id = SLAB_EVENT_RESET, .num_refs = 1};
+
+	for (int i = 0; i < ARRAY_SIZE(evt); i++) {
+		evt[i].id = SLAB_EVENT_RGB;
+		evt[i].num_refs = 1;
+	}
+
+	s = slab_delay_create(delay_periods);
+	sd = (struct slab_delay *)s;
+
+	stim_and_release(s, (struct slab_event *)&evt[0]);
+	stim_and_release(s, (struct slab_event *)&evt[1]);
+
+	/* A reset empties the delay line and is forwarded. */
+	__cmock_slab_stim_childs_Expect(s, &reset_evt);
+	slab_delay_stim(s, &reset_evt);
+	TEST_ASSERT_EQUAL(0, line_used(sd));
+
+	/* Delaying starts over after the reset. */
+	stim_and_release(s, (struct slab_event *)&evt[0]);
+	stim_and_release(s, (struct slab_event *)&evt[1]);
+
+	expect_sent(s, SLAB_EVENT_RGB, (struct slab_event *)&evt_out);
+	stim_and_release(s, (struct slab_event *)&evt[2]);
+
+	slab_delay_destroy(s);
+}
+
+void test_slab_delay_stim_default(void)
+{
+	const uint32_t delay_periods = 2;
+	struct slab *s;
+	struct slab_delay *sd;
+	struct slab_event evt = {.id = SLAB_EVENT_RESET + 100, .num_refs = 1};
+
+	s = slab_delay_create(delay_periods);
+	sd = (struct slab_delay *)s;
+
+	/* Unknown events are forwarded without taking a period. */
+	__cmock_slab_stim_childs_Expect(s, &evt);
+	slab_delay_stim(s, &evt);
+	TEST_ASSERT_EQUAL(0, line_used(sd));
+
+	slab_delay_destroy(s);
+}
+
+/*============================================================================*/
+
+extern int unity_main(void);
+
+int main(void)
+{
+	return unity_main();
+}
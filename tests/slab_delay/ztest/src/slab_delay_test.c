@@ -0,0 +1,183 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "rgb_hsv.h"
+#include "slabs/slab_delay.h"
+#include "slabs/slab_notifier.h"
+#include "../lib/slab/events/slab_event_tick.h"
+#include "../lib/slab/events/slab_event_rgb.h"
+#include "../lib/slab/events/slab_event_hsv.h"
+
+/* Steps of the quantized HSV values in the delay line */
+#define HUE_STEP (1.0f / 64)
+#define SV_STEP  (1.0f / 255)
+
+/* Last event sent by the delay */
+static struct {
+	int num;
+	enum slab_event_id id;
+	uint32_t time;
+	struct rgb_value rgb;
+	struct rgb16_value rgb16;
+	struct hsv_value hsv;
+} out;
+
+static struct slab *delay;
+static struct slab *output;
+
+static void output_callback(struct slab_event *evt, void *ctx)
+{
+	out.num += 1;
+	out.id = evt->id;
+
+	switch (evt->id) {
+	case SLAB_EVENT_TICK:
+		out.time = slab_event_tick_get_time(evt);
+		break;
+	case SLAB_EVENT_RGB:
+		out.rgb = slab_event_rgb_get_val(evt);
+		out.rgb16 = slab_event_rgb_get_val16(evt);
+		break;
+	case SLAB_EVENT_HSV:
+		out.hsv = slab_event_hsv_get_val(evt);
+		break;
+	default:
+		break;
+	}
+}
+
+static void slab_delay_suite_before(void *fixture)
+{
+	memset(&out, 0, sizeof(out));
+
+	delay = slab_create(SLAB_TYPE_DELAY, 1);
+	output = slab_create(SLAB_TYPE_NOTIFIER, output_callback, NULL);
+	slab_connect(output, delay);
+}
+
+static void slab_delay_suite_after(void *fixture)
+{
+	struct slab_event_pool_stats stats;
+
+	slab_destroy(output);
+	slab_destroy(delay);
+
+	/* Every event must be back in its pool after each test. */
+	for (int id = SLAB_EVENT_TICK; id <= SLAB_EVENT_HSV; id++) {
+		slab_event_pool_stats_get(id, &stats);
+		zassert_equal(stats.num_used, 0);
+	}
+}
+
+ZTEST_SUITE(slab_delay_suite, NULL, NULL, slab_delay_suite_before, slab_delay_suite_after, NULL);
+
+/* Send a value through the delay of one period, pushing it out with a second one */
+static void delay_hsv(float h, float s, float v)
+{
+	struct hsv_value val = {.h = COLOR_NUM_FROM_FLOAT(h),
+				.s = COLOR_NUM_FROM_FLOAT(s),
+				.v = COLOR_NUM_FROM_FLOAT(v)};
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_HSV, val));
+	slab_stim(delay, slab_event_create(SLAB_EVENT_HSV, val));
+	zassert_equal(out.id, SLAB_EVENT_HSV);
+}
+
+ZTEST(slab_delay_suite, test_tick_round_trip)
+{
+	const uint32_t times[] = {0, 25, 0x12345678, UINT32_MAX};
+
+	for (int i = 0; i < ARRAY_SIZE(times); i++) {
+		slab_stim(delay, slab_event_create(SLAB_EVENT_TICK, times[i]));
+		slab_stim(delay, slab_event_create(SLAB_EVENT_TICK, times[i] + 1));
+
+		zassert_equal(out.id, SLAB_EVENT_TICK);
+		zassert_equal(out.time, times[i]);
+	}
+}
+
+ZTEST(slab_delay_suite, test_rgb_round_trip)
+{
+	const struct rgb_value vals[] = {{0, 0, 0}, {1, 128, 255}, {255, 254, 0}};
+
+	for (int i = 0; i < ARRAY_SIZE(vals); i++) {
+		slab_stim(delay, slab_event_create(SLAB_EVENT_RGB, vals[i]));
+		slab_stim(delay, slab_event_create(SLAB_EVENT_RGB, vals[0]));
+
+		zassert_equal(out.id, SLAB_EVENT_RGB);
+		zassert_equal(out.rgb.r, vals[i].r);
+		zassert_equal(out.rgb.g, vals[i].g);
+		zassert_equal(out.rgb.b, vals[i].b);
+	}
+}
+
+ZTEST(slab_delay_suite, test_hsv_round_trip_is_quantized)
+{
+	/* Values are kept to within half a step */
+	delay_hsv(123.4f, 0.5f, 0.2f);
+	zassert_within(COLOR_NUM_TO_FLOAT(out.hsv.h), 123.4f, HUE_STEP / 2);
+	zassert_within(COLOR_NUM_TO_FLOAT(out.hsv.s), 0.5f, SV_STEP / 2);
+	zassert_within(COLOR_NUM_TO_FLOAT(out.hsv.v), 0.2f, SV_STEP / 2);
+
+	/* The ends of the ranges are kept exactly */
+	delay_hsv(0.0f, 0.0f, 1.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.h), 0.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.s), 0.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.v), 1.0f);
+
+	delay_hsv(360.0f, 1.0f, 0.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.h), 360.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.s), 1.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.v), 0.0f);
+
+	/* Values out of range are clamped */
+	delay_hsv(400.0f, 1.5f, -0.5f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.h), 360.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.s), 1.0f);
+	zassert_equal(COLOR_NUM_TO_FLOAT(out.hsv.v), 0.0f);
+}
+
+ZTEST(slab_delay_suite, test_values_keep_their_order)
+{
+	struct rgb_value rgb = {10, 20, 30};
+	struct hsv_value hsv = {.h = COLOR_NUM(90), .s = COLOR_NUM_ONE, .v = COLOR_NUM_ONE};
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_TICK, 7));
+	zassert_equal(out.num, 0);
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_RGB, rgb));
+	zassert_equal(out.id, SLAB_EVENT_TICK);
+	zassert_equal(out.time, 7);
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_HSV, hsv));
+	zassert_equal(out.id, SLAB_EVENT_RGB);
+	zassert_equal(out.rgb.g, 20);
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_TICK, 8));
+	zassert_equal(out.id, SLAB_EVENT_HSV);
+	zassert_within(COLOR_NUM_TO_FLOAT(out.hsv.h), 90.0f, HUE_STEP / 2);
+	zassert_equal(out.num, 3);
+
+	/* A reset drops the value still in the line and is forwarded. */
+	slab_stim(delay, slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(out.id, SLAB_EVENT_RESET);
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_RGB, rgb));
+	zassert_equal(out.num, 4);
+}
+
+ZTEST(slab_delay_suite, test_rgb_fraction_is_kept)
+{
+	struct rgb16_value val = {.r = 0x0280, .g = 0x1001, .b = 0xfeff};
+
+	slab_stim(delay, slab_event_create_rgb16(val));
+	slab_stim(delay, slab_event_create_rgb16(val));
+
+	zassert_equal(out.id, SLAB_EVENT_RGB);
+	zassert_equal(out.rgb16.r, 0x0280);
+	zassert_equal(out.rgb16.g, 0x1001);
+	zassert_equal(out.rgb16.b, 0xfeff);
+	zassert_equal(out.rgb.r, 2);
+}
@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <zephyr/ztest.h>
+
+#include "slab_event.h"
+#include "rgb_hsv.h"
+#include "../lib/slab/events/slab_event_tick.h"
+#include "../lib/slab/events/slab_event_rgb.h"
+
+static void slab_event_suite_before(void *fixture)
+{
+	slab_event_pool_stats_reset();
+}
+
+ZTEST_SUITE(slab_event_suite, NULL, NULL, slab_event_suite_before, NULL, NULL);
+
+ZTEST(slab_event_suite, test_pool_sizes)
+{
+	struct slab_event_pool_stats stats;
+
+	zassert_equal(slab_event_pool_stats_get(SLAB_EVENT_RESET, &stats), 0);
+	zassert_equal(stats.num_blocks, CONFIG_SLAB_EVENT_POOL_RESET_BLOCKS);
+	zassert_equal(slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats), 0);
+	zassert_equal(stats.num_blocks, CONFIG_SLAB_EVENT_POOL_TICK_BLOCKS);
+	zassert_equal(slab_event_pool_stats_get(SLAB_EVENT_RGB, &stats), 0);
+	zassert_equal(stats.num_blocks, CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS);
+	zassert_equal(slab_event_pool_stats_get(SLAB_EVENT_HSV, &stats), 0);
+	zassert_equal(stats.num_blocks, CONFIG_SLAB_EVENT_POOL_HSV_BLOCKS);
+
+	zassert_equal(slab_event_pool_stats_get(0, &stats), -EINVAL);
+	zassert_equal(slab_event_pool_stats_get(SLAB_EVENT_TICK, NULL), -EINVAL);
+}
+
+ZTEST(slab_event_suite, test_create_and_release)
+{
+	struct slab_event *evt;
+	struct slab_event_pool_stats stats;
+
+	evt = slab_event_create(SLAB_EVENT_TICK, 1234);
+	zassert_not_null(evt);
+	zassert_equal(evt->id, SLAB_EVENT_TICK);
+	zassert_equal(evt->num_refs, 0);
+	zassert_equal(slab_event_tick_get_time(evt), 1234);
+
+	slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats);
+	zassert_equal(stats.num_used, 1);
+	zassert_equal(stats.max_used, 1);
+
+	slab_event_acquire(evt);
+	slab_event_release(evt);
+
+	slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats);
+	zassert_equal(stats.num_used, 0);
+	zassert_equal(stats.max_used, 1);
+	zassert_equal(stats.num_exhausted, 0);
+}
+
+ZTEST(slab_event_suite, test_pool_exhaustion)
+{
+	struct slab_event *evt[CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS];
+	struct rgb_value val = {.r = 1, .g = 2, .b = 3};
+	struct slab_event_pool_stats stats;
+
+	for (int i = 0; i < CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS; i++) {
+		evt[i] = slab_event_create(SLAB_EVENT_RGB, val);
+		zassert_not_null(evt[i]);
+	}
+
+	/* Pool is empty, creation fails without touching the heap. */
+	zassert_is_null(slab_event_create(SLAB_EVENT_RGB, val));
+	zassert_is_null(slab_event_create(SLAB_EVENT_RGB, val));
+
+	slab_event_pool_stats_get(SLAB_EVENT_RGB, &stats);
+	zassert_equal(stats.num_used, CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS);
+	zassert_equal(stats.max_used, CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS);
+	zassert_equal(stats.num_exhausted, 2);
+
+	/* Other event types have their own pools. */
+	struct slab_event *tick = slab_event_create(SLAB_EVENT_TICK, 0);
+
+	zassert_not_null(tick);
+	slab_event_destroy(tick);
+
+	/* Blocks are reusable once released. */
+	slab_event_destroy(evt[0]);
+	evt[0] = slab_event_create(SLAB_EVENT_RGB, val);
+	zassert_not_null(evt[0]);
+	zassert_equal(slab_event_rgb_get_val(evt[0]).b, 3);
+
+	for (int i = 0; i < CONFIG_SLAB_EVENT_POOL_RGB_BLOCKS; i++) {
+		slab_event_destroy(evt[i]);
+	}
+
+	slab_event_pool_stats_get(SLAB_EVENT_RGB, &stats);
+	zassert_equal(stats.num_used, 0);
+
+	slab_event_pool_stats_reset();
+	slab_event_pool_stats_get(SLAB_EVENT_RGB, &stats);
+	zassert_equal(stats.max_used, 0);
+	zassert_equal(stats.num_exhausted, 0);
+}
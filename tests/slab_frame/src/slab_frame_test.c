@@ -0,0 +1,293 @@
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "rgb_hsv.h"
+#include "slabs/slab_gamma.h"
+#include "slabs/slab_led.h"
+#include "slabs/slab_notifier.h"
+#include "../lib/slab/events/slab_event_rgb_frame.h"
+
+#define NUM_PIXELS 8
+
+static struct slab_event_pool_stats rgb_frame_stats;
+static struct slab_event_pool_stats hsv_frame_stats;
+
+static void slab_frame_suite_after(void *fixture)
+{
+	/* Every frame event must be back in its pool after each test. */
+	slab_event_pool_stats_get(SLAB_EVENT_RGB_FRAME, &rgb_frame_stats);
+	slab_event_pool_stats_get(SLAB_EVENT_HSV_FRAME, &hsv_frame_stats);
+	zassert_equal(rgb_frame_stats.num_used, 0);
+	zassert_equal(hsv_frame_stats.num_used, 0);
+}
+
+ZTEST_SUITE(slab_frame_suite, NULL, NULL, NULL, slab_frame_suite_after, NULL);
+
+static struct rgb_value gray(uint8_t level)
+{
+	struct rgb_value val = {.r = level, .g = level, .b = level};
+
+	return val;
+}
+
+ZTEST(slab_frame_suite, test_led_strip_writes_its_segment)
+{
+	struct rgb_value pixels[NUM_PIXELS];
+	uint8_t leds[3 * 3];
+	struct slab *strip;
+
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		pixels[i].r = i;
+		pixels[i].g = 10 + i;
+		pixels[i].b = 20 + i;
+	}
+	memset(leds, 0xff, sizeof(leds));
+
+	strip = slab_create(SLAB_TYPE_LED_STRIP, leds, 2, 3, LED_TYPE_GRB);
+	zassert_not_null(strip);
+
+	slab_stim(strip, slab_event_create(SLAB_EVENT_RGB_FRAME, pixels, NUM_PIXELS));
+	for (int i = 0; i < 3; i++) {
+		zassert_equal(leds[3 * i + 0], pixels[2 + i].r);
+		zassert_equal(leds[3 * i + 1], pixels[2 + i].g);
+		zassert_equal(leds[3 * i + 2], pixels[2 + i].b);
+	}
+
+	/* A single color is written to every LED of the strip. */
+	slab_stim(strip, slab_event_create(SLAB_EVENT_RGB, gray(7)));
+	for (int i = 0; i < sizeof(leds); i++) {
+		zassert_equal(leds[i], 7);
+	}
+
+	slab_destroy(strip);
+}
+
+ZTEST(slab_frame_suite, test_led_strip_clips_short_frames)
+{
+	struct rgb_value pixels[4];
+	uint8_t leds[4];
+	struct slab *strip;
+
+	for (int i = 0; i < 4; i++) {
+		pixels[i] = gray(i + 1);
+	}
+	memset(leds, 0, sizeof(leds));
+
+	strip = slab_create(SLAB_TYPE_LED_STRIP, leds, 2, 4, LED_TYPE_RED);
+	slab_stim(strip, slab_event_create(SLAB_EVENT_RGB_FRAME, pixels, 4));
+
+	zassert_equal(leds[0], 3);
+	zassert_equal(leds[1], 4);
+	zassert_equal(leds[2], 0);
+	zassert_equal(leds[3], 0);
+
+	slab_destroy(strip);
+}
+
+ZTEST(slab_frame_suite, test_hsv2rgb_converts_frames)
+{
+	struct hsv_value hsv_pixels[NUM_PIXELS];
+	uint8_t leds[3 * NUM_PIXELS];
+	struct slab *conv;
+	struct slab *strip;
+
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		hsv_pixels[i].h = 45.0f * i;
+		hsv_pixels[i].s = 1.0f;
+		hsv_pixels[i].v = 1.0f;
+	}
+
+	conv = slab_create(SLAB_TYPE_HSV2RGB);
+	strip = slab_create(SLAB_TYPE_LED_STRIP, leds, 0, NUM_PIXELS, LED_TYPE_GRB);
+	slab_connect(strip, conv);
+
+	slab_stim(conv, slab_event_create(SLAB_EVENT_HSV_FRAME, hsv_pixels, NUM_PIXELS));
+
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		struct rgb_value expected = hsv2rgb(hsv_pixels[i]);
+
+		zassert_equal(leds[3 * i + 0], expected.r);
+		zassert_equal(leds[3 * i + 1], expected.g);
+		zassert_equal(leds[3 * i + 2], expected.b);
+	}
+
+	slab_destroy(strip);
+	slab_destroy(conv);
+}
+
+static struct slab_event *held_frames[CONFIG_SLAB_FRAME_BUFFERS + 1];
+static int num_held_frames;
+
+/* Keeps frames like an inbox or work list holding events that wait */
+static void hold_frame(struct slab_event *evt, void *ctx)
+{
+	if (evt->id == SLAB_EVENT_RGB_FRAME && num_held_frames < ARRAY_SIZE(held_frames)) {
+		slab_event_acquire(evt);
+		held_frames[num_held_frames++] = evt;
+	}
+}
+
+ZTEST(slab_frame_suite, test_hsv2rgb_keeps_frames_in_use)
+{
+	struct hsv_value hsv_pixels[NUM_PIXELS];
+	const struct rgb_value *pixels[CONFIG_SLAB_FRAME_BUFFERS];
+	struct rgb_value first;
+	uint32_t num_pixels;
+	struct slab *conv;
+	struct slab *holder;
+
+	conv = slab_create(SLAB_TYPE_HSV2RGB);
+	holder = slab_create(SLAB_TYPE_NOTIFIER, hold_frame, NULL);
+	slab_connect(holder, conv);
+	num_held_frames = 0;
+
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		hsv_pixels[i].h = 0.0f;
+		hsv_pixels[i].s = 1.0f;
+		hsv_pixels[i].v = 1.0f;
+	}
+	first = hsv2rgb(hsv_pixels[0]);
+
+	/* Every held frame gets its own buffer */
+	for (int n = 0; n < CONFIG_SLAB_FRAME_BUFFERS; n++) {
+		hsv_pixels[0].h = 90.0f * (n + 1);
+		slab_stim(conv, slab_event_create(SLAB_EVENT_HSV_FRAME, hsv_pixels, NUM_PIXELS));
+		zassert_equal(num_held_frames, n + 1);
+
+		pixels[n] = slab_event_rgb_frame_get_pixels(held_frames[n], &num_pixels);
+		zassert_equal(num_pixels, NUM_PIXELS);
+		for (int i = 0; i < n; i++) {
+			zassert_not_equal(pixels[n], pixels[i]);
+		}
+	}
+	zassert_equal(pixels[0][1].r, first.r);
+	zassert_equal(pixels[0][1].g, first.g);
+
+	/* With all buffers held, frames are dropped instead of overwriting them */
+	slab_stim(conv, slab_event_create(SLAB_EVENT_HSV_FRAME, hsv_pixels, NUM_PIXELS));
+	zassert_equal(num_held_frames, CONFIG_SLAB_FRAME_BUFFERS);
+
+	/* A buffer is reused once its frame is let go */
+	slab_event_release(held_frames[0]);
+	num_held_frames = 0;
+	slab_stim(conv, slab_event_create(SLAB_EVENT_HSV_FRAME, hsv_pixels, NUM_PIXELS));
+	zassert_equal(num_held_frames, 1);
+	zassert_equal(slab_event_rgb_frame_get_pixels(held_frames[0], &num_pixels), pixels[0]);
+
+	slab_event_release(held_frames[0]);
+	for (int n = 1; n < CONFIG_SLAB_FRAME_BUFFERS; n++) {
+		slab_event_release(held_frames[n]);
+	}
+	slab_destroy(holder);
+	slab_destroy(conv);
+}
+
+ZTEST(slab_frame_suite, test_delay_keeps_copies_of_frames)
+{
+	const uint32_t delay_periods = 2;
+	struct rgb_value pixels[NUM_PIXELS];
+	uint8_t leds[NUM_PIXELS];
+	struct slab *delay;
+	struct slab *strip;
+
+	delay = slab_create(SLAB_TYPE_DELAY, delay_periods);
+	strip = slab_create(SLAB_TYPE_LED_STRIP, leds, 0, NUM_PIXELS, LED_TYPE_RED);
+	slab_connect(strip, delay);
+	memset(leds, 0, sizeof(leds));
+
+	/* The producer reuses its buffer for every frame. */
+	for (int frame = 1; frame <= 4; frame++) {
+		for (int i = 0; i < NUM_PIXELS; i++) {
+			pixels[i] = gray(frame);
+		}
+
+		slab_stim(delay, slab_event_create(SLAB_EVENT_RGB_FRAME, pixels, NUM_PIXELS));
+
+		for (int i = 0; i < NUM_PIXELS; i++) {
+			zassert_equal(leds[i], (frame > delay_periods) ? frame - delay_periods : 0);
+		}
+	}
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_RESET));
+
+	slab_destroy(strip);
+	slab_destroy(delay);
+}
+
+ZTEST(slab_frame_suite, test_gamma_corrects_values_and_frames)
+{
+	struct gamma_config config = GAMMA_CONFIG_LINEAR;
+	struct rgb_value pixels[NUM_PIXELS];
+	uint8_t leds[NUM_PIXELS * 3];
+	struct slab *gamma;
+	struct slab *strip;
+
+	config.brightness = 127;
+	gamma = slab_create(SLAB_TYPE_GAMMA, &config);
+	strip = slab_create(SLAB_TYPE_LED_STRIP, leds, 0, NUM_PIXELS, LED_TYPE_RGB);
+	slab_connect(strip, gamma);
+
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		pixels[i] = gray(2 * i);
+	}
+
+	slab_stim(gamma, slab_event_create(SLAB_EVENT_RGB_FRAME, pixels, NUM_PIXELS));
+	for (int i = 0; i < NUM_PIXELS; i++) {
+		zassert_equal(leds[3 * i], (2 * i * 127 + 127) / 255);
+		/* The producer's pixels are left alone. */
+		zassert_equal(pixels[i].r, 2 * i);
+	}
+
+	/* A new configuration takes effect at the next event. */
+	config.brightness = 255;
+	config.gamma = 2.0f;
+	slab_gamma_config_set(gamma, &config);
+
+	slab_stim(gamma, slab_event_create(SLAB_EVENT_RGB, gray(128)));
+	zassert_equal(leds[0], 64);
+	zassert_equal(leds[3 * (NUM_PIXELS - 1)], 64);
+
+	slab_destroy(strip);
+	slab_destroy(gamma);
+}
+
+ZTEST(slab_frame_suite, test_gamma_keeps_frames_in_use)
+{
+	struct gamma_config config = GAMMA_CONFIG_LINEAR;
+	struct rgb_value pixels[NUM_PIXELS];
+	const struct rgb_value *corrected[2];
+	uint32_t num_pixels;
+	struct slab *gamma;
+	struct slab *holder;
+
+	gamma = slab_create(SLAB_TYPE_GAMMA, &config);
+	holder = slab_create(SLAB_TYPE_NOTIFIER, hold_frame, NULL);
+	slab_connect(holder, gamma);
+	num_held_frames = 0;
+
+	/* A second frame does not overwrite the held first one */
+	for (int frame = 0; frame < 2; frame++) {
+		for (int i = 0; i < NUM_PIXELS; i++) {
+			pixels[i] = gray(10 * (frame + 1));
+		}
+		slab_stim(gamma, slab_event_create(SLAB_EVENT_RGB_FRAME, pixels, NUM_PIXELS));
+	}
+	zassert_equal(num_held_frames, MIN(2, CONFIG_SLAB_FRAME_BUFFERS));
+
+	corrected[0] = slab_event_rgb_frame_get_pixels(held_frames[0], &num_pixels);
+	zassert_equal(num_pixels, NUM_PIXELS);
+	zassert_equal(corrected[0][NUM_PIXELS - 1].r, 10);
+	if (num_held_frames > 1) {
+		corrected[1] = slab_event_rgb_frame_get_pixels(held_frames[1], &num_pixels);
+		zassert_equal(corrected[1][NUM_PIXELS - 1].r, 20);
+	}
+
+	for (int n = 0; n < num_held_frames; n++) {
+		slab_event_release(held_frames[n]);
+	}
+	slab_destroy(holder);
+	slab_destroy(gamma);
+}
@@ -0,0 +1,392 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_graph.h"
+#include "slabs/slab_delay.h"
+#include "slabs/slab_notifier.h"
+
+#define NUM_NODES 6
+
+static const char names[NUM_NODES] = {'a', 'b', 'c', 'd', 'e', 'f'};
+static struct slab *nodes[NUM_NODES];
+static struct slab_graph graph;
+
+static char trace[32];
+static int trace_len;
+
+static void trace_callback(struct slab_event *evt, void *ctx)
+{
+	if (trace_len < sizeof(trace) - 1) {
+		trace[trace_len++] = *(const char *)ctx;
+	}
+}
+
+static void slab_graph_suite_before(void *fixture)
+{
+	memset(trace, 0, sizeof(trace));
+	trace_len = 0;
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		nodes[i] = slab_create(SLAB_TYPE_NOTIFIER, trace_callback, (void *)&names[i]);
+		zassert_not_null(nodes[i]);
+	}
+
+	/* a -> b -> d -> e
+	 * a -> c -> d
+	 * a -> f
+	 */
+	slab_connect(nodes[1], nodes[0]);
+	slab_connect(nodes[2], nodes[0]);
+	slab_connect(nodes[3], nodes[1]);
+	slab_connect(nodes[3], nodes[2]);
+	slab_connect(nodes[4], nodes[3]);
+	slab_connect(nodes[5], nodes[0]);
+}
+
+static void slab_graph_suite_after(void *fixture)
+{
+	slab_graph_release(&graph);
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		slab_destroy(nodes[i]);
+	}
+}
+
+ZTEST_SUITE(slab_graph_suite, NULL, NULL, slab_graph_suite_before, slab_graph_suite_after, NULL);
+
+static int step_of(struct slab *slab)
+{
+	for (int i = 0; i < graph.num_steps; i++) {
+		if (graph.steps[i].slab == slab) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+ZTEST(slab_graph_suite, test_compile_orders_parents_first)
+{
+	zassert_equal(slab_graph_compile(&graph, nodes[0]), 0);
+	zassert_equal(graph.num_steps, NUM_NODES);
+	zassert_equal(graph.num_edges, 6);
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		zassert_not_equal(step_of(nodes[i]), -1);
+	}
+
+	zassert_equal(step_of(nodes[0]), 0);
+	zassert_true(step_of(nodes[1]) < step_of(nodes[3]));
+	zassert_true(step_of(nodes[2]) < step_of(nodes[3]));
+	zassert_true(step_of(nodes[3]) < step_of(nodes[4]));
+}
+
+ZTEST(slab_graph_suite, test_compile_subgraph)
+{
+	zassert_equal(slab_graph_compile(&graph, nodes[3]), 0);
+	zassert_equal(graph.num_steps, 2);
+	zassert_equal(graph.num_edges, 1);
+}
+
+ZTEST(slab_graph_suite, test_compile_rejects_cycle)
+{
+	slab_connect(nodes[0], nodes[4]);
+	zassert_equal(slab_graph_compile(&graph, nodes[0]), -ELOOP);
+	slab_disconnect(nodes[0], nodes[4]);
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		zassert_is_null(nodes[i]->step);
+	}
+}
+
+ZTEST(slab_graph_suite, test_compile_rejects_compiled_slab)
+{
+	struct slab_graph other;
+
+	zassert_equal(slab_graph_compile(&graph, nodes[0]), 0);
+	zassert_equal(slab_graph_compile(&other, nodes[3]), -EBUSY);
+	zassert_equal(slab_graph_compile(NULL, nodes[0]), -EINVAL);
+	zassert_equal(slab_graph_compile(&other, NULL), -EINVAL);
+}
+
+ZTEST(slab_graph_suite, test_stim_visits_in_schedule_order)
+{
+	struct slab_event_pool_stats stats;
+
+	zassert_equal(slab_graph_compile(&graph, nodes[0]), 0);
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+
+	/* d is reached through both b and c, so it and its child run twice. */
+	zassert_equal(trace_len, 8);
+	zassert_equal(trace[0], 'a');
+	zassert_true(strchr(trace, 'e') > strrchr(trace, 'b'));
+	zassert_true(strchr(trace, 'e') > strrchr(trace, 'c'));
+	zassert_true(strchr(trace, 'd') > strrchr(trace, 'b'));
+	zassert_equal(graph.num_dropped, 0);
+
+	slab_event_pool_stats_get(SLAB_EVENT_RESET, &stats);
+	zassert_equal(stats.num_used, 0);
+}
+
+ZTEST(slab_graph_suite, test_release_restores_recursive_stim)
+{
+	zassert_equal(slab_graph_compile(&graph, nodes[0]), 0);
+	slab_graph_release(&graph);
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		zassert_is_null(nodes[i]->step);
+	}
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 8);
+	zassert_equal(trace[0], 'a');
+
+	/* Slabs can be rewired again once the graph is released. */
+	slab_disconnect(nodes[5], nodes[0]);
+}
+
+ZTEST(slab_graph_suite, test_mask_skips_childs)
+{
+	/* f only takes ticks. */
+	slab_connect_mask(nodes[5], nodes[0], SLAB_EVENT_MASK(SLAB_EVENT_TICK));
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 7);
+	zassert_is_null(strchr(trace, 'f'));
+
+	/* Compiled graphs keep the masks on their edges. */
+	zassert_equal(slab_graph_compile(&graph, nodes[0]), 0);
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 14);
+	zassert_is_null(strchr(trace, 'f'));
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_TICK, 0));
+	zassert_equal(trace_len, 22);
+	zassert_not_null(strchr(trace, 'f'));
+	slab_graph_release(&graph);
+
+	/* Connecting again replaces the mask. */
+	slab_connect(nodes[5], nodes[0]);
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 30);
+}
+
+/* Static graph
+ *
+ * a -> b -> d -> e
+ * a -> c -> d
+ * a -> delay -> f
+ */
+SLAB_NOTIFIER_DEFINE(sa, trace_callback, (void *)&names[0]);
+SLAB_NOTIFIER_DEFINE(sb, trace_callback, (void *)&names[1]);
+SLAB_NOTIFIER_DEFINE(sc, trace_callback, (void *)&names[2]);
+SLAB_NOTIFIER_DEFINE(sd, trace_callback, (void *)&names[3]);
+SLAB_NOTIFIER_DEFINE(se, trace_callback, (void *)&names[4]);
+SLAB_NOTIFIER_DEFINE(sf, trace_callback, (void *)&names[5]);
+SLAB_DELAY_DEFINE(sdelay, 1);
+
+SLAB_GRAPH_DEFINE(static_graph,
+	SLAB_EDGE(sa, sb),
+	SLAB_EDGE(sa, sc),
+	SLAB_EDGE(sb, sd),
+	SLAB_EDGE(sc, sd),
+	SLAB_EDGE(sd, se),
+	SLAB_EDGE(sa, sdelay),
+	SLAB_EDGE(sdelay, sf));
+
+/* Shares slab d with the graph above */
+SLAB_GRAPH_DEFINE(overlapping_graph,
+	SLAB_EDGE(sd, se));
+
+/* Passes resets to b, and ticks and colors to c */
+SLAB_GRAPH_DEFINE(masked_graph,
+	SLAB_EDGE_MASK(sa, sb, SLAB_EVENT_MASK(SLAB_EVENT_RESET)),
+	SLAB_EDGE_MASK(sa, sc, SLAB_EVENT_MASK(SLAB_EVENT_TICK)),
+	SLAB_EDGE_MASK(sa, sc, SLAB_EVENT_MASK(SLAB_EVENT_RGB)));
+
+SLAB_NOTIFIER_DEFINE(sx, trace_callback, (void *)&names[0]);
+SLAB_NOTIFIER_DEFINE(sy, trace_callback, (void *)&names[1]);
+
+SLAB_GRAPH_DEFINE(loop_graph,
+	SLAB_EDGE(sx, sy),
+	SLAB_EDGE(sy, sx));
+
+/* Two parts with as many edges as a connected graph of their slabs needs */
+SLAB_GRAPH_DEFINE(split_graph,
+	SLAB_EDGE(sa, sb),
+	SLAB_EDGE(sb, sc),
+	SLAB_EDGE(sa, sc),
+	SLAB_EDGE(sx, sy));
+
+static void slab_static_graph_suite_before(void *fixture)
+{
+	memset(trace, 0, sizeof(trace));
+	trace_len = 0;
+}
+
+static void slab_static_graph_suite_after(void *fixture)
+{
+	slab_graph_stop(&static_graph);
+	slab_graph_stop(&overlapping_graph);
+	slab_graph_stop(&loop_graph);
+	slab_graph_stop(&masked_graph);
+	slab_graph_stop(&split_graph);
+}
+
+ZTEST_SUITE(slab_static_graph_suite, NULL, NULL, slab_static_graph_suite_before,
+	    slab_static_graph_suite_after, NULL);
+
+ZTEST(slab_static_graph_suite, test_start_connects_and_schedules)
+{
+	struct slab_graph *g = &static_graph.graph;
+
+	zassert_equal(slab_graph_start(&static_graph), 0);
+	zassert_equal(g->num_steps, 7);
+	zassert_equal(g->num_edges, 7);
+
+	zassert_equal(sa.childs.num, 3);
+	zassert_equal(sa.childs.list[0], SLAB_OF(sb));
+	zassert_equal(sa.childs.list[1], SLAB_OF(sc));
+	zassert_equal(sa.childs.list[2], SLAB_OF(sdelay));
+	zassert_equal(sd.childs.num, 1);
+	zassert_equal(se.childs.num, 0);
+
+	zassert_equal(g->steps[0].slab, SLAB_OF(sa));
+	zassert_true(sb.step < sd.step);
+	zassert_true(sc.step < sd.step);
+	zassert_true(sd.step < se.step);
+	zassert_true(sdelay.step < sf.step);
+}
+
+ZTEST(slab_static_graph_suite, test_static_stim_visits_in_schedule_order)
+{
+	zassert_equal(slab_graph_start(&static_graph), 0);
+
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_RESET));
+
+	zassert_equal(trace_len, 8);
+	zassert_equal(trace[0], 'a');
+	zassert_true(strchr(trace, 'e') > strrchr(trace, 'b'));
+	zassert_true(strchr(trace, 'e') > strrchr(trace, 'c'));
+	zassert_not_null(strchr(trace, 'f'));
+}
+
+ZTEST(slab_static_graph_suite, test_stop_drops_held_events)
+{
+	struct slab_event_pool_stats stats;
+
+	zassert_equal(slab_graph_start(&static_graph), 0);
+
+	/* The delay holds on to the first tick until the graph is stopped. */
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_TICK, 1));
+	zassert_is_null(strchr(trace, 'f'));
+
+	slab_graph_stop(&static_graph);
+
+	slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats);
+	zassert_equal(stats.num_used, 0);
+}
+
+ZTEST(slab_static_graph_suite, test_stop_disconnects_slabs)
+{
+	zassert_equal(slab_graph_start(&static_graph), 0);
+	slab_graph_stop(&static_graph);
+
+	zassert_is_null(sa.step);
+	zassert_is_null(sa.childs.list);
+	zassert_equal(sa.childs.num, 0);
+	zassert_is_null(static_graph.graph.steps);
+
+	/* Stopped slabs no longer forward events. */
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 1);
+
+	/* A stopped graph can be started again. */
+	zassert_equal(slab_graph_start(&static_graph), 0);
+}
+
+ZTEST(slab_static_graph_suite, test_start_rejects_bound_slab)
+{
+	zassert_equal(slab_graph_start(&static_graph), 0);
+	zassert_equal(slab_graph_start(&static_graph), -EBUSY);
+	zassert_equal(slab_graph_start(&overlapping_graph), -EBUSY);
+	zassert_equal(slab_graph_start(NULL), -EINVAL);
+}
+
+ZTEST(slab_static_graph_suite, test_start_rejects_cycle)
+{
+	zassert_equal(slab_graph_start(&loop_graph), -ELOOP);
+
+	zassert_is_null(sx.step);
+	zassert_is_null(sx.childs.list);
+	zassert_is_null(loop_graph.graph.steps);
+}
+
+ZTEST(slab_static_graph_suite, test_start_rejects_split_graph)
+{
+	zassert_equal(slab_graph_start(&split_graph), -EINVAL);
+
+	zassert_is_null(sa.step);
+	zassert_is_null(sx.childs.list);
+	zassert_is_null(split_graph.graph.steps);
+
+	/* The slabs are left free for other graphs */
+	zassert_equal(slab_graph_start(&static_graph), 0);
+}
+
+ZTEST(slab_static_graph_suite, test_pause_drops_held_events)
+{
+	struct slab_event_pool_stats stats;
+
+	zassert_equal(slab_graph_start(&static_graph), 0);
+
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_TICK, 1));
+	zassert_equal(slab_graph_pause(&static_graph), 0);
+
+	slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats);
+	zassert_equal(stats.num_used, 0);
+
+	/* Connections and schedule are kept while paused. */
+	zassert_equal(sa.childs.num, 3);
+	zassert_not_null(sa.step);
+	zassert_equal(slab_graph_pause(&static_graph), -EALREADY);
+}
+
+ZTEST(slab_static_graph_suite, test_resume_restarts_paused_graph)
+{
+	zassert_equal(slab_graph_resume(&static_graph), -EINVAL);
+	zassert_equal(slab_graph_start(&static_graph), 0);
+	zassert_equal(slab_graph_resume(&static_graph), -EALREADY);
+
+	zassert_equal(slab_graph_pause(&static_graph), 0);
+	zassert_equal(slab_graph_resume(&static_graph), 0);
+
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 8);
+
+	/* A paused graph can also be stopped directly. */
+	zassert_equal(slab_graph_pause(&static_graph), 0);
+	slab_graph_stop(&static_graph);
+	zassert_is_null(sa.step);
+	zassert_equal(slab_graph_start(&static_graph), 0);
+}
+
+ZTEST(slab_static_graph_suite, test_static_edge_mask)
+{
+	zassert_equal(slab_graph_start(&masked_graph), 0);
+	zassert_equal(masked_graph.graph.num_edges, 2);
+
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 2);
+	zassert_equal(trace[1], 'b');
+
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_TICK, 0));
+	zassert_equal(trace_len, 4);
+	zassert_equal(trace[3], 'c');
+
+	slab_stim(SLAB_OF(sa), slab_event_create(SLAB_EVENT_HSV_FRAME, NULL, 0));
+	zassert_equal(trace_len, 5);
+}
@@ -0,0 +1,285 @@
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_graph.h"
+#include "slabs/slab_mixer.h"
+#include "slabs/slab_notifier.h"
+#include "../lib/slab/events/slab_event_rgb.h"
+#include "../lib/slab/events/slab_event_tick.h"
+
+#define SLAB_TYPE_TICK_SOURCE SLAB_TYPE_CUSTOM
+
+/* Value of the last RGB event sent by the mixer */
+static struct rgb_value received;
+static int num_received;
+
+static struct slab *output;
+
+static void output_callback(struct slab_event *evt, void *ctx)
+{
+	if (evt->id == SLAB_EVENT_RGB) {
+		received = slab_event_rgb_get_val(evt);
+		num_received += 1;
+	}
+}
+
+static struct rgb_value rgb(uint8_t r, uint8_t g, uint8_t b)
+{
+	struct rgb_value val = {.r = r, .g = g, .b = b};
+
+	return val;
+}
+
+static void set_port(struct slab *mixer, uint16_t idx, struct rgb_value val)
+{
+	slab_stim(slab_mixer_port(mixer, idx), slab_event_create(SLAB_EVENT_RGB, val));
+}
+
+static void tick(struct slab *mixer)
+{
+	slab_stim(mixer, slab_event_create(SLAB_EVENT_TICK, 0));
+}
+
+static struct slab *create_mixer(enum slab_mixer_mode mode, uint32_t num_ports)
+{
+	struct slab *mixer = slab_create(SLAB_TYPE_MIXER, mode, num_ports);
+
+	zassert_not_null(mixer);
+	slab_connect(output, mixer);
+
+	return mixer;
+}
+
+static void assert_received(uint8_t r, uint8_t g, uint8_t b)
+{
+	zassert_equal(received.r, r, "r %d", received.r);
+	zassert_equal(received.g, g, "g %d", received.g);
+	zassert_equal(received.b, b, "b %d", received.b);
+}
+
+static void slab_mixer_suite_before(void *fixture)
+{
+	num_received = 0;
+	output = slab_create(SLAB_TYPE_NOTIFIER, output_callback, NULL);
+	zassert_not_null(output);
+}
+
+static void slab_mixer_suite_after(void *fixture)
+{
+	struct slab_event_pool_stats stats;
+
+	slab_destroy(output);
+
+	slab_event_pool_stats_get(SLAB_EVENT_RGB, &stats);
+	zassert_equal(stats.num_used, 0);
+	slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats);
+	zassert_equal(stats.num_used, 0);
+}
+
+ZTEST_SUITE(slab_mixer_suite, NULL, NULL, slab_mixer_suite_before, slab_mixer_suite_after, NULL);
+
+ZTEST(slab_mixer_suite, test_one_output_per_tick)
+{
+	struct slab *mixer = create_mixer(SLAB_MIXER_ADD, 2);
+
+	/* Nothing to mix yet. */
+	tick(mixer);
+	zassert_equal(num_received, 0);
+
+	/* Values only are buffered, the tick sends the sum. */
+	set_port(mixer, 0, rgb(10, 20, 30));
+	set_port(mixer, 1, rgb(1, 2, 3));
+	set_port(mixer, 1, rgb(5, 5, 5));
+	zassert_equal(num_received, 0);
+	tick(mixer);
+	zassert_equal(num_received, 1);
+	assert_received(15, 25, 35);
+
+	/* A reset clears the ports. */
+	slab_stim(mixer, slab_event_create(SLAB_EVENT_RESET));
+	tick(mixer);
+	zassert_equal(num_received, 1);
+
+	zassert_is_null(slab_mixer_port(mixer, 2));
+	zassert_is_null(slab_create(SLAB_TYPE_MIXER_PORT));
+
+	slab_destroy(mixer);
+}
+
+ZTEST(slab_mixer_suite, test_modes_saturate)
+{
+	struct slab *mixer = create_mixer(SLAB_MIXER_ADD, 3);
+
+	set_port(mixer, 0, rgb(200, 100, 0));
+	set_port(mixer, 1, rgb(100, 100, 0));
+	set_port(mixer, 2, rgb(0, 100, 255));
+	tick(mixer);
+	assert_received(255, 255, 255);
+	slab_destroy(mixer);
+
+	mixer = create_mixer(SLAB_MIXER_MULTIPLY, 2);
+	set_port(mixer, 0, rgb(255, 128, 100));
+	set_port(mixer, 1, rgb(255, 128, 0));
+	tick(mixer);
+	assert_received(255, 64, 0);
+	slab_destroy(mixer);
+
+	mixer = create_mixer(SLAB_MIXER_MAX, 2);
+	set_port(mixer, 0, rgb(10, 200, 30));
+	set_port(mixer, 1, rgb(40, 50, 60));
+	tick(mixer);
+	assert_received(40, 200, 60);
+	slab_destroy(mixer);
+}
+
+ZTEST(slab_mixer_suite, test_crossfade)
+{
+	struct slab *mixer = create_mixer(SLAB_MIXER_CROSSFADE, 2);
+
+	set_port(mixer, 0, rgb(200, 0, 100));
+	set_port(mixer, 1, rgb(0, 200, 100));
+
+	/* Port 1 covers port 0 by its alpha. */
+	tick(mixer);
+	assert_received(0, 200, 100);
+
+	slab_mixer_alpha_set(mixer, 1, 0);
+	tick(mixer);
+	assert_received(200, 0, 100);
+
+	slab_mixer_alpha_set(mixer, 1, 64);
+	tick(mixer);
+	assert_received(150, 50, 100);
+
+	/* The first port covers black. */
+	slab_mixer_alpha_set(mixer, 0, 128);
+	slab_stim(slab_mixer_port(mixer, 1), slab_event_create(SLAB_EVENT_RESET));
+	tick(mixer);
+	assert_received(100, 0, 50);
+
+	slab_destroy(mixer);
+}
+
+ZTEST(slab_mixer_suite, test_hsv_input)
+{
+	struct slab *mixer = create_mixer(SLAB_MIXER_MAX, 1);
+	struct hsv_value red = {.h = COLOR_NUM(0), .s = COLOR_NUM_ONE, .v = COLOR_NUM_ONE};
+
+	slab_stim(slab_mixer_port(mixer, 0), slab_event_create(SLAB_EVENT_HSV, red));
+	tick(mixer);
+	assert_received(255, 0, 0);
+
+	slab_destroy(mixer);
+}
+
+SLAB_MIXER_DEFINE(static_mixer, SLAB_MIXER_ADD, 2);
+
+ZTEST(slab_mixer_suite, test_static_mixer)
+{
+	slab_connect(output, SLAB_OF(static_mixer));
+
+	set_port(SLAB_OF(static_mixer), 0, rgb(1, 2, 3));
+	slab_stim(SLAB_OF(static_mixer_ports[1]), slab_event_create(SLAB_EVENT_RGB, rgb(3, 2, 1)));
+	tick(SLAB_OF(static_mixer));
+	assert_received(4, 4, 4);
+
+	slab_disconnect(output, SLAB_OF(static_mixer));
+}
+
+/*=============================[Compiled graphs]==============================*/
+/* Sends a gray of the tick time on every tick */
+static struct slab tick_sources[1];
+
+static struct slab *tick_source_create(va_list *args)
+{
+	ARG_UNUSED(args);
+
+	return &tick_sources[0];
+}
+
+static void tick_source_destroy(struct slab *slab)
+{
+	ARG_UNUSED(slab);
+}
+
+static void tick_source_stim(struct slab *slab, struct slab_event *evt)
+{
+	uint8_t level;
+
+	if (evt->id != SLAB_EVENT_TICK) {
+		slab_stim_childs(slab, evt);
+		return;
+	}
+
+	level = slab_event_tick_get_time(evt);
+	slab_event_release(evt);
+
+	struct slab_event *rgb_evt = slab_event_create(SLAB_EVENT_RGB, rgb(level, level, level));
+	slab_event_acquire(rgb_evt);
+
+	slab_stim_childs(slab, rgb_evt);
+}
+
+SLAB_TYPE_DEFINE(slab_type_tick_source, SLAB_TYPE_TICK_SOURCE, tick_source_create,
+		 tick_source_destroy, tick_source_stim, NULL, NULL);
+
+static void tick_at(struct slab *root, uint32_t time)
+{
+	slab_stim(root, slab_event_create(SLAB_EVENT_TICK, time));
+}
+
+ZTEST(slab_mixer_suite, test_compiled_graph_runs_ports_first)
+{
+	struct slab_graph graph = {0};
+	struct slab *root = slab_create(SLAB_TYPE_NOTIFIER, NULL, NULL);
+	struct slab *source = slab_create(SLAB_TYPE_TICK_SOURCE);
+	struct slab *mixer = create_mixer(SLAB_MIXER_ADD, 1);
+
+	/* The mixer is the first child of the root, so only the edge from its
+	 * port keeps it from running before the source.
+	 */
+	slab_connect(mixer, root);
+	slab_connect(source, root);
+	slab_connect(slab_mixer_port(mixer, 0), source);
+	zassert_equal(slab_graph_compile(&graph, root), 0);
+
+	tick_at(root, 1);
+	zassert_equal(num_received, 1);
+	assert_received(1, 1, 1);
+
+	tick_at(root, 2);
+	assert_received(2, 2, 2);
+
+	slab_graph_release(&graph);
+	slab_disconnect(slab_mixer_port(mixer, 0), source);
+	slab_destroy(mixer);
+	slab_destroy(source);
+	slab_destroy(root);
+}
+
+SLAB_NOTIFIER_DEFINE(sroot, NULL, NULL);
+SLAB_NOTIFIER_DEFINE(soutput, output_callback, NULL);
+SLAB_MIXER_DEFINE(smix, SLAB_MIXER_ADD, 1);
+
+static struct slab ssource = {
+	SLAB_STATIC_INITIALIZER(SLAB_TYPE_TICK_SOURCE, slab_type_tick_source)
+};
+
+SLAB_GRAPH_DEFINE(mixer_graph,
+	SLAB_EDGE(sroot, smix),
+	SLAB_EDGE(sroot, ssource),
+	SLAB_MIXER_PORT_EDGE(ssource, smix, 0),
+	SLAB_EDGE(smix, soutput));
+
+ZTEST(slab_mixer_suite, test_static_graph_runs_ports_first)
+{
+	zassert_equal(slab_graph_start(&mixer_graph), 0);
+	zassert_true(smix_ports[0].step < smix.step);
+
+	tick_at(SLAB_OF(sroot), 3);
+	zassert_equal(num_received, 1);
+	assert_received(3, 3, 3);
+
+	slab_graph_stop(&mixer_graph);
+}
@@ -0,0 +1,234 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_queue.h"
+#include "slabs/slab_notifier.h"
+#include "../lib/slab/events/slab_event_tick.h"
+
+#define SLAB_TYPE_TWICE SLAB_TYPE_CUSTOM
+
+#define NUM_NODES  6
+#define CHAIN_LEN  64
+
+static const char names[NUM_NODES] = {'a', 'b', 'c', 'd', 'e', 'f'};
+static struct slab *nodes[NUM_NODES];
+
+static char trace[64];
+static int trace_len;
+
+static void trace_callback(struct slab_event *evt, void *ctx)
+{
+	if (trace_len < sizeof(trace) - 1) {
+		trace[trace_len++] = *(const char *)ctx;
+	}
+}
+
+static int num_calls;
+
+static void count_callback(struct slab_event *evt, void *ctx)
+{
+	num_calls += 1;
+}
+
+static void slab_queue_suite_before(void *fixture)
+{
+	memset(trace, 0, sizeof(trace));
+	trace_len = 0;
+	num_calls = 0;
+	slab_queue_stats_reset();
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		nodes[i] = slab_create(SLAB_TYPE_NOTIFIER, trace_callback, (void *)&names[i]);
+		zassert_not_null(nodes[i]);
+	}
+
+	/* a -> b -> d -> e
+	 * a -> c -> d
+	 * a -> f
+	 */
+	slab_connect(nodes[1], nodes[0]);
+	slab_connect(nodes[2], nodes[0]);
+	slab_connect(nodes[3], nodes[1]);
+	slab_connect(nodes[3], nodes[2]);
+	slab_connect(nodes[4], nodes[3]);
+	slab_connect(nodes[5], nodes[0]);
+}
+
+static void slab_queue_suite_after(void *fixture)
+{
+	struct slab_event_pool_stats stats;
+
+	for (int i = 0; i < NUM_NODES; i++) {
+		slab_destroy(nodes[i]);
+	}
+
+	slab_event_pool_stats_get(SLAB_EVENT_RESET, &stats);
+	zassert_equal(stats.num_used, 0);
+}
+
+ZTEST_SUITE(slab_queue_suite, NULL, NULL, slab_queue_suite_before, slab_queue_suite_after, NULL);
+
+ZTEST(slab_queue_suite, test_order)
+{
+	struct slab_queue_stats stats;
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+
+#ifdef CONFIG_SLAB_DISPATCH_BREADTH_FIRST
+	zassert_str_equal(trace, "abcfddee");
+#else
+	/* Same order as recursive dispatch */
+	zassert_str_equal(trace, "abdecdef");
+#endif
+
+	slab_queue_stats_get(&stats);
+	zassert_equal(stats.num_dispatched, 8);
+	zassert_equal(stats.num_dropped, 0);
+}
+
+ZTEST(slab_queue_suite, test_stim_childs_from_outside)
+{
+	struct slab_event *evt = slab_event_create(SLAB_EVENT_RESET);
+
+	/* Like a ticker sending from its own context */
+	slab_event_acquire(evt);
+	slab_stim_childs(nodes[0], evt);
+
+#ifdef CONFIG_SLAB_DISPATCH_BREADTH_FIRST
+	zassert_str_equal(trace, "bcfddee");
+#else
+	zassert_str_equal(trace, "bdecdef");
+#endif
+}
+
+ZTEST(slab_queue_suite, test_deep_chain_uses_constant_list)
+{
+	struct slab *chain[CHAIN_LEN];
+	struct slab_queue_stats stats;
+
+	for (int i = 0; i < CHAIN_LEN; i++) {
+		chain[i] = slab_create(SLAB_TYPE_NOTIFIER, count_callback, NULL);
+		zassert_not_null(chain[i]);
+		if (i > 0) {
+			slab_connect(chain[i], chain[i - 1]);
+		}
+	}
+
+	slab_stim(chain[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(num_calls, CHAIN_LEN);
+
+	slab_queue_stats_get(&stats);
+	zassert_equal(stats.num_dispatched, CHAIN_LEN);
+	zassert_equal(stats.max_queued, 1);
+
+	for (int i = 0; i < CHAIN_LEN; i++) {
+		slab_destroy(chain[i]);
+	}
+}
+
+ZTEST(slab_queue_suite, test_full_list_drops_events)
+{
+	const int num_childs = CONFIG_SLAB_DISPATCH_QUEUE_SIZE + 3;
+	struct slab *childs[num_childs];
+	struct slab_queue_stats stats;
+
+	for (int i = 0; i < num_childs; i++) {
+		childs[i] = slab_create(SLAB_TYPE_NOTIFIER, count_callback, NULL);
+		zassert_not_null(childs[i]);
+		slab_connect(childs[i], nodes[5]);
+	}
+
+	slab_stim(nodes[5], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(num_calls, CONFIG_SLAB_DISPATCH_QUEUE_SIZE);
+
+	slab_queue_stats_get(&stats);
+	zassert_equal(stats.num_dropped, 3);
+	zassert_equal(stats.max_queued, CONFIG_SLAB_DISPATCH_QUEUE_SIZE);
+
+	for (int i = 0; i < num_childs; i++) {
+		slab_disconnect(childs[i], nodes[5]);
+		slab_destroy(childs[i]);
+	}
+}
+
+ZTEST(slab_queue_suite, test_masks_apply)
+{
+	slab_connect_mask(nodes[5], nodes[0], SLAB_EVENT_MASK(SLAB_EVENT_TICK));
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(trace_len, 7);
+	zassert_is_null(strchr(trace, 'f'));
+}
+
+/* Sends a tick of time 1 and then one of time 2 for every event */
+static struct slab twice_slabs[1];
+
+static struct slab *twice_create(va_list *args)
+{
+	ARG_UNUSED(args);
+
+	return &twice_slabs[0];
+}
+
+static void twice_destroy(struct slab *slab)
+{
+	ARG_UNUSED(slab);
+}
+
+static void twice_stim(struct slab *slab, struct slab_event *evt)
+{
+	struct slab_event *tick_evt;
+
+	slab_event_release(evt);
+
+	for (uint32_t time = 1; time <= 2; time++) {
+		tick_evt = slab_event_create(SLAB_EVENT_TICK, time);
+		slab_event_acquire(tick_evt);
+		slab_stim_childs(slab, tick_evt);
+	}
+}
+
+SLAB_TYPE_DEFINE(slab_type_twice, SLAB_TYPE_TWICE, twice_create, twice_destroy, twice_stim, NULL,
+		 NULL);
+
+static void trace_time_callback(struct slab_event *evt, void *ctx)
+{
+	if (trace_len < sizeof(trace) - 2) {
+		trace[trace_len++] = *(const char *)ctx;
+		trace[trace_len++] = '0' + slab_event_tick_get_time(evt);
+	}
+}
+
+ZTEST(slab_queue_suite, test_order_of_several_events_sent)
+{
+	static const char x = 'x';
+	static const char y = 'y';
+	static const char z = 'z';
+	struct slab *twice = slab_create(SLAB_TYPE_TWICE);
+	struct slab *sx = slab_create(SLAB_TYPE_NOTIFIER, trace_time_callback, (void *)&x);
+	struct slab *sy = slab_create(SLAB_TYPE_NOTIFIER, trace_time_callback, (void *)&y);
+	struct slab *sz = slab_create(SLAB_TYPE_NOTIFIER, trace_time_callback, (void *)&z);
+
+	/* twice -> x -> y
+	 * twice -> z
+	 */
+	slab_connect(sx, twice);
+	slab_connect(sz, twice);
+	slab_connect(sy, sx);
+
+	slab_stim(twice, slab_event_create(SLAB_EVENT_RESET));
+
+#ifdef CONFIG_SLAB_DISPATCH_BREADTH_FIRST
+	zassert_str_equal(trace, "x1z1x2z2y1y2");
+#else
+	/* Same order as recursive dispatch */
+	zassert_str_equal(trace, "x1y1z1x2y2z2");
+#endif
+
+	slab_destroy(sy);
+	slab_destroy(sz);
+	slab_destroy(sx);
+	slab_destroy(twice);
+}
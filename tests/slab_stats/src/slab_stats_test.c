@@ -0,0 +1,161 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_stats.h"
+#include "rgb_hsv.h"
+#include "slabs/slab_led.h"
+#include "slabs/slab_mixer.h"
+#include "slabs/slab_notifier.h"
+
+#define NUM_NODES 3
+
+static struct slab *nodes[NUM_NODES];
+
+static void slab_stats_suite_before(void *fixture)
+{
+	/* a -> b -> c */
+	for (int i = 0; i < NUM_NODES; i++) {
+		nodes[i] = slab_create(SLAB_TYPE_NOTIFIER, NULL, NULL);
+		zassert_not_null(nodes[i]);
+	}
+
+	slab_connect(nodes[1], nodes[0]);
+	slab_connect(nodes[2], nodes[1]);
+
+	slab_stats_reset();
+}
+
+static void slab_stats_suite_after(void *fixture)
+{
+	for (int i = 0; i < NUM_NODES; i++) {
+		slab_destroy(nodes[i]);
+		nodes[i] = NULL;
+	}
+}
+
+ZTEST_SUITE(slab_stats_suite, NULL, NULL, slab_stats_suite_before, slab_stats_suite_after, NULL);
+
+ZTEST(slab_stats_suite, test_counts_stims_and_emitted_events)
+{
+	struct slab_stats_snapshot snapshot;
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	slab_stim(nodes[1], slab_event_create(SLAB_EVENT_RESET));
+
+	slab_stats_get(nodes[0], &snapshot);
+	zassert_equal(snapshot.slab, nodes[0]);
+	zassert_equal(snapshot.type, SLAB_TYPE_NOTIFIER);
+	zassert_equal(snapshot.num_stims, 1);
+	zassert_equal(snapshot.num_emitted, 1);
+
+	slab_stats_get(nodes[1], &snapshot);
+	zassert_equal(snapshot.num_stims, 2);
+	zassert_equal(snapshot.num_emitted, 2);
+
+	slab_stats_get(nodes[2], &snapshot);
+	zassert_equal(snapshot.num_stims, 2);
+}
+
+static void save_thread_state(struct slab_event *evt, void *ctx)
+{
+	*(void **)ctx = k_thread_custom_data_get();
+}
+
+ZTEST(slab_stats_suite, test_child_cycles_are_kept_per_thread)
+{
+	struct slab *saver;
+	void *state = NULL;
+
+	saver = slab_create(SLAB_TYPE_NOTIFIER, save_thread_state, &state);
+	slab_connect(saver, nodes[2]);
+
+	/* The counters of nested dispatches live with the thread while it
+	 * dispatches, and are dropped by the outermost dispatch.
+	 */
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	zassert_not_null(state);
+	zassert_is_null(k_thread_custom_data_get());
+
+	slab_destroy(saver);
+}
+
+ZTEST(slab_stats_suite, test_snapshot_lists_slabs_until_destroyed)
+{
+	struct slab_stats_snapshot snapshots[NUM_NODES];
+
+	zassert_equal(slab_stats_snapshot(snapshots, NUM_NODES), 0);
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+
+	zassert_equal(slab_stats_snapshot(snapshots, NUM_NODES), NUM_NODES);
+	zassert_equal(snapshots[0].slab, nodes[0]);
+	zassert_equal(snapshots[1].slab, nodes[1]);
+	zassert_equal(snapshots[2].slab, nodes[2]);
+
+	/* The count is returned even if the snapshots do not fit. */
+	zassert_equal(slab_stats_snapshot(snapshots, 1), NUM_NODES);
+
+	slab_destroy(nodes[1]);
+	nodes[1] = NULL;
+
+	zassert_equal(slab_stats_snapshot(snapshots, NUM_NODES), NUM_NODES - 1);
+	zassert_equal(snapshots[1].slab, nodes[2]);
+}
+
+ZTEST(slab_stats_suite, test_mixer_ports_are_unlisted_with_their_mixer)
+{
+	struct slab_stats_snapshot snapshots[2];
+	struct rgb_value val = {.r = 1, .g = 2, .b = 3};
+	struct slab *mixer = slab_create(SLAB_TYPE_MIXER, SLAB_MIXER_ADD, 2);
+
+	zassert_not_null(mixer);
+	slab_stim(slab_mixer_port(mixer, 0), slab_event_create(SLAB_EVENT_RGB, val));
+	slab_stim(mixer, slab_event_create(SLAB_EVENT_TICK, 0));
+	zassert_equal(slab_stats_snapshot(snapshots, 2), 2);
+
+	slab_destroy(mixer);
+
+	zassert_equal(slab_stats_snapshot(snapshots, 2), 0);
+}
+
+ZTEST(slab_stats_suite, test_reset_clears_counters)
+{
+	struct slab_stats_snapshot snapshot;
+
+	slab_stim(nodes[0], slab_event_create(SLAB_EVENT_RESET));
+	slab_stats_reset();
+
+	slab_stats_get(nodes[0], &snapshot);
+	zassert_equal(snapshot.num_stims, 0);
+	zassert_equal(snapshot.num_emitted, 0);
+	zassert_equal(snapshot.cycles, 0);
+}
+
+ZTEST(slab_stats_suite, test_latency_counts_ticks_with_led_writes)
+{
+	struct slab_latency_stats latency;
+	struct rgb_value val = {.r = 1, .g = 2, .b = 3};
+	uint8_t leds[3];
+	struct slab *led = slab_create(SLAB_TYPE_LED, leds, LED_TYPE_RGB);
+	uint32_t num_counted = 0;
+
+	/* A tick without LED writes is not counted. */
+	slab_stats_tick_begin();
+	slab_stats_tick_end();
+
+	slab_stats_tick_begin();
+	slab_stim(led, slab_event_create(SLAB_EVENT_RGB, val));
+	slab_stats_tick_end();
+
+	slab_stats_latency_get(&latency);
+	zassert_equal(latency.num_ticks, 1);
+
+	for (int i = 0; i < CONFIG_SLAB_STATS_LATENCY_BUCKETS; i++) {
+		num_counted += latency.buckets[i];
+	}
+	zassert_equal(num_counted, 1);
+
+	slab_destroy(led);
+}
@@ -0,0 +1,203 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_graph.h"
+#include "slabs/slab_delay.h"
+#include "slabs/slab_notifier.h"
+#include "../lib/slab/events/slab_event_tick.h"
+
+#define NUM_OUTPUTS 4
+#define NO_TIME     UINT32_MAX
+
+/* Time of the last tick received by each output */
+static uint32_t received[NUM_OUTPUTS];
+static int num_received[NUM_OUTPUTS];
+
+static const int output_ids[NUM_OUTPUTS] = {0, 1, 2, 3};
+static struct slab *outputs[NUM_OUTPUTS];
+
+static void output_callback(struct slab_event *evt, void *ctx)
+{
+	int id = *(const int *)ctx;
+
+	num_received[id] += 1;
+	if (evt->id == SLAB_EVENT_TICK) {
+		received[id] = slab_event_tick_get_time(evt);
+	}
+}
+
+static void clear_received(void)
+{
+	for (int i = 0; i < NUM_OUTPUTS; i++) {
+		received[i] = NO_TIME;
+	}
+}
+
+static void tick(struct slab *slab, uint32_t time)
+{
+	clear_received();
+	slab_stim(slab, slab_event_create(SLAB_EVENT_TICK, time));
+}
+
+static void slab_tapped_delay_suite_before(void *fixture)
+{
+	clear_received();
+	memset(num_received, 0, sizeof(num_received));
+
+	for (int i = 0; i < NUM_OUTPUTS; i++) {
+		outputs[i] = slab_create(SLAB_TYPE_NOTIFIER, output_callback, (void *)&output_ids[i]);
+		zassert_not_null(outputs[i]);
+	}
+}
+
+static void slab_tapped_delay_suite_after(void *fixture)
+{
+	struct slab_event_pool_stats stats;
+
+	for (int i = 0; i < NUM_OUTPUTS; i++) {
+		slab_destroy(outputs[i]);
+	}
+
+	/* The delay keeps values, not events. */
+	slab_event_pool_stats_get(SLAB_EVENT_TICK, &stats);
+	zassert_equal(stats.num_used, 0);
+}
+
+ZTEST_SUITE(slab_tapped_delay_suite, NULL, NULL, slab_tapped_delay_suite_before,
+	    slab_tapped_delay_suite_after, NULL);
+
+static struct slab_event *acquired_tick(uint32_t time)
+{
+	struct slab_event *evt = slab_event_create(SLAB_EVENT_TICK, time);
+
+	slab_event_acquire(evt);
+
+	return evt;
+}
+
+ZTEST(slab_tapped_delay_suite, test_stim_child_sends_to_one_child)
+{
+	struct slab *parent = slab_create(SLAB_TYPE_NOTIFIER, NULL, NULL);
+
+	slab_connect(outputs[0], parent);
+	slab_connect(outputs[1], parent);
+
+	slab_stim_child(parent, 1, acquired_tick(5));
+	zassert_equal(num_received[0], 0);
+	zassert_equal(num_received[1], 1);
+	zassert_equal(received[1], 5);
+
+	/* Events to missing childs are released. */
+	slab_stim_child(parent, 2, acquired_tick(6));
+	zassert_equal(num_received[0] + num_received[1], 1);
+
+	slab_destroy(parent);
+}
+
+ZTEST(slab_tapped_delay_suite, test_taps_read_one_history)
+{
+	const uint16_t taps[] = {0, 2, 1};
+	struct slab *delay = slab_create(SLAB_TYPE_TAPPED_DELAY, taps, ARRAY_SIZE(taps));
+
+	zassert_not_null(delay);
+	zassert_equal(((struct slab_tapped_delay *)delay)->depth, 3);
+
+	for (int i = 0; i < ARRAY_SIZE(taps); i++) {
+		slab_connect(outputs[i], delay);
+	}
+
+	tick(delay, 10);
+	zassert_equal(received[0], 10);
+	zassert_equal(received[1], NO_TIME);
+	zassert_equal(received[2], NO_TIME);
+
+	tick(delay, 11);
+	zassert_equal(received[0], 11);
+	zassert_equal(received[1], NO_TIME);
+	zassert_equal(received[2], 10);
+
+	for (uint32_t time = 12; time < 20; time++) {
+		tick(delay, time);
+		zassert_equal(received[0], time);
+		zassert_equal(received[1], time - 2);
+		zassert_equal(received[2], time - 1);
+	}
+
+	slab_destroy(delay);
+}
+
+ZTEST(slab_tapped_delay_suite, test_childs_without_tap_receive_nothing)
+{
+	const uint16_t taps[] = {1};
+	struct slab *delay = slab_create(SLAB_TYPE_TAPPED_DELAY, taps, ARRAY_SIZE(taps));
+
+	slab_connect(outputs[0], delay);
+	slab_connect(outputs[1], delay);
+
+	tick(delay, 1);
+	tick(delay, 2);
+	zassert_equal(received[0], 1);
+	zassert_equal(num_received[1], 0);
+
+	/* Other events are forwarded to all childs. */
+	slab_stim(delay, slab_event_create(SLAB_EVENT_RESET));
+	zassert_equal(num_received[1], 1);
+
+	slab_destroy(delay);
+}
+
+ZTEST(slab_tapped_delay_suite, test_reset_clears_history)
+{
+	const uint16_t taps[] = {1};
+	struct slab *delay = slab_create(SLAB_TYPE_TAPPED_DELAY, taps, ARRAY_SIZE(taps));
+
+	slab_connect(outputs[0], delay);
+
+	tick(delay, 1);
+	tick(delay, 2);
+	zassert_equal(received[0], 1);
+
+	slab_stim(delay, slab_event_create(SLAB_EVENT_RESET));
+
+	tick(delay, 3);
+	zassert_equal(received[0], NO_TIME);
+	tick(delay, 4);
+	zassert_equal(received[0], 3);
+
+	slab_destroy(delay);
+}
+
+/* source -> taps -> near
+ *                -> far
+ */
+SLAB_NOTIFIER_DEFINE(source, NULL, NULL);
+SLAB_NOTIFIER_DEFINE(near, output_callback, (void *)&output_ids[0]);
+SLAB_NOTIFIER_DEFINE(far, output_callback, (void *)&output_ids[1]);
+SLAB_TAPPED_DELAY_DEFINE(taps, 3, 1, 3);
+
+SLAB_GRAPH_DEFINE(tapped_graph,
+	SLAB_EDGE(source, taps),
+	SLAB_EDGE(taps, near),
+	SLAB_EDGE(taps, far));
+
+ZTEST(slab_tapped_delay_suite, test_static_taps_follow_edge_order)
+{
+	zassert_equal(slab_graph_start(&tapped_graph), 0);
+
+	for (uint32_t time = 0; time < 8; time++) {
+		tick(SLAB_OF(source), time);
+		zassert_equal(received[0], (time >= 1) ? time - 1 : NO_TIME);
+		zassert_equal(received[1], (time >= 3) ? time - 3 : NO_TIME);
+	}
+
+	/* Stopping the graph clears the history. */
+	slab_graph_stop(&tapped_graph);
+	zassert_equal(slab_graph_start(&tapped_graph), 0);
+
+	tick(SLAB_OF(source), 100);
+	zassert_equal(received[0], NO_TIME);
+
+	slab_graph_stop(&tapped_graph);
+}
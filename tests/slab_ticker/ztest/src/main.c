@@ -3,6 +3,8 @@
 
 #include "slab.h"
 #include "slab_event.h"
+#include "../lib/slab/events/slab_event_tick.h"
+#include "slabs/slab_ticker.h"
 
 /*==============================[slab_ticker test suit]==============================*/
 struct slab_ticker_suit_fixture {
@@ -118,3 +120,140 @@ ZTEST_F(slab_ticker_suit, test_reset_evt)
 	zassert_equal(f->notifications_received, 1, 
 		"Expected one tick event at this point in time");
 }
+
+static uint32_t last_tick_time[2];
+
+static void slab_ticker_time_hook(struct slab_event *evt, void *ctx)
+{
+	uint32_t *time = (uint32_t *)ctx;
+
+	if (evt->id == SLAB_EVENT_TICK) {
+		*time = slab_event_tick_get_time(evt);
+	}
+}
+
+ZTEST_F(slab_ticker_suit, test_tickers_share_clock)
+{
+	struct slab_ticker_suit_fixture *f = this;
+
+	struct slab *st_slow = slab_create(SLAB_TYPE_TICKER, K_MSEC(200));
+	struct slab *sn_fast = slab_create(SLAB_TYPE_NOTIFIER, slab_ticker_time_hook, &last_tick_time[0]);
+	struct slab *sn_slow = slab_create(SLAB_TYPE_NOTIFIER, slab_ticker_time_hook, &last_tick_time[1]);
+
+	zassert_not_null(st_slow, "slab_create failed");
+
+	slab_connect(f->sn, f->st);
+	slab_connect(sn_fast, f->st);
+	slab_connect(sn_slow, st_slow);
+
+	k_sleep(K_MSEC(1050));
+
+	/* Both tickers run from one clock, so their ticks at 1000 ms
+	 * carry the same time and they do not drift apart.
+	 */
+	zassert_equal(f->notifications_received, 10,
+		"Wrong number of tick events received (%d, expected %d)",
+		f->notifications_received, 10);
+	zassert_equal(last_tick_time[0], last_tick_time[1],
+		"Ticks of the same clock period differ in time (%u, %u)",
+		last_tick_time[0], last_tick_time[1]);
+
+	slab_destroy(st_slow);
+	slab_destroy(sn_fast);
+	slab_destroy(sn_slow);
+}
+
+static void slab_ticker_slow_hook(struct slab_event *evt, void *ctx)
+{
+	bool *is_first = (bool *)ctx;
+
+	if (evt->id == SLAB_EVENT_TICK && *is_first) {
+		*is_first = false;
+		k_busy_wait(250 * USEC_PER_MSEC);
+	}
+}
+
+ZTEST_F(slab_ticker_suit, test_overrun_counted)
+{
+	struct slab_ticker_suit_fixture *f = this;
+	struct slab_ticker_stats stats;
+	bool is_first = true;
+
+	struct slab *sn_slow = slab_create(SLAB_TYPE_NOTIFIER, slab_ticker_slow_hook, &is_first);
+
+	slab_ticker_stats_reset();
+
+	slab_connect(f->sn, f->st);
+	slab_connect(sn_slow, f->st);
+
+	/* The first tick takes 250 ms, so the ticks at 200 ms and 300 ms
+	 * come too late and one catch-up tick is sent for them.
+	 */
+	k_sleep(K_MSEC(550));
+
+	slab_ticker_stats_get(&stats);
+
+	zassert_true(stats.num_overruns >= 1, "Overrun not detected");
+	zassert_equal(stats.num_late, 1, "Expected one catch-up tick (%u)", stats.num_late);
+	zassert_equal(stats.num_dropped, 1, "Expected one dropped tick (%u)", stats.num_dropped);
+	zassert_equal(f->notifications_received, 4,
+		"Wrong number of tick events received (%d, expected %d)",
+		f->notifications_received, 4);
+
+	slab_destroy(sn_slow);
+}
+
+ZTEST_F(slab_ticker_suit, test_idle_until)
+{
+	struct slab_ticker_suit_fixture *f = this;
+
+	slab_connect(f->sn, f->st);
+
+	k_sleep(K_MSEC(150));
+
+	slab_ticker_idle_until(f->st, k_uptime_get_32() + 300);
+
+	k_sleep(K_MSEC(250));
+
+	zassert_equal(f->notifications_received, 1,
+		"Expected no tick events while idle (%d)", f->notifications_received);
+
+	k_sleep(K_MSEC(250));
+
+	zassert_equal(f->notifications_received, 3,
+		"Wrong number of tick events received (%d, expected %d)",
+		f->notifications_received, 3);
+
+	/* A stimulus ends an idle time early. */
+	slab_ticker_idle_until(f->st, SLAB_TICKER_IDLE_FOREVER);
+
+	k_sleep(K_MSEC(200));
+
+	zassert_equal(f->notifications_received, 3,
+		"Expected no tick events while idle (%d)", f->notifications_received);
+
+	slab_stim(f->st, slab_event_create(SLAB_EVENT_RESET));
+
+	k_sleep(K_MSEC(150));
+
+	zassert_true(f->reset_evt_received, "No reset event received");
+	zassert_equal(f->notifications_received, 4,
+		"Wrong number of tick events received (%d, expected %d)",
+		f->notifications_received, 4);
+
+	/* So does waking the ticker. */
+	slab_ticker_idle_until(f->st, SLAB_TICKER_IDLE_FOREVER);
+
+	k_sleep(K_MSEC(200));
+
+	zassert_equal(f->notifications_received, 4,
+		"Expected no tick events while idle (%d)", f->notifications_received);
+
+	slab_ticker_wake(f->st);
+
+	k_sleep(K_MSEC(150));
+
+	zassert_equal(f->notifications_received, 5,
+		"Wrong number of tick events received (%d, expected %d)",
+		f->notifications_received, 5);
+}
@@ -0,0 +1,90 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "slab.h"
+#include "slab_event.h"
+#include "slab_trace.h"
+#include "slabs/slab_notifier.h"
+
+static struct slab *parent;
+static struct slab *child;
+static struct slab_trace_record records[CONFIG_SLAB_TRACE_RECORDS + 1];
+
+static void slab_trace_suite_before(void *fixture)
+{
+	/* parent -> child */
+	parent = slab_create(SLAB_TYPE_NOTIFIER, NULL, NULL);
+	child = slab_create(SLAB_TYPE_NOTIFIER, NULL, NULL);
+	slab_connect(child, parent);
+
+	memset(records, 0, sizeof(records));
+	slab_trace_clear();
+	slab_trace_enable(true);
+}
+
+static void slab_trace_suite_after(void *fixture)
+{
+	slab_destroy(child);
+	slab_destroy(parent);
+}
+
+ZTEST_SUITE(slab_trace_suite, NULL, NULL, slab_trace_suite_before, slab_trace_suite_after, NULL);
+
+static void check_record(const struct slab_trace_record *record, enum slab_trace_kind kind,
+			 const struct slab *slab, enum slab_event_id event_id)
+{
+	zassert_equal(record->kind, kind);
+	zassert_equal(record->slab, (uint32_t)(uintptr_t)slab);
+	zassert_equal(record->slab_type, SLAB_TYPE_NOTIFIER);
+	zassert_equal(record->event_id, event_id);
+}
+
+ZTEST(slab_trace_suite, test_records_stims_and_emitted_events)
+{
+	slab_stim(parent, slab_event_create(SLAB_EVENT_RESET));
+
+	zassert_equal(slab_trace_drain(records, ARRAY_SIZE(records)), 4);
+	check_record(&records[0], SLAB_TRACE_STIM, parent, SLAB_EVENT_RESET);
+	check_record(&records[1], SLAB_TRACE_EMIT, parent, SLAB_EVENT_RESET);
+	check_record(&records[2], SLAB_TRACE_STIM, child, SLAB_EVENT_RESET);
+	check_record(&records[3], SLAB_TRACE_EMIT, child, SLAB_EVENT_RESET);
+
+	/* The child holds a second reference while its parent forwards the event. */
+	zassert_equal(records[0].num_refs, 1);
+	zassert_equal(records[2].num_refs, 2);
+
+	zassert_equal(slab_trace_num_lost(), 0);
+	zassert_equal(slab_trace_drain(records, ARRAY_SIZE(records)), 0);
+}
+
+ZTEST(slab_trace_suite, test_full_buffer_keeps_newest_records)
+{
+	slab_stim(parent, slab_event_create(SLAB_EVENT_RESET));
+	slab_stim(child, slab_event_create(SLAB_EVENT_TICK, 7));
+
+	zassert_equal(slab_trace_num_lost(), 2);
+	zassert_equal(slab_trace_drain(records, ARRAY_SIZE(records)), CONFIG_SLAB_TRACE_RECORDS);
+	check_record(&records[0], SLAB_TRACE_STIM, child, SLAB_EVENT_RESET);
+	check_record(&records[1], SLAB_TRACE_EMIT, child, SLAB_EVENT_RESET);
+	check_record(&records[2], SLAB_TRACE_STIM, child, SLAB_EVENT_TICK);
+	check_record(&records[3], SLAB_TRACE_EMIT, child, SLAB_EVENT_TICK);
+}
+
+ZTEST(slab_trace_suite, test_drain_moves_whole_records)
+{
+	slab_stim(parent, slab_event_create(SLAB_EVENT_RESET));
+
+	zassert_equal(slab_trace_drain(records, 1), 1);
+	check_record(&records[0], SLAB_TRACE_STIM, parent, SLAB_EVENT_RESET);
+
+	zassert_equal(slab_trace_drain(records, ARRAY_SIZE(records)), 3);
+	check_record(&records[0], SLAB_TRACE_EMIT, parent, SLAB_EVENT_RESET);
+}
+
+ZTEST(slab_trace_suite, test_disabled_tracer_records_nothing)
+{
+	slab_trace_enable(false);
+	slab_stim(parent, slab_event_create(SLAB_EVENT_RESET));
+
+	zassert_equal(slab_trace_drain(records, ARRAY_SIZE(records)), 0);
+}